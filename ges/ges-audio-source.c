@@ -102,6 +102,9 @@ restriction_caps_cb (GESTrack * track,
 {
   GstCaps *caps;
 
+  if (!self->priv->capsfilter)
+    return;
+
   g_object_get (track, "restriction-caps", &caps, NULL);
 
   GST_DEBUG_OBJECT (self, "Setting capsfilter caps to %" GST_PTR_FORMAT, caps);
@@ -153,10 +156,17 @@ ges_audio_source_create_element (GESTrackElement * trksrc)
       TRUE, NULL);
   topbin = ges_source_create_topbin ("audiosrcbin", sub_element, vbin, NULL);
   volume = gst_bin_get_by_name (GST_BIN (vbin), "v");
+
+  /* The element might be created again if it is created on demand */
+  if (self->priv->capsfilter)
+    gst_object_unref (self->priv->capsfilter);
   self->priv->capsfilter = gst_bin_get_by_name (GST_BIN (vbin),
       "audio-track-caps-filter");
 
-  g_signal_connect (self, "notify::track", (GCallback) _track_changed_cb, NULL);
+  if (!g_signal_handler_find (self, G_SIGNAL_MATCH_FUNC, 0, 0, NULL,
+          _track_changed_cb, NULL))
+    g_signal_connect (self, "notify::track", (GCallback) _track_changed_cb,
+        NULL);
   _track_changed_cb (self, NULL, NULL);
 
   _sync_element_to_layer_property_float (trksrc, volume, GES_META_VOLUME,
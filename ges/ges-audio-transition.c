@@ -234,7 +234,7 @@ ges_audio_transition_create_element (GESTrackElement * track_element)
       ges_timeline_element_get_duration (GES_TIMELINE_ELEMENT (track_element));
   ges_audio_transition_duration_changed (track_element, duration);
 
-  g_signal_connect (track_element, "notify::duration",
+  g_signal_connect (track_element, "internal-notify::duration",
       G_CALLBACK (duration_changed_cb), NULL);
 
   gst_object_add_control_binding (GST_OBJECT (atarget),
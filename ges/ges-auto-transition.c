@@ -35,23 +35,31 @@ static guint auto_transition_signals[LAST_SIGNAL] = { 0 };
 
 G_DEFINE_TYPE (GESAutoTransition, ges_auto_transition, G_TYPE_OBJECT);
 
-static void
-neighbour_changed_cb (GESClip * clip, GParamSpec * arg G_GNUC_UNUSED,
-    GESAutoTransition * self)
+/**
+ * ges_auto_transition_update:
+ * @self: a #GESAutoTransition
+ *
+ * Places the transition where its neighbours overlap, or asks for its
+ * destruction if they do not overlap anymore.
+ */
+void
+ges_auto_transition_update (GESAutoTransition * self)
 {
   gint64 new_duration;
   GESTimelineElement *parent =
-      ges_timeline_element_get_toplevel_parent (GES_TIMELINE_ELEMENT (clip));
+      ges_timeline_element_get_toplevel_parent (GES_TIMELINE_ELEMENT
+      (self->previous_source));
 
   if (parent) {
-    GESTimelineElement *prev_topparent =
-        ges_timeline_element_get_toplevel_parent (GES_TIMELINE_ELEMENT
-        (self->next_source));
     GESTimelineElement *next_topparent =
         ges_timeline_element_get_toplevel_parent (GES_TIMELINE_ELEMENT
-        (self->previous_source));
+        (self->next_source));
 
-    if (parent == prev_topparent && parent == next_topparent) {
+    gst_object_unref (parent);
+    if (next_topparent)
+      gst_object_unref (next_topparent);
+
+    if (parent == next_topparent) {
       GST_DEBUG_OBJECT (self,
           "Moving all inside the same group, nothing to do");
       return;
@@ -85,6 +93,21 @@ neighbour_changed_cb (GESClip * clip, GParamSpec * arg G_GNUC_UNUSED,
   self->positioning = FALSE;
 }
 
+static void
+neighbour_changed_cb (GESClip * clip, GParamSpec * arg G_GNUC_UNUSED,
+    GESAutoTransition * self)
+{
+  GESTimeline *timeline = GES_TIMELINE_ELEMENT_TIMELINE (self->transition_clip);
+
+  /* The neighbours are likely to change again before the batch is over */
+  if (timeline && timeline_is_batching (timeline)) {
+    timeline_queue_auto_transition_update (timeline, self);
+    return;
+  }
+
+  ges_auto_transition_update (self);
+}
+
 static void
 _track_changed_cb (GESTrackElement * track_element,
     GParamSpec * arg G_GNUC_UNUSED, GESAutoTransition * self)
@@ -150,17 +173,17 @@ ges_auto_transition_new (GESTrackElement * transition,
   self->next_clip = GES_CLIP (GES_TIMELINE_ELEMENT_PARENT (next_source));
   self->transition_clip = GES_CLIP (GES_TIMELINE_ELEMENT_PARENT (transition));
 
-  g_signal_connect (previous_source, "notify::start",
+  g_signal_connect (previous_source, "internal-notify::start",
       G_CALLBACK (neighbour_changed_cb), self);
-  g_signal_connect_after (previous_source, "notify::priority",
+  g_signal_connect_after (previous_source, "internal-notify::priority",
       G_CALLBACK (neighbour_changed_cb), self);
-  g_signal_connect (next_source, "notify::start",
+  g_signal_connect (next_source, "internal-notify::start",
       G_CALLBACK (neighbour_changed_cb), self);
-  g_signal_connect (next_source, "notify::priority",
+  g_signal_connect (next_source, "internal-notify::priority",
       G_CALLBACK (neighbour_changed_cb), self);
-  g_signal_connect (previous_source, "notify::duration",
+  g_signal_connect (previous_source, "internal-notify::duration",
       G_CALLBACK (neighbour_changed_cb), self);
-  g_signal_connect (next_source, "notify::duration",
+  g_signal_connect (next_source, "internal-notify::duration",
       G_CALLBACK (neighbour_changed_cb), self);
 
   g_signal_connect (next_source, "notify::track",
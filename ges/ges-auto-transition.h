@@ -74,6 +74,7 @@ G_GNUC_INTERNAL GType ges_auto_transition_get_type (void) G_GNUC_CONST;
 G_GNUC_INTERNAL GESAutoTransition * ges_auto_transition_new (GESTrackElement * transition,
                                              GESTrackElement * previous_source,
                                              GESTrackElement * next_source);
+G_GNUC_INTERNAL void ges_auto_transition_update (GESAutoTransition * self);
 
 G_END_DECLS
 #endif /* _GES_AUTO_TRANSITION_H_ */
@@ -136,6 +136,9 @@ struct _GESBaseXmlFormatterPrivate
   gboolean timeline_auto_transition;
 
   GList *groups;
+
+  /* Timeline batched while loading, weak pointer */
+  GESTimeline *batched_timeline;
 };
 
 static void
@@ -244,6 +247,31 @@ _can_load_uri (GESFormatter * dummy_formatter, const gchar * uri,
   return TRUE;
 }
 
+static void
+_begin_loading_batch (GESBaseXmlFormatter * self, GESTimeline * timeline)
+{
+  GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
+
+  ges_timeline_begin_batch (timeline);
+  priv->batched_timeline = timeline;
+  g_object_add_weak_pointer (G_OBJECT (timeline),
+      (gpointer *) & priv->batched_timeline);
+}
+
+static void
+_end_loading_batch (GESBaseXmlFormatter * self)
+{
+  GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
+
+  if (!priv->batched_timeline)
+    return;
+
+  g_object_remove_weak_pointer (G_OBJECT (priv->batched_timeline),
+      (gpointer *) & priv->batched_timeline);
+  ges_timeline_end_batch (priv->batched_timeline);
+  priv->batched_timeline = NULL;
+}
+
 static gboolean
 _load_from_uri (GESFormatter * self, GESTimeline * timeline, const gchar * uri,
     GError ** error)
@@ -252,11 +280,16 @@ _load_from_uri (GESFormatter * self, GESTimeline * timeline, const gchar * uri,
 
   ges_timeline_set_auto_transition (timeline, FALSE);
 
+  /* Ended once all the clips are loaded, in _loading_done, or when
+   * disposing if the loading never finished */
+  _begin_loading_batch (GES_BASE_XML_FORMATTER (self), timeline);
   priv->parsecontext =
       create_parser_context (GES_BASE_XML_FORMATTER (self), uri, error);
 
-  if (!priv->parsecontext)
+  if (!priv->parsecontext) {
+    _end_loading_batch (GES_BASE_XML_FORMATTER (self));
     return FALSE;
+  }
 
   if (g_hash_table_size (priv->assetid_pendingclips) == 0 &&
       priv->pending_assets == NULL)
@@ -347,6 +380,9 @@ _dispose (GObject * object)
 {
   GESBaseXmlFormatterPrivate *priv = _GET_PRIV (object);
 
+  /* The loading was abandoned, do not leave the timeline batched */
+  _end_loading_batch (GES_BASE_XML_FORMATTER (object));
+
   g_clear_pointer (&priv->assetid_pendingclips,
       (GDestroyNotify) g_hash_table_unref);
   g_clear_pointer (&priv->containers, (GDestroyNotify) g_hash_table_unref);
@@ -473,6 +509,7 @@ _loading_done (GESFormatter * self)
   GESBaseXmlFormatterPrivate *priv = GES_BASE_XML_FORMATTER (self)->priv;
 
   _add_all_groups (self);
+  _end_loading_batch (GES_BASE_XML_FORMATTER (self));
 
   if (priv->parsecontext)
     g_markup_parse_context_free (priv->parsecontext);
@@ -521,7 +558,9 @@ _set_child_property (GQuark field_id, const GValue * value,
     return TRUE;
   }
 
-  g_object_set_property (G_OBJECT (object), pspec->name, value);
+  /* Handles the elements that do not exist yet */
+  GES_TIMELINE_ELEMENT_GET_CLASS (tlelement)->set_child_property (tlelement,
+      object, pspec, (GValue *) value);
   g_param_spec_unref (pspec);
   gst_object_unref (object);
   return TRUE;
@@ -155,7 +155,7 @@ _set_start (GESTimelineElement * element, GstClockTime start)
       GST_PTR_FORMAT ")", container->initiated_move);
 
   element->start = start;
-  g_object_notify (G_OBJECT (element), "start");
+  ges_timeline_element_notify (element, "start");
   container->children_control_mode = GES_CHILDREN_IGNORE_NOTIFIES;
   for (tmp = container->children; tmp; tmp = g_list_next (tmp)) {
     GESTimelineElement *child = (GESTimelineElement *) tmp->data;
@@ -379,7 +379,7 @@ _remove_child (GESContainer * container, GESTimelineElement * element)
 static void
 _child_added (GESContainer * container, GESTimelineElement * element)
 {
-  g_signal_connect (G_OBJECT (element), "notify::priority",
+  g_signal_connect (G_OBJECT (element), "internal-notify::priority",
       G_CALLBACK (_child_priority_changed_cb), container);
 
   _child_priority_changed_cb (element, NULL, container);
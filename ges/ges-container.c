@@ -202,14 +202,14 @@ _set_duration (GESTimelineElement * element, GstClockTime duration)
   return TRUE;
 }
 
-static void
+void
 _ges_container_add_child_properties (GESContainer * container,
     GESTimelineElement * child)
 {
   guint n_props, i;
+  GParamSpec **child_props;
 
-  GParamSpec **child_props =
-      ges_timeline_element_list_children_properties (child,
+  child_props = ges_timeline_element_list_children_properties (child,
       &n_props);
 
   for (i = 0; i < n_props; i++) {
@@ -231,14 +231,14 @@ _ges_container_add_child_properties (GESContainer * container,
   g_free (child_props);
 }
 
-static void
+void
 _ges_container_remove_child_properties (GESContainer * container,
     GESTimelineElement * child)
 {
   guint n_props, i;
+  GParamSpec **child_props;
 
-  GParamSpec **child_props =
-      ges_timeline_element_list_children_properties (child,
+  child_props = ges_timeline_element_list_children_properties (child,
       &n_props);
 
   for (i = 0; i < n_props; i++) {
@@ -537,7 +537,8 @@ _child_start_changed_cb (GESTimelineElement * child,
         GST_DEBUG_OBJECT (container, "Child move made us "
             "move to %" GST_TIME_FORMAT, GST_TIME_ARGS (_START (container)));
 
-        g_object_notify (G_OBJECT (container), "start");
+        ges_timeline_element_notify (GES_TIMELINE_ELEMENT (container),
+            "start");
       }
 
       /* Falltrough! */
@@ -611,7 +612,8 @@ _child_duration_changed_cb (GESTimelineElement * child,
 
       if (end != _END (container)) {
         _DURATION (container) = end - _START (container);
-        g_object_notify (G_OBJECT (container), "duration");
+        ges_timeline_element_notify (GES_TIMELINE_ELEMENT (container),
+            "duration");
       }
       /* Falltrough */
     case GES_CHILDREN_UPDATE_OFFSETS:
@@ -745,13 +747,13 @@ ges_container_add (GESContainer * container, GESTimelineElement * child)
 
   /* Listen to all property changes */
   mapping->start_notifyid =
-      g_signal_connect (G_OBJECT (child), "notify::start",
+      g_signal_connect (G_OBJECT (child), "internal-notify::start",
       G_CALLBACK (_child_start_changed_cb), container);
   mapping->duration_notifyid =
-      g_signal_connect (G_OBJECT (child), "notify::duration",
+      g_signal_connect (G_OBJECT (child), "internal-notify::duration",
       G_CALLBACK (_child_duration_changed_cb), container);
   mapping->inpoint_notifyid =
-      g_signal_connect (G_OBJECT (child), "notify::in-point",
+      g_signal_connect (G_OBJECT (child), "internal-notify::in-point",
       G_CALLBACK (_child_inpoint_changed_cb), container);
 
   if (ges_timeline_element_set_parent (child, GES_TIMELINE_ELEMENT (container))
@@ -772,7 +774,7 @@ ges_container_add (GESContainer * container, GESTimelineElement * child)
   priv->adding_children = g_list_remove (priv->adding_children, child);
 
   if (notify_start)
-    g_object_notify (G_OBJECT (container), "start");
+    ges_timeline_element_notify (GES_TIMELINE_ELEMENT (container), "start");
 
   return TRUE;
 }
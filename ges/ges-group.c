@@ -503,7 +503,7 @@ _child_added (GESContainer * group, GESTimelineElement * child)
 
   } else if (GES_IS_GROUP (child), group) {
     signals_ids->child_group_priority_changed_sid =
-        g_signal_connect (child, "notify::priority",
+        g_signal_connect (child, "internal-notify::priority",
         (GCallback) _child_group_priority_changed, group);
   }
 }
@@ -22,6 +22,7 @@
 #define __GES_INTERNAL_H__
 #include <gst/gst.h>
 #include <gst/pbutils/encoding-profile.h>
+#include <gst/pbutils/gstdiscoverer.h>
 #include <gio/gio.h>
 
 #include "ges-timeline.h"
@@ -30,6 +31,7 @@
 
 #include "ges-asset.h"
 #include "ges-base-xml-formatter.h"
+#include "ges-auto-transition.h"
 
 G_BEGIN_DECLS
 
@@ -102,6 +104,9 @@ timeline_context_to_layer      (GESTimeline *timeline, gint offset);
 G_GNUC_INTERNAL void
 timeline_add_group             (GESTimeline *timeline,
                                 GESGroup *group);
+G_GNUC_INTERNAL GESAsset *
+timeline_get_clip_original_asset (GESTimeline *timeline,
+                                GESClip *clip);
 G_GNUC_INTERNAL void
 timeline_remove_group          (GESTimeline *timeline,
                                 GESGroup *group);
@@ -121,6 +126,20 @@ gboolean
 timeline_remove_element       (GESTimeline *timeline,
                                GESTimelineElement *element);
 
+G_GNUC_INTERNAL
+gboolean
+timeline_is_batching          (GESTimeline *timeline);
+
+G_GNUC_INTERNAL
+void
+timeline_freeze_element_notify (GESTimeline *timeline,
+                                GESTimelineElement *element);
+
+G_GNUC_INTERNAL
+void
+timeline_queue_auto_transition_update (GESTimeline *timeline,
+                                       GESAutoTransition *auto_transition);
+
 G_GNUC_INTERNAL
 void
 timeline_fill_gaps            (GESTimeline *timeline);
@@ -136,6 +155,10 @@ G_GNUC_INTERNAL
 void
 track_disable_last_gap        (GESTrack *track, gboolean disabled);
 
+G_GNUC_INTERNAL gboolean
+track_has_active_element_in_range (GESTrack *track, GstClockTime start,
+                                GstClockTime end, GESTrackElement *ignored);
+
 G_GNUC_INTERNAL void
 ges_asset_cache_init (void);
 
@@ -164,6 +187,13 @@ ges_effect_assect_id_get_type_and_bindesc (const char    *id,
 
 G_GNUC_INTERNAL void _ges_uri_asset_cleanup (void);
 
+G_GNUC_INTERNAL void
+ges_source_update_decodebin_caps (GESSource *self, GstElement *decodebin);
+G_GNUC_INTERNAL void
+ges_source_update_passthrough (GESSource *self);
+G_GNUC_INTERNAL void
+ges_video_source_sync_preview_scale (GESVideoSource *self);
+
 /* GESExtractable internall methods
  *
  * FIXME Check if that should be public later
@@ -318,6 +348,9 @@ G_GNUC_INTERNAL gint element_start_compare                (GESTimelineElement *
                                                            GESTimelineElement * b);
 G_GNUC_INTERNAL gint element_end_compare                  (GESTimelineElement * a,
                                                            GESTimelineElement * b);
+G_GNUC_INTERNAL void _ges_sequence_sort_changed           (GSequenceIter * iter,
+                                                           GCompareDataFunc cmp_func,
+                                                           gpointer cmp_data);
 G_GNUC_INTERNAL GstElementFactory *
 ges_get_compositor_factory                                (void);
 
@@ -339,6 +372,10 @@ G_GNUC_INTERNAL gint  _ges_container_get_priority_offset  (GESContainer * contai
 G_GNUC_INTERNAL void _ges_container_set_priority_offset   (GESContainer * container,
                                                            GESTimelineElement *elem,
                                                            gint32 priority_offset);
+G_GNUC_INTERNAL void _ges_container_add_child_properties  (GESContainer * container,
+                                                           GESTimelineElement *child);
+G_GNUC_INTERNAL void _ges_container_remove_child_properties (GESContainer * container,
+                                                           GESTimelineElement *child);
 
 
 /****************************************************
@@ -363,6 +400,14 @@ G_GNUC_INTERNAL void layer_set_priority               (GESLayer * layer, guint p
 #define         NLE_OBJECT_TRACK_ELEMENT_QUARK                  (g_quark_from_string ("nle_object_track_element_quark"))
 G_GNUC_INTERNAL gboolean  ges_track_element_set_track           (GESTrackElement * object, GESTrack * track);
 G_GNUC_INTERNAL guint32   _ges_track_element_get_layer_priority (GESTrackElement * element);
+G_GNUC_INTERNAL gboolean  ges_track_element_has_element         (GESTrackElement * object);
+G_GNUC_INTERNAL void      ges_track_element_handle_pending_requests (void);
+G_GNUC_INTERNAL gboolean  ges_track_element_set_pending_child_property (GObject * child,
+                                                                       GParamSpec * pspec,
+                                                                       const GValue * value);
+G_GNUC_INTERNAL gboolean  ges_track_element_get_pending_child_property (GObject * child,
+                                                                       GParamSpec * pspec,
+                                                                       GValue * value);
 G_GNUC_INTERNAL void ges_track_element_copy_properties          (GESTimelineElement * element,
                                                                  GESTimelineElement * elementcopy);
 
@@ -374,6 +419,11 @@ G_GNUC_INTERNAL GstElement *ges_source_create_topbin (const gchar * bin_name, Gs
 G_GNUC_INTERNAL void ges_track_set_caps                (GESTrack *track,
                                                         const GstCaps *caps);
 G_GNUC_INTERNAL GstElement * ges_track_get_composition (GESTrack *track);
+G_GNUC_INTERNAL void ges_track_set_preview_scale       (GESTrack *track,
+                                                        gdouble scale);
+G_GNUC_INTERNAL gdouble ges_track_get_preview_scale    (GESTrack *track);
+G_GNUC_INTERNAL gint _ges_scale_video_size             (gint size,
+                                                        gdouble scale);
 
 
 /*********************************************
@@ -391,6 +441,10 @@ G_GNUC_INTERNAL GESVideoTestSource * ges_video_test_source_new (void);
  ****************************************************/
 G_GNUC_INTERNAL gdouble ges_timeline_element_get_media_duration_factor(GESTimelineElement *self);
 G_GNUC_INTERNAL GESTimelineElement * ges_timeline_element_get_copied_from (GESTimelineElement *self);
+G_GNUC_INTERNAL void ges_timeline_element_notify        (GESTimelineElement *self,
+                                                        const gchar *property_name);
+G_GNUC_INTERNAL void ges_timeline_element_freeze_notify (GESTimelineElement *self);
+G_GNUC_INTERNAL void ges_timeline_element_thaw_notify   (GESTimelineElement *self);
 
 /******************************
  *  GESMultiFile internal API *
@@ -417,6 +471,32 @@ G_GNUC_INTERNAL gboolean ges_nle_composition_add_object (GstElement *comp, GstEl
 G_GNUC_INTERNAL gboolean ges_nle_composition_remove_object (GstElement *comp, GstElement *object);
 G_GNUC_INTERNAL gboolean ges_nle_object_commit (GstElement * nlesource, gboolean recurse);
 
+/****************
+ *  Test hooks  *
+ ****************/
+
+/* Internal state inspected by the unit tests. Those are exported so that
+ * the tests can link against them but are not part of the API: this header
+ * is not installed and they can change or go away at any time. Do not add
+ * anything that can be checked through the API instead. */
+
+/* The NleObject-s filling the gaps of @track, owned by its composition */
+GES_API GList * ges_track_get_gap_objects              (GESTrack *track);
+GES_API GstElement * ges_track_get_gap_filler_object   (GESTrack *track);
+
+/* Checks that the sequences indexing the track elements are sorted and up
+ * to date */
+GES_API gboolean ges_timeline_check_indexes            (GESTimeline *timeline);
+
+/* On disk cache of the discovery of local media files, keyed by URI and
+ * invalidated when the file size or modification time changes. Also used
+ * internally by GESUriClipAsset */
+GES_API GstDiscovererInfo * ges_discovery_cache_lookup (const gchar *uri);
+GES_API void ges_discovery_cache_store                 (GstDiscovererInfo *info);
+
+/* The #GstDiscoverer-s of the asynchronous discovery pool, transfer full */
+GES_API GList * ges_discoverer_pool_get_discoverers    (void);
+
 G_END_DECLS
 
 #endif /* __GES_INTERNAL_H__ */
@@ -44,15 +44,42 @@ G_DEFINE_TYPE_WITH_CODE (GESLayer, ges_layer,
     G_IMPLEMENT_INTERFACE (GES_TYPE_META_CONTAINER,
         ges_meta_container_interface_init));
 
+/* Node of the layer interval tree.
+ *
+ * The clips are kept in a treap ordered like element_start_compare(), each
+ * node caching the latest end of its subtree so that the lookups can skip
+ * the subtrees ending before the position they look for */
+typedef struct _ClipEntry ClipEntry;
+struct _ClipEntry
+{
+  /* Keys of the index, updated when the clip changes */
+  GstClockTime start;
+  GstClockTime duration;
+  guint32 priority;
+
+  GESClip *clip;
+
+  /* The latest end of the subtree */
+  GstClockTime max_end;
+  /* Random heap priority keeping the tree balanced */
+  guint32 weight;
+  ClipEntry *left;
+  ClipEntry *right;
+};
+
 struct _GESLayerPrivate
 {
   /*< private > */
-  GList *clips_start;           /* The Clips sorted by start and
-                                 * priority */
+  ClipEntry *clips_tree;        /* Root of the interval tree of the clips */
+  GHashTable *clips;            /* GESClip -> ClipEntry */
 
   guint32 priority;             /* The priority of the layer within the
                                  * containing timeline */
   gboolean auto_transition;
+
+  /* Set while adding clips with ges_layer_add_clips(), the priorities get
+   * resynced once at the end */
+  gboolean adding_clips;
 };
 
 typedef struct
@@ -124,12 +151,206 @@ ges_layer_dispose (GObject * object)
 
   GST_DEBUG ("Disposing layer");
 
-  while (priv->clips_start)
-    ges_layer_remove_clip (layer, (GESClip *) priv->clips_start->data);
+  while (priv->clips_tree)
+    ges_layer_remove_clip (layer, priv->clips_tree->clip);
 
   G_OBJECT_CLASS (ges_layer_parent_class)->dispose (object);
 }
 
+static void
+ges_layer_finalize (GObject * object)
+{
+  GESLayerPrivate *priv = GES_LAYER (object)->priv;
+
+  g_hash_table_unref (priv->clips);
+
+  G_OBJECT_CLASS (ges_layer_parent_class)->finalize (object);
+}
+
+static gint
+compare_entries (ClipEntry * a, ClipEntry * b)
+{
+  if (a->start != b->start)
+    return a->start < b->start ? -1 : 1;
+  if (a->priority != b->priority)
+    return a->priority < b->priority ? -1 : 1;
+  if (a->duration != b->duration)
+    return a->duration < b->duration ? -1 : 1;
+
+  /* Make the keys unique so that an entry can always be found back */
+  if (a->clip != b->clip)
+    return a->clip < b->clip ? -1 : 1;
+  return 0;
+}
+
+static void
+clip_tree_update_max_end (ClipEntry * node)
+{
+  node->max_end = node->start + node->duration;
+  if (node->left)
+    node->max_end = MAX (node->max_end, node->left->max_end);
+  if (node->right)
+    node->max_end = MAX (node->max_end, node->right->max_end);
+}
+
+static ClipEntry *
+clip_tree_rotate_right (ClipEntry * node)
+{
+  ClipEntry *left = node->left;
+
+  node->left = left->right;
+  left->right = node;
+  clip_tree_update_max_end (node);
+  clip_tree_update_max_end (left);
+
+  return left;
+}
+
+static ClipEntry *
+clip_tree_rotate_left (ClipEntry * node)
+{
+  ClipEntry *right = node->right;
+
+  node->right = right->left;
+  right->left = node;
+  clip_tree_update_max_end (node);
+  clip_tree_update_max_end (right);
+
+  return right;
+}
+
+static ClipEntry *
+clip_tree_insert (ClipEntry * node, ClipEntry * entry)
+{
+  if (!node) {
+    entry->left = entry->right = NULL;
+    clip_tree_update_max_end (entry);
+
+    return entry;
+  }
+
+  if (compare_entries (entry, node) < 0) {
+    node->left = clip_tree_insert (node->left, entry);
+    if (node->left->weight > node->weight)
+      return clip_tree_rotate_right (node);
+  } else {
+    node->right = clip_tree_insert (node->right, entry);
+    if (node->right->weight > node->weight)
+      return clip_tree_rotate_left (node);
+  }
+
+  clip_tree_update_max_end (node);
+
+  return node;
+}
+
+/* Joins two trees, all the entries of @left being before the ones of @right */
+static ClipEntry *
+clip_tree_merge (ClipEntry * left, ClipEntry * right)
+{
+  if (!left)
+    return right;
+  if (!right)
+    return left;
+
+  if (left->weight > right->weight) {
+    left->right = clip_tree_merge (left->right, right);
+    clip_tree_update_max_end (left);
+
+    return left;
+  }
+
+  right->left = clip_tree_merge (left, right->left);
+  clip_tree_update_max_end (right);
+
+  return right;
+}
+
+static ClipEntry *
+clip_tree_remove (ClipEntry * node, ClipEntry * entry)
+{
+  gint cmp;
+
+  g_assert (node);
+
+  cmp = compare_entries (entry, node);
+  if (cmp == 0) {
+    node = clip_tree_merge (entry->left, entry->right);
+    entry->left = entry->right = NULL;
+
+    return node;
+  }
+
+  if (cmp < 0)
+    node->left = clip_tree_remove (node->left, entry);
+  else
+    node->right = clip_tree_remove (node->right, entry);
+  clip_tree_update_max_end (node);
+
+  return node;
+}
+
+/* Prepends the clips of the subtree, walking it backward so that the list
+ * ends up sorted */
+static void
+clip_tree_prepend_clips (ClipEntry * node, GList ** clips)
+{
+  for (; node; node = node->left) {
+    clip_tree_prepend_clips (node->right, clips);
+    *clips = g_list_prepend (*clips, gst_object_ref (node->clip));
+  }
+}
+
+/* Prepends the clips of the subtree intersecting [@start, @end), skipping
+ * the subtrees ending before @start and the ones starting after @end, so
+ * only O(log n) nodes are visited besides the matching ones */
+static void
+clip_tree_prepend_clips_in_interval (ClipEntry * node, GstClockTime start,
+    GstClockTime end, GList ** clips)
+{
+  for (; node && node->max_end >= start; node = node->left) {
+    GstClockTime clip_end;
+
+    /* Empty clips at @end are intersecting */
+    if (node->start > end)
+      continue;
+
+    clip_tree_prepend_clips_in_interval (node->right, start, end, clips);
+
+    clip_end = node->start + node->duration;
+    if ((start <= node->start && node->start < end) ||
+        (start < clip_end && clip_end <= end) ||
+        (node->start < start && clip_end > end))
+      *clips = g_list_prepend (*clips, gst_object_ref (node->clip));
+  }
+}
+
+static void
+free_clip_entry (ClipEntry * entry)
+{
+  g_slice_free (ClipEntry, entry);
+}
+
+static void
+clip_times_changed_cb (GESClip * clip, GParamSpec * arg G_GNUC_UNUSED,
+    GESLayer * layer)
+{
+  GESLayerPrivate *priv = layer->priv;
+  ClipEntry *entry = g_hash_table_lookup (priv->clips, clip);
+
+  g_assert (entry);
+
+  if (entry->start == _START (clip) && entry->duration == _DURATION (clip)
+      && entry->priority == _PRIORITY (clip))
+    return;
+
+  priv->clips_tree = clip_tree_remove (priv->clips_tree, entry);
+  entry->start = _START (clip);
+  entry->duration = _DURATION (clip);
+  entry->priority = _PRIORITY (clip);
+  priv->clips_tree = clip_tree_insert (priv->clips_tree, entry);
+}
+
 static gboolean
 _register_metas (GESLayer * layer)
 {
@@ -155,6 +376,7 @@ ges_layer_class_init (GESLayerClass * klass)
   object_class->get_property = ges_layer_get_property;
   object_class->set_property = ges_layer_set_property;
   object_class->dispose = ges_layer_dispose;
+  object_class->finalize = ges_layer_finalize;
 
   /**
    * GESLayer:priority:
@@ -218,6 +440,8 @@ ges_layer_init (GESLayer * self)
 
   self->priv->priority = 0;
   self->priv->auto_transition = FALSE;
+  self->priv->clips = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+      NULL, (GDestroyNotify) free_clip_entry);
   self->min_nle_priority = MIN_NLE_PRIO;
   self->max_nle_priority = LAYER_HEIGHT + MIN_NLE_PRIO;
 
@@ -230,12 +454,13 @@ ges_layer_resync_priorities_by_type (GESLayer * layer,
 {
   GstClockTime next_reset = 0;
   gint priority = starting_priority, max_priority = priority;
-  GList *tmp;
+  GList *clips = NULL, *tmp;
   GESTimelineElement *element;
 
-  for (tmp = layer->priv->clips_start; tmp; tmp = tmp->next) {
-
-    element = GES_TIMELINE_ELEMENT (tmp->data);
+  /* Setting the priorities reorders the index, work on a snapshot */
+  clip_tree_prepend_clips (layer->priv->clips_tree, &clips);
+  for (tmp = clips; tmp; tmp = tmp->next) {
+    element = tmp->data;
 
     if (GES_IS_TRANSITION_CLIP (element)) {
       /* Blindly set transitions priorities to 0 */
@@ -258,6 +483,7 @@ ges_layer_resync_priorities_by_type (GESLayer * layer,
     if (priority > max_priority)
       max_priority = priority;
   }
+  g_list_free_full (clips, gst_object_unref);
 
   return max_priority;
 }
@@ -363,16 +589,12 @@ new_asset_cb (GESAsset * source, GAsyncResult * res, NewAssetUData * udata)
 GstClockTime
 ges_layer_get_duration (GESLayer * layer)
 {
-  GList *tmp;
-  GstClockTime duration = 0;
-
   g_return_val_if_fail (GES_IS_LAYER (layer), 0);
 
-  for (tmp = layer->priv->clips_start; tmp; tmp = tmp->next) {
-    duration = MAX (duration, _END (tmp->data));
-  }
+  if (!layer->priv->clips_tree)
+    return 0;
 
-  return duration;
+  return layer->priv->clips_tree->max_end;
 }
 
 /* Public methods */
@@ -393,6 +615,7 @@ gboolean
 ges_layer_remove_clip (GESLayer * layer, GESClip * clip)
 {
   GESLayer *current_layer;
+  ClipEntry *entry;
 
   g_return_val_if_fail (GES_IS_LAYER (layer), FALSE);
   g_return_val_if_fail (GES_IS_CLIP (clip), FALSE);
@@ -411,7 +634,10 @@ ges_layer_remove_clip (GESLayer * layer, GESClip * clip)
   gst_object_unref (current_layer);
 
   /* Remove it from our list of controlled objects */
-  layer->priv->clips_start = g_list_remove (layer->priv->clips_start, clip);
+  entry = g_hash_table_lookup (layer->priv->clips, clip);
+  layer->priv->clips_tree = clip_tree_remove (layer->priv->clips_tree, entry);
+  g_hash_table_remove (layer->priv->clips, clip);
+  g_signal_handlers_disconnect_by_func (clip, clip_times_changed_cb, layer);
 
   /* emit 'clip-removed' */
   g_signal_emit (layer, ges_layer_signals[OBJECT_REMOVED], 0, clip);
@@ -516,6 +742,7 @@ GList *
 ges_layer_get_clips (GESLayer * layer)
 {
   GESLayerClass *klass;
+  GList *clips = NULL;
 
   g_return_val_if_fail (GES_IS_LAYER (layer), NULL);
 
@@ -525,9 +752,9 @@ ges_layer_get_clips (GESLayer * layer)
     return klass->get_objects (layer);
   }
 
-  return g_list_sort (g_list_copy_deep (layer->priv->clips_start,
-          (GCopyFunc) gst_object_ref, NULL),
-      (GCompareFunc) element_start_compare);
+  clip_tree_prepend_clips (layer->priv->clips_tree, &clips);
+
+  return clips;
 }
 
 /**
@@ -545,7 +772,7 @@ ges_layer_is_empty (GESLayer * layer)
 {
   g_return_val_if_fail (GES_IS_LAYER (layer), FALSE);
 
-  return (layer->priv->clips_start == NULL);
+  return layer->priv->clips_tree == NULL;
 }
 
 /**
@@ -572,6 +799,7 @@ ges_layer_add_clip (GESLayer * layer, GESClip * clip)
   GESAsset *asset;
   GESLayerPrivate *priv;
   GESLayer *current_layer;
+  ClipEntry *entry;
 
   g_return_val_if_fail (GES_IS_LAYER (layer), FALSE);
   g_return_val_if_fail (GES_IS_CLIP (clip), FALSE);
@@ -625,9 +853,21 @@ ges_layer_add_clip (GESLayer * layer, GESClip * clip)
     gst_object_ref_sink (clip);
   }
 
-  /* Take a reference to the clip and store it stored by start/priority */
-  priv->clips_start = g_list_insert_sorted (priv->clips_start, clip,
-      (GCompareFunc) element_start_compare);
+  /* Take a reference to the clip and index it by start and duration */
+  entry = g_slice_new (ClipEntry);
+  entry->clip = clip;
+  entry->start = _START (clip);
+  entry->duration = _DURATION (clip);
+  entry->priority = _PRIORITY (clip);
+  entry->weight = g_random_int ();
+  priv->clips_tree = clip_tree_insert (priv->clips_tree, entry);
+  g_hash_table_insert (priv->clips, clip, entry);
+  g_signal_connect (clip, "internal-notify::start",
+      G_CALLBACK (clip_times_changed_cb), layer);
+  g_signal_connect (clip, "internal-notify::duration",
+      G_CALLBACK (clip_times_changed_cb), layer);
+  g_signal_connect (clip, "internal-notify::priority",
+      G_CALLBACK (clip_times_changed_cb), layer);
 
   /* Inform the clip it's now in this layer */
   ges_clip_set_layer (clip, layer);
@@ -644,7 +884,8 @@ ges_layer_add_clip (GESLayer * layer, GESClip * clip)
     _set_priority0 (GES_TIMELINE_ELEMENT (clip), LAYER_HEIGHT - 1);
   }
 
-  ges_layer_resync_priorities (layer);
+  if (!priv->adding_clips && !timeline_is_batching (layer->timeline))
+    ges_layer_resync_priorities (layer);
 
   ges_timeline_element_set_timeline (GES_TIMELINE_ELEMENT (clip),
       layer->timeline);
@@ -655,6 +896,49 @@ ges_layer_add_clip (GESLayer * layer, GESClip * clip)
   return TRUE;
 }
 
+/**
+ * ges_layer_add_clips:
+ * @layer: a #GESLayer
+ * @clips: (element-type GESClip) (transfer none): the #GESClip-s to add,
+ * floating references are sunk as with #ges_layer_add_clip
+ *
+ * Adds all the given clips to the layer, as #ges_layer_add_clip would, but
+ * only resyncing the priorities of the clips, creating the auto transitions
+ * and updating the gaps of the tracks once all of them have been added.
+ * See #ges_timeline_begin_batch.
+ *
+ * Returns: %TRUE if all the clips were properly added to the layer, %FALSE
+ * if the @layer refused to add some of them.
+ */
+gboolean
+ges_layer_add_clips (GESLayer * layer, GList * clips)
+{
+  GList *tmp;
+  gboolean res = TRUE;
+  GESTimeline *timeline;
+
+  g_return_val_if_fail (GES_IS_LAYER (layer), FALSE);
+
+  timeline = layer->timeline;
+  if (timeline)
+    ges_timeline_begin_batch (timeline);
+
+  layer->priv->adding_clips = TRUE;
+  for (tmp = clips; tmp; tmp = tmp->next) {
+    if (!ges_layer_add_clip (layer, tmp->data))
+      res = FALSE;
+  }
+  layer->priv->adding_clips = FALSE;
+
+  /* Ending the batch resyncs all layers */
+  if (timeline)
+    ges_timeline_end_batch (timeline);
+  else
+    ges_layer_resync_priorities (layer);
+
+  return res;
+}
+
 /**
  * ges_layer_add_asset:
  * @layer: a #GESLayer
@@ -748,15 +1032,16 @@ ges_layer_get_timeline (GESLayer * layer)
 void
 ges_layer_set_timeline (GESLayer * layer, GESTimeline * timeline)
 {
-  GList *tmp;
+  GList *clips = NULL, *tmp;
 
   g_return_if_fail (GES_IS_LAYER (layer));
 
   GST_DEBUG ("layer:%p, timeline:%p", layer, timeline);
 
-  for (tmp = layer->priv->clips_start; tmp; tmp = tmp->next) {
+  clip_tree_prepend_clips (layer->priv->clips_tree, &clips);
+  for (tmp = clips; tmp; tmp = tmp->next)
     ges_timeline_element_set_timeline (tmp->data, timeline);
-  }
+  g_list_free_full (clips, gst_object_unref);
 
   layer->timeline = timeline;
 }
@@ -775,28 +1060,12 @@ GList *
 ges_layer_get_clips_in_interval (GESLayer * layer, GstClockTime start,
     GstClockTime end)
 {
-  GList *tmp;
   GList *intersecting_clips = NULL;
-  GstClockTime clip_start, clip_end;
-  gboolean clip_intersects;
 
   g_return_val_if_fail (GES_IS_LAYER (layer), NULL);
 
-  for (tmp = layer->priv->clips_start; tmp; tmp = tmp->next) {
-    clip_intersects = FALSE;
-    clip_start = ges_timeline_element_get_start (tmp->data);
-    clip_end = clip_start + ges_timeline_element_get_duration (tmp->data);
-    if (start <= clip_start && clip_start < end)
-      clip_intersects = TRUE;
-    else if (start < clip_end && clip_end <= end)
-      clip_intersects = TRUE;
-    else if (clip_start < start && clip_end > end)
-      clip_intersects = TRUE;
-
-    if (clip_intersects)
-      intersecting_clips =
-          g_list_insert_sorted (intersecting_clips,
-          gst_object_ref (tmp->data), (GCompareFunc) element_start_compare);
-  }
+  clip_tree_prepend_clips_in_interval (layer->priv->clips_tree, start, end,
+      &intersecting_clips);
+
   return intersecting_clips;
 }
@@ -44,6 +44,8 @@ GST_DEBUG_CATEGORY_STATIC (ges_pipeline_debug);
 
 #define DEFAULT_TIMELINE_MODE  GES_PIPELINE_MODE_PREVIEW
 #define IN_RENDERING_MODE(timeline) ((timeline->priv->mode) & (GES_PIPELINE_MODE_RENDER | GES_PIPELINE_MODE_SMART_RENDER))
+/* Additional render targets are always re-encoded */
+#define RENDER_TARGETS_ENABLED(mode) (((mode) & GES_PIPELINE_MODE_RENDER) && !((mode) & GES_PIPELINE_MODE_SMART_RENDER))
 
 /* Structure corresponding to a timeline - sink link */
 
@@ -54,10 +56,20 @@ typedef struct
   GstPad *srcpad;               /* Timeline source pad */
   GstPad *playsinkpad;
   GstPad *encodebinpad;
+  /* Sink pads of the RenderTarget encodebins the track is linked to */
+  GList *target_pads;
 
   guint query_position_id;
 } OutputChain;
 
+/* Render target added with ges_pipeline_add_render_target() */
+typedef struct
+{
+  GstElement *encodebin;
+  GstElement *urisink;
+  GstEncodingProfile *profile;
+} RenderTarget;
+
 
 struct _GESPipelinePrivate
 {
@@ -71,9 +83,12 @@ struct _GESPipelinePrivate
 
   GMutex dyn_mutex;
   GList *chains;
-  GList *not_rendered_tracks;
+  /* Tracks kept in READY as nothing consumes them in the current mode */
+  GList *inactive_tracks;
 
   GstEncodingProfile *profile;
+  /* RenderTarget-s rendered next to the encodebin */
+  GList *render_targets;
 };
 
 enum
@@ -240,6 +255,16 @@ _timeline_track_removed_cb (GESTimeline * timeline, GESTrack * track,
   _unlink_track (pipeline, track);
 }
 
+static void
+_render_target_free (RenderTarget * target)
+{
+  gst_object_unref (target->encodebin);
+  gst_object_unref (target->urisink);
+  if (target->profile)
+    gst_encoding_profile_unref (target->profile);
+  g_slice_free (RenderTarget, target);
+}
+
 static void
 ges_pipeline_dispose (GObject * object)
 {
@@ -267,6 +292,23 @@ ges_pipeline_dispose (GObject * object)
     self->priv->profile = NULL;
   }
 
+  if (self->priv->render_targets) {
+    GList *tmp;
+
+    if (RENDER_TARGETS_ENABLED (self->priv->mode)) {
+      for (tmp = self->priv->render_targets; tmp; tmp = tmp->next) {
+        RenderTarget *target = tmp->data;
+
+        gst_bin_remove_many (GST_BIN (object), target->encodebin,
+            target->urisink, NULL);
+      }
+    }
+
+    g_list_free_full (self->priv->render_targets,
+        (GDestroyNotify) _render_target_free);
+    self->priv->render_targets = NULL;
+  }
+
   if (self->priv->timeline) {
     g_signal_handlers_disconnect_by_func (self->priv->timeline,
         _timeline_track_added_cb, self);
@@ -506,6 +548,52 @@ done:
   return TRUE;
 }
 
+/* Lists the sink pads of @encodebin that are not linked */
+static void
+_append_unlinked_pads (GstElement * encodebin, GString ** unlinked_issues)
+{
+  GstIterator *pads;
+  gboolean done = FALSE;
+  GValue paditem = { 0, };
+
+  pads = gst_element_iterate_sink_pads (encodebin);
+  while (!done) {
+    switch (gst_iterator_next (pads, &paditem)) {
+      case GST_ITERATOR_OK:
+      {
+        GstPad *testpad = g_value_get_object (&paditem);
+        if (!gst_pad_is_linked (testpad)) {
+          GstCaps *sinkcaps = gst_pad_query_caps (testpad, NULL);
+          gchar *caps_string = gst_caps_to_string (sinkcaps);
+          gchar *path_string =
+              gst_object_get_path_string (GST_OBJECT (testpad));
+          gst_caps_unref (sinkcaps);
+
+          if (!*unlinked_issues)
+            *unlinked_issues =
+                g_string_new ("Following encodebin pads are not linked:\n");
+
+          g_string_append_printf (*unlinked_issues, " - %s: %s",
+              path_string, caps_string);
+          g_free (caps_string);
+          g_free (path_string);
+        }
+        g_value_reset (&paditem);
+      }
+        break;
+      case GST_ITERATOR_DONE:
+      case GST_ITERATOR_ERROR:
+        done = TRUE;
+        break;
+      case GST_ITERATOR_RESYNC:
+        gst_iterator_resync (pads);
+        break;
+    }
+  }
+  g_value_reset (&paditem);
+  gst_iterator_free (pads);
+}
+
 static void
 _link_tracks (GESPipeline * pipeline)
 {
@@ -524,46 +612,13 @@ _link_tracks (GESPipeline * pipeline)
 
   if (IN_RENDERING_MODE (pipeline)) {
     GString *unlinked_issues = NULL;
-    GstIterator *pads;
-    gboolean done = FALSE;
-    GValue paditem = { 0, };
-
-    pads = gst_element_iterate_sink_pads (pipeline->priv->encodebin);
-    while (!done) {
-      switch (gst_iterator_next (pads, &paditem)) {
-        case GST_ITERATOR_OK:
-        {
-          GstPad *testpad = g_value_get_object (&paditem);
-          if (!gst_pad_is_linked (testpad)) {
-            GstCaps *sinkcaps = gst_pad_query_caps (testpad, NULL);
-            gchar *caps_string = gst_caps_to_string (sinkcaps);
-            gchar *path_string =
-                gst_object_get_path_string (GST_OBJECT (testpad));
-            gst_caps_unref (sinkcaps);
-
-            if (!unlinked_issues)
-              unlinked_issues =
-                  g_string_new ("Following encodebin pads are not linked:\n");
-
-            g_string_append_printf (unlinked_issues, " - %s: %s", path_string,
-                caps_string);
-            g_free (caps_string);
-            g_free (path_string);
-          }
-          g_value_reset (&paditem);
-        }
-          break;
-        case GST_ITERATOR_DONE:
-        case GST_ITERATOR_ERROR:
-          done = TRUE;
-          break;
-        case GST_ITERATOR_RESYNC:
-          gst_iterator_resync (pads);
-          break;
-      }
+
+    _append_unlinked_pads (pipeline->priv->encodebin, &unlinked_issues);
+    if (RENDER_TARGETS_ENABLED (pipeline->priv->mode)) {
+      for (tmp = pipeline->priv->render_targets; tmp; tmp = tmp->next)
+        _append_unlinked_pads (((RenderTarget *) tmp->data)->encodebin,
+            &unlinked_issues);
     }
-    g_value_reset (&paditem);
-    gst_iterator_free (pads);
 
     if (unlinked_issues) {
       GST_ELEMENT_ERROR (pipeline, STREAM, FAILED, (NULL), ("%s",
@@ -617,11 +672,15 @@ ges_pipeline_change_state (GstElement * element, GstStateChange transition)
       _link_tracks (self);
       break;
     case GST_STATE_CHANGE_PAUSED_TO_READY:
+    case GST_STATE_CHANGE_READY_TO_NULL:
     {
       GList *tmp;
 
-      for (tmp = self->priv->not_rendered_tracks; tmp; tmp = tmp->next)
+      /* Tracks are linked again in the next READY_TO_PAUSED */
+      for (tmp = self->priv->inactive_tracks; tmp; tmp = tmp->next)
         gst_element_set_locked_state (tmp->data, FALSE);
+      g_list_free (self->priv->inactive_tracks);
+      self->priv->inactive_tracks = NULL;
     }
       break;
     case GST_STATE_CHANGE_PAUSED_TO_PLAYING:
@@ -760,6 +819,149 @@ _query_position_cb (GstElement * composition, GESPipeline * self)
   return GST_CLOCK_TIME_NONE;
 }
 
+static gboolean
+_profile_has_stream_for_track (GstEncodingProfile * profile, GESTrack * track)
+{
+  const GList *tmp;
+
+  if (!GST_IS_ENCODING_CONTAINER_PROFILE (profile))
+    return TRACK_COMPATIBLE_PROFILE (track->type, profile);
+
+  for (tmp = gst_encoding_container_profile_get_profiles
+      (GST_ENCODING_CONTAINER_PROFILE (profile)); tmp; tmp = tmp->next) {
+    if (TRACK_COMPATIBLE_PROFILE (track->type, tmp->data))
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+/* Whether something consumes the output of @track in the current mode */
+static gboolean
+_track_is_needed (GESPipeline * self, GESTrack * track)
+{
+  GList *tmp;
+
+  if (track->type == GES_TRACK_TYPE_VIDEO &&
+      self->priv->mode & GES_PIPELINE_MODE_PREVIEW_VIDEO)
+    return TRUE;
+
+  if (track->type == GES_TRACK_TYPE_AUDIO &&
+      self->priv->mode & GES_PIPELINE_MODE_PREVIEW_AUDIO)
+    return TRUE;
+
+  if (track->type != GES_TRACK_TYPE_VIDEO &&
+      track->type != GES_TRACK_TYPE_AUDIO &&
+      self->priv->mode & GES_PIPELINE_MODE_PREVIEW)
+    return TRUE;
+
+  if (!IN_RENDERING_MODE (self))
+    return FALSE;
+
+  /* Let encodebin tell what it can do without a profile */
+  if (!self->priv->profile ||
+      _profile_has_stream_for_track (self->priv->profile, track))
+    return TRUE;
+
+  if (RENDER_TARGETS_ENABLED (self->priv->mode)) {
+    for (tmp = self->priv->render_targets; tmp; tmp = tmp->next) {
+      if (_profile_has_stream_for_track (((RenderTarget *) tmp->data)->profile,
+              track))
+        return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/* Keeps @track from going further than READY, so that its composition never
+ * prepares, nor decodes, any of its sources */
+static void
+_deactivate_track (GESPipeline * self, GESTrack * track)
+{
+  if (g_list_find (self->priv->inactive_tracks, track))
+    return;
+
+  GST_INFO_OBJECT (self, "Deactivating %" GST_PTR_FORMAT, track);
+
+  gst_element_set_locked_state (GST_ELEMENT (track), TRUE);
+  if (GST_STATE (track) > GST_STATE_READY)
+    gst_element_set_state (GST_ELEMENT (track), GST_STATE_READY);
+
+  self->priv->inactive_tracks =
+      g_list_append (self->priv->inactive_tracks, track);
+}
+
+/* Links @chain to @target if it has a stream for @track, returns the sink
+ * pad it got linked to */
+static GstPad *
+_link_render_target (GESPipeline * self, OutputChain * chain,
+    GESTrack * track, RenderTarget * target)
+{
+  GstPad *tmppad, *sinkpad;
+
+  if (!_profile_has_stream_for_track (target->profile, track))
+    return NULL;
+
+  sinkpad = get_compatible_unlinked_pad (target->encodebin, track);
+  if (sinkpad == NULL) {
+    GstCaps *caps = gst_pad_query_caps (chain->srcpad, NULL);
+
+    g_signal_emit_by_name (target->encodebin, "request-pad", caps, &sinkpad);
+    gst_caps_unref (caps);
+
+    if (G_UNLIKELY (sinkpad == NULL)) {
+      GST_WARNING_OBJECT (self, "Couldn't get a pad from %" GST_PTR_FORMAT
+          " for %" GST_PTR_FORMAT, target->encodebin, track);
+      return NULL;
+    }
+  }
+
+  tmppad = gst_element_get_request_pad (chain->tee, "src_%u");
+  if (G_UNLIKELY (gst_pad_link_full (tmppad, sinkpad,
+              GST_PAD_LINK_CHECK_NOTHING) != GST_PAD_LINK_OK)) {
+    GST_ERROR_OBJECT (self, "Couldn't link track pad to %" GST_PTR_FORMAT,
+        target->encodebin);
+    gst_element_release_request_pad (chain->tee, tmppad);
+    gst_object_unref (tmppad);
+    gst_element_release_request_pad (target->encodebin, sinkpad);
+    gst_object_unref (sinkpad);
+
+    return NULL;
+  }
+  gst_object_unref (tmppad);
+
+  GST_INFO_OBJECT (track, "Linked to %" GST_PTR_FORMAT, sinkpad);
+
+  return sinkpad;
+}
+
+static void
+_unlink_render_targets (GESPipeline * self, OutputChain * chain)
+{
+  GList *tmp;
+
+  for (tmp = chain->target_pads; tmp; tmp = tmp->next) {
+    GstPad *sinkpad = tmp->data;
+    GstPad *peer = gst_pad_get_peer (sinkpad);
+    GstElement *encodebin = gst_pad_get_parent_element (sinkpad);
+
+    if (peer) {
+      gst_pad_unlink (peer, sinkpad);
+      gst_object_unref (peer);
+    }
+
+    if (encodebin) {
+      gst_element_release_request_pad (encodebin, sinkpad);
+      gst_object_unref (encodebin);
+    }
+    gst_object_unref (sinkpad);
+  }
+
+  g_list_free (chain->target_pads);
+  chain->target_pads = NULL;
+}
+
 static void
 _link_track (GESPipeline * self, GESTrack * track)
 {
@@ -785,18 +987,18 @@ _link_track (GESPipeline * self, GESTrack * track)
     return;
   }
 
-  /* Don't connect track if it's not going to be used */
-  if (track->type == GES_TRACK_TYPE_VIDEO &&
-      !(self->priv->mode & GES_PIPELINE_MODE_PREVIEW_VIDEO) &&
-      !(self->priv->mode & GES_PIPELINE_MODE_RENDER) &&
-      !(self->priv->mode & GES_PIPELINE_MODE_SMART_RENDER)) {
-    GST_DEBUG_OBJECT (self, "Video track... but we don't need it. Not linking");
-  }
-  if (track->type == GES_TRACK_TYPE_AUDIO &&
-      !(self->priv->mode & GES_PIPELINE_MODE_PREVIEW_AUDIO) &&
-      !(self->priv->mode & GES_PIPELINE_MODE_RENDER) &&
-      !(self->priv->mode & GES_PIPELINE_MODE_SMART_RENDER)) {
-    GST_DEBUG_OBJECT (self, "Audio track... but we don't need it. Not linking");
+  /* Don't connect track if it's not going to be used, the composition can
+   * only be kept from running once the track reached READY, which happens
+   * before the tracks get linked again in READY_TO_PAUSED */
+  if (!_track_is_needed (self, track)) {
+    GST_DEBUG_OBJECT (self, "%" GST_PTR_FORMAT " not needed. Not linking",
+        track);
+
+    gst_object_unref (pad);
+    if (GST_STATE (track) >= GST_STATE_READY)
+      _deactivate_track (self, track);
+
+    return;
   }
 
   /* Get an existing chain or create it */
@@ -892,6 +1094,20 @@ _link_track (GESPipeline * self, GESTrack * track)
     GstPad *tmppad;
     GST_DEBUG_OBJECT (self, "Connecting to encodebin");
 
+    /* The track output is teed into every target, so that it is only
+     * decoded and composited once */
+    if (RENDER_TARGETS_ENABLED (self->priv->mode)) {
+      GList *tmp;
+
+      for (tmp = self->priv->render_targets; tmp; tmp = tmp->next) {
+        GstPad *target_pad =
+            _link_render_target (self, chain, track, tmp->data);
+
+        if (target_pad)
+          chain->target_pads = g_list_append (chain->target_pads, target_pad);
+      }
+    }
+
     if (!chain->encodebinpad) {
       /* Check for unused static pads */
       sinkpad = get_compatible_unlinked_pad (self->priv->encodebin, track);
@@ -904,14 +1120,15 @@ _link_track (GESPipeline * self, GESTrack * track)
             &sinkpad);
 
         if (G_UNLIKELY (sinkpad == NULL)) {
-          gst_element_set_locked_state (GST_ELEMENT (track), TRUE);
-
-          self->priv->not_rendered_tracks =
-              g_list_append (self->priv->not_rendered_tracks, track);
-
           GST_INFO_OBJECT (self,
               "Couldn't get a pad from encodebin for: %" GST_PTR_FORMAT, caps);
           gst_caps_unref (caps);
+
+          /* Only rendered by additional targets */
+          if (chain->target_pads)
+            goto done;
+
+          _deactivate_track (self, track);
           goto error;
         }
 
@@ -931,6 +1148,8 @@ _link_track (GESPipeline * self, GESTrack * track)
 
   }
 
+done:
+
   /* If chain wasn't already present, insert it in list */
   if (!get_output_chain_for_track (self, track))
     self->priv->chains = g_list_append (self->priv->chains, chain);
@@ -940,6 +1159,7 @@ _link_track (GESPipeline * self, GESTrack * track)
 
 error:
   {
+    _unlink_render_targets (self, chain);
     if (chain->tee) {
       gst_element_set_state (chain->tee, GST_STATE_NULL);
       gst_bin_remove (GST_BIN_CAST (self), chain->tee);
@@ -963,6 +1183,8 @@ _unlink_track (GESPipeline * self, GESTrack * track)
     return;
   }
 
+  _unlink_render_targets (self, chain);
+
   /* Unlink encodebin */
   if (chain->encodebinpad) {
     GstPad *peer = gst_pad_get_peer (chain->encodebinpad);
@@ -1034,31 +1256,9 @@ ges_pipeline_set_timeline (GESPipeline * pipeline, GESTimeline * timeline)
   return TRUE;
 }
 
-/**
- * ges_pipeline_set_render_settings:
- * @pipeline: a #GESPipeline
- * @output_uri: the URI to which the timeline will be rendered
- * @profile: the #GstEncodingProfile to use to render the timeline.
- *
- * Specify where the pipeline shall be rendered and with what settings.
- *
- * A copy of @profile and @output_uri will be done internally, the caller can
- * safely free those values afterwards.
- *
- * This method must be called before setting the pipeline mode to
- * #GES_PIPELINE_MODE_RENDER
- *
- * Returns: %TRUE if the settings were aknowledged properly, else %FALSE
- */
-gboolean
-ges_pipeline_set_render_settings (GESPipeline * pipeline,
-    const gchar * output_uri, GstEncodingProfile * profile)
+static void
+_set_profile_presence (GESPipeline * pipeline, GstEncodingProfile * profile)
 {
-  GError *err = NULL;
-  GstEncodingProfile *set_profile;
-
-  g_return_val_if_fail (GES_IS_PIPELINE (pipeline), FALSE);
-
   /*  FIXME Properly handle multi track, for now GESPipeline
    *  only hanles single track per type, so we should just set the
    *  presence to 1.
@@ -1086,6 +1286,34 @@ ges_pipeline_set_render_settings (GESPipeline * pipeline,
 
     g_list_free_full (tracks, gst_object_unref);
   }
+}
+
+/**
+ * ges_pipeline_set_render_settings:
+ * @pipeline: a #GESPipeline
+ * @output_uri: the URI to which the timeline will be rendered
+ * @profile: the #GstEncodingProfile to use to render the timeline.
+ *
+ * Specify where the pipeline shall be rendered and with what settings.
+ *
+ * A copy of @profile and @output_uri will be done internally, the caller can
+ * safely free those values afterwards.
+ *
+ * This method must be called before setting the pipeline mode to
+ * #GES_PIPELINE_MODE_RENDER
+ *
+ * Returns: %TRUE if the settings were aknowledged properly, else %FALSE
+ */
+gboolean
+ges_pipeline_set_render_settings (GESPipeline * pipeline,
+    const gchar * output_uri, GstEncodingProfile * profile)
+{
+  GError *err = NULL;
+  GstEncodingProfile *set_profile;
+
+  g_return_val_if_fail (GES_IS_PIPELINE (pipeline), FALSE);
+
+  _set_profile_presence (pipeline, profile);
 
   /* Clear previous URI sink if it existed */
   /* FIXME : We should figure out if it was added to the pipeline,
@@ -1125,6 +1353,77 @@ ges_pipeline_set_render_settings (GESPipeline * pipeline,
   return TRUE;
 }
 
+/**
+ * ges_pipeline_add_render_target:
+ * @pipeline: a #GESPipeline
+ * @output_uri: the URI to which the timeline will also be rendered
+ * @profile: the #GstEncodingProfile to render that output with
+ *
+ * Adds an output to render the timeline to, next to the one set with
+ * ges_pipeline_set_render_settings(). The timeline is only decoded and
+ * composited once, the output of each track being fed to every output
+ * having a stream for it, so that the outputs can for example be rendered
+ * at different resolutions, or without video.
+ *
+ * Additional outputs are only rendered in #GES_PIPELINE_MODE_RENDER, as
+ * they are always encoded from raw data, and this method must be called
+ * before setting the pipeline to that mode.
+ *
+ * Returns: %TRUE if the output could be added, else %FALSE
+ */
+gboolean
+ges_pipeline_add_render_target (GESPipeline * pipeline,
+    const gchar * output_uri, GstEncodingProfile * profile)
+{
+  GError *err = NULL;
+  RenderTarget *target;
+
+  g_return_val_if_fail (GES_IS_PIPELINE (pipeline), FALSE);
+  g_return_val_if_fail (output_uri, FALSE);
+  g_return_val_if_fail (GST_IS_ENCODING_PROFILE (profile), FALSE);
+  g_return_val_if_fail (!RENDER_TARGETS_ENABLED (pipeline->priv->mode), FALSE);
+
+  target = g_slice_new0 (RenderTarget);
+  target->encodebin = gst_element_factory_make ("encodebin", NULL);
+  if (G_UNLIKELY (target->encodebin == NULL)) {
+    GST_ERROR_OBJECT (pipeline, "Can't create encodebin instance !");
+    g_slice_free (RenderTarget, target);
+
+    return FALSE;
+  }
+  gst_object_ref_sink (target->encodebin);
+
+  target->urisink =
+      gst_element_make_from_uri (GST_URI_SINK, output_uri, NULL, &err);
+  if (G_UNLIKELY (target->urisink == NULL)) {
+    GST_ERROR_OBJECT (pipeline, "Couldn't not create sink for URI %s: '%s'",
+        output_uri, ((err
+                && err->message) ? err->message : "failed to create element"));
+    g_clear_error (&err);
+    gst_object_unref (target->encodebin);
+    g_slice_free (RenderTarget, target);
+
+    return FALSE;
+  }
+  gst_object_ref_sink (target->urisink);
+
+  _set_profile_presence (pipeline, profile);
+  g_object_set (target->encodebin, "profile", profile, NULL);
+  g_object_get (target->encodebin, "profile", &target->profile, NULL);
+  if (target->profile == NULL) {
+    GST_ERROR_OBJECT (pipeline, "Profile %" GST_PTR_FORMAT " could no be set",
+        profile);
+    _render_target_free (target);
+
+    return FALSE;
+  }
+
+  pipeline->priv->render_targets =
+      g_list_append (pipeline->priv->render_targets, target);
+
+  return TRUE;
+}
+
 /**
  * ges_pipeline_get_mode:
  * @pipeline: a #GESPipeline
@@ -1149,6 +1448,9 @@ ges_pipeline_get_mode (GESPipeline * pipeline)
  * the internal changes that happen. The caller will therefore have to
  * set the @pipeline to the requested state after calling this method.
  *
+ * Rendering modes are refused while the preview scale of the timeline
+ * is lower than 1.0, see ges_timeline_set_preview_scale().
+ *
  * Returns: %TRUE if the mode was properly set, else %FALSE.
  **/
 gboolean
@@ -1161,6 +1463,15 @@ ges_pipeline_set_mode (GESPipeline * pipeline, GESPipelineFlags mode)
   GST_DEBUG_OBJECT (pipeline, "current mode : %d, mode : %d",
       pipeline->priv->mode, mode);
 
+  if ((mode & (GES_PIPELINE_MODE_RENDER | GES_PIPELINE_MODE_SMART_RENDER)) &&
+      pipeline->priv->timeline &&
+      ges_timeline_get_preview_scale (pipeline->priv->timeline) < 1.0) {
+    GST_ERROR_OBJECT (pipeline, "Can not render a timeline using a preview"
+        " scale of %f, reset it to 1.0 first",
+        ges_timeline_get_preview_scale (pipeline->priv->timeline));
+    return FALSE;
+  }
+
   /* fast-path, nothing to change */
   if (mode == pipeline->priv->mode)
     return TRUE;
@@ -1216,6 +1527,15 @@ ges_pipeline_set_mode (GESPipeline * pipeline, GESPipelineFlags mode)
     gst_bin_remove_many (GST_BIN_CAST (pipeline),
         pipeline->priv->encodebin, pipeline->priv->urisink, NULL);
   }
+  if (RENDER_TARGETS_ENABLED (pipeline->priv->mode) &&
+      !RENDER_TARGETS_ENABLED (mode)) {
+    for (tmp = pipeline->priv->render_targets; tmp; tmp = tmp->next) {
+      RenderTarget *target = tmp->data;
+
+      gst_bin_remove_many (GST_BIN_CAST (pipeline), target->encodebin,
+          target->urisink, NULL);
+    }
+  }
 
   /* Add new elements */
   if (!(pipeline->priv->mode & GES_PIPELINE_MODE_PREVIEW) &&
@@ -1251,6 +1571,21 @@ ges_pipeline_set_mode (GESPipeline * pipeline, GESPipelineFlags mode)
     gst_element_link_pads_full (pipeline->priv->encodebin, "src",
         pipeline->priv->urisink, "sink", GST_PAD_LINK_CHECK_NOTHING);
   }
+  if (!RENDER_TARGETS_ENABLED (pipeline->priv->mode) &&
+      RENDER_TARGETS_ENABLED (mode)) {
+    for (tmp = pipeline->priv->render_targets; tmp; tmp = tmp->next) {
+      RenderTarget *target = tmp->data;
+
+      if (!gst_bin_add (GST_BIN_CAST (pipeline), target->encodebin) ||
+          !gst_bin_add (GST_BIN_CAST (pipeline), target->urisink)) {
+        GST_ERROR_OBJECT (pipeline, "Couldn't add render target");
+        return FALSE;
+      }
+
+      gst_element_link_pads_full (target->encodebin, "src", target->urisink,
+          "sink", GST_PAD_LINK_CHECK_NOTHING);
+    }
+  }
 
   /* FIXUPS */
   /* FIXME
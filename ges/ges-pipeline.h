@@ -90,6 +90,10 @@ gboolean ges_pipeline_set_render_settings (GESPipeline *pipeline,
 						    const gchar * output_uri,
 						    GstEncodingProfile *profile);
 GES_API
+gboolean ges_pipeline_add_render_target (GESPipeline *pipeline,
+						  const gchar * output_uri,
+						  GstEncodingProfile *profile);
+GES_API
 gboolean ges_pipeline_set_mode (GESPipeline *pipeline,
 					 GESPipelineFlags mode);
 
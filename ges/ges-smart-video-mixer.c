@@ -46,6 +46,16 @@ typedef struct _PadInfos
   GstPad *mixer_pad;
   GstElement *bin;
   gulong probe_id;
+
+  /* Positioning last set on @mixer_pad, only accessed from the streaming
+   * thread. Only the values that change get set again */
+  gboolean positioned;
+  gdouble alpha;
+  guint zorder;
+  gint posx;
+  gint posy;
+  gint width;
+  gint height;
 } PadInfos;
 
 static void
@@ -86,9 +96,15 @@ ges_smart_mixer_get_mixer_pad (GESSmartMixer * self, GstPad ** mixerpad)
 
 /* These metadata will get set by the upstream framepositioner element,
    added in the video sources' bin */
+#define UPDATE_PAD_PROPERTY(infos,meta,field,meta_field,name) G_STMT_START { \
+  if (!infos->positioned || infos->field != meta->meta_field) {                \
+    infos->field = meta->meta_field;                                           \
+    g_object_set (infos->mixer_pad, name, infos->field, NULL);                 \
+  }                                                                            \
+} G_STMT_END
+
 static GstPadProbeReturn
-parse_metadata (GstPad * mixer_pad, GstPadProbeInfo * info,
-    GESSmartMixer * self)
+parse_metadata (GstPad * mixer_pad, GstPadProbeInfo * info, PadInfos * infos)
 {
   GstFramePositionerMeta *meta;
 
@@ -101,15 +117,16 @@ parse_metadata (GstPad * mixer_pad, GstPadProbeInfo * info,
     return GST_PAD_PROBE_OK;
   }
 
-  if (!self->disable_zorder_alpha) {
-    g_object_set (mixer_pad, "alpha", meta->alpha,
-        "zorder", meta->zorder, NULL);
-  } else {
-    g_object_set (mixer_pad, "alpha", meta->alpha, NULL);
-  }
-
-  g_object_set (mixer_pad, "xpos", meta->posx, "ypos",
-      meta->posy, "width", meta->width, "height", meta->height, NULL);
+  /* The positioning rarely changes from one buffer to the next, avoid going
+   * through the pad properties when it does not */
+  UPDATE_PAD_PROPERTY (infos, meta, alpha, alpha, "alpha");
+  if (!infos->self->disable_zorder_alpha)
+    UPDATE_PAD_PROPERTY (infos, meta, zorder, zorder, "zorder");
+  UPDATE_PAD_PROPERTY (infos, meta, posx, posx, "xpos");
+  UPDATE_PAD_PROPERTY (infos, meta, posy, posy, "ypos");
+  UPDATE_PAD_PROPERTY (infos, meta, width, width, "width");
+  UPDATE_PAD_PROPERTY (infos, meta, height, height, "height");
+  infos->positioned = TRUE;
 
   return GST_PAD_PROBE_OK;
 }
@@ -166,7 +183,7 @@ _request_new_pad (GstElement * element, GstPadTemplate * templ,
 
   infos->probe_id =
       gst_pad_add_probe (infos->mixer_pad, GST_PAD_PROBE_TYPE_BUFFER,
-      (GstPadProbeCallback) parse_metadata, self, NULL);
+      (GstPadProbeCallback) parse_metadata, infos, NULL);
 
   LOCK (self);
   g_hash_table_insert (self->pads_infos, ghost, infos);
@@ -37,16 +37,84 @@ struct _GESSourcePrivate
 {
   /*  Dummy variable */
   GstFramePositioner *positioner;
+
+  /* The encoded caps the track accepts and that can be output without
+   * being decoded, computed in the main thread by
+   * ges_source_update_passthrough() and used by the decodebin streaming
+   * threads. @passthrough_decided is set once @decodebin plugged its
+   * streams according to them. Both with the object lock */
+  GstCaps *passthrough_caps;
+  gboolean passthrough_decided;
+  GstElement *decodebin;
 };
 
 /******************************
  *   Internal helper methods  *
  ******************************/
+static gboolean
+_structure_is_raw (const GstStructure * structure)
+{
+  return g_str_has_suffix (gst_structure_get_name (structure), "/x-raw");
+}
+
+static gboolean
+_pad_is_raw (GstPad * pad)
+{
+  gboolean raw = TRUE;
+  GstCaps *caps = gst_pad_get_current_caps (pad);
+
+  if (!caps)
+    caps = gst_pad_query_caps (pad, NULL);
+
+  if (!gst_caps_is_empty (caps) && !gst_caps_is_any (caps))
+    raw = _structure_is_raw (gst_caps_get_structure (caps, 0));
+  gst_caps_unref (caps);
+
+  return raw;
+}
+
+/* Makes the source bin containing @element output from @target, or from
+ * its conversion elements if %NULL */
+static void
+_set_bin_target (GstElement * element, GstPad * target)
+{
+  GstPad *ghost, *current;
+  GstElement *bin = GST_ELEMENT (gst_object_get_parent (GST_OBJECT
+          (element)));
+
+  if (!target)
+    target = g_object_get_data (G_OBJECT (bin), "ges-conversion-srcpad");
+
+  ghost = gst_element_get_static_pad (bin, "src");
+  current = gst_ghost_pad_get_target (GST_GHOST_PAD (ghost));
+  if (current != target)
+    gst_ghost_pad_set_target (GST_GHOST_PAD (ghost), target);
+
+  if (current)
+    gst_object_unref (current);
+  gst_object_unref (ghost);
+  gst_object_unref (bin);
+}
+
 static void
 _pad_added_cb (GstElement * element, GstPad * srcpad, GstPad * sinkpad)
 {
   GstPadLinkReturn res;
   gst_element_no_more_pads (element);
+
+  /* Encoded streams are only exposed when they can be rendered as is, see
+   * ges_source_update_decodebin_caps(), the conversion elements can not
+   * handle them */
+  if (!_pad_is_raw (srcpad)) {
+    GST_INFO_OBJECT (element, "Passing %" GST_PTR_FORMAT " through", srcpad);
+    _set_bin_target (element, srcpad);
+
+    return;
+  }
+
+  /* decodebin might have been passing an encoded stream through before
+   * getting replugged */
+  _set_bin_target (element, NULL);
   res = gst_pad_link (srcpad, sinkpad);
 #ifndef GST_DISABLE_GST_DEBUG
   if (res != GST_PAD_LINK_OK) {
@@ -77,6 +145,186 @@ _ghost_pad_added_cb (GstElement * element, GstPad * srcpad, GstElement * bin)
   gst_element_no_more_pads (element);
 }
 
+/* Whether the encoded stream of @self can be rendered without being
+ * decoded, meaning that nothing in @track needs to process it */
+static gboolean
+_can_pass_encoded (GESSource * self, GESTrack * track)
+{
+  GObject *child;
+  GParamSpec *pspec;
+  GHashTable *bindings;
+  gboolean res = TRUE;
+  GESTimelineElement *element = GES_TIMELINE_ELEMENT (self);
+
+  /* The mixer, effects and transitions all work on raw data */
+  if (ges_track_get_mixing (track))
+    return FALSE;
+
+  bindings =
+      ges_track_element_get_all_control_bindings (GES_TRACK_ELEMENT (self));
+  if (bindings && g_hash_table_size (bindings))
+    return FALSE;
+
+  /* Not creating the element just for that, the values of the children
+   * properties are restored when it gets created, which updates the
+   * passthrough again */
+  if (ges_track_element_has_element (GES_TRACK_ELEMENT (self)) &&
+      ges_timeline_element_lookup_child (element, "GstVolume::volume", &child,
+          &pspec)) {
+    gdouble volume;
+    gboolean mute;
+
+    g_object_get (child, "volume", &volume, "mute", &mute, NULL);
+    res = (volume == 1.0 && !mute);
+
+    gst_object_unref (child);
+    g_param_spec_unref (pspec);
+    if (!res)
+      return FALSE;
+  }
+
+  /* Effects of our clip, transitions and other sources all overlap us */
+  return !track_has_active_element_in_range (track, _START (element),
+      _END (element), GES_TRACK_ELEMENT (self));
+}
+
+/* Called from the decodebin streaming threads, only uses what was computed
+ * in the main thread by ges_source_update_passthrough() */
+static gboolean
+_autoplug_continue_cb (GstElement * decodebin, GstPad * pad, GstCaps * caps,
+    GESSource * self)
+{
+  gboolean passthrough;
+  GESSourcePrivate *priv = self->priv;
+
+  if (gst_caps_is_empty (caps) ||
+      _structure_is_raw (gst_caps_get_structure (caps, 0)))
+    return TRUE;
+
+  GST_OBJECT_LOCK (self);
+  priv->passthrough_decided = TRUE;
+  passthrough = priv->passthrough_caps &&
+      gst_caps_can_intersect (caps, priv->passthrough_caps);
+  GST_OBJECT_UNLOCK (self);
+
+  if (!passthrough)
+    return TRUE;
+
+  GST_INFO_OBJECT (self, "Not decoding %" GST_PTR_FORMAT, caps);
+
+  return FALSE;
+}
+
+/* Computes which encoded streams @self can output without decoding them,
+ * from the main thread. The track of @self calls this when committing if
+ * @self or what overlaps it changed, so that edits, like a transition or
+ * an effect now overlapping @self, are taken into account. The decodebin gets replugged if it
+ * already plugged its streams according to a different decision */
+void
+ges_source_update_passthrough (GESSource * self)
+{
+  guint i;
+  gboolean replug;
+  const GstCaps *caps = NULL;
+  GstCaps *passthrough_caps = NULL;
+  GESSourcePrivate *priv = self->priv;
+  GESTrack *track = ges_track_element_get_track (GES_TRACK_ELEMENT (self));
+
+  if (track)
+    caps = ges_track_get_caps (track);
+
+  if (caps && !gst_caps_is_any (caps)) {
+    passthrough_caps = gst_caps_new_empty ();
+    for (i = 0; i < gst_caps_get_size (caps); i++) {
+      if (!_structure_is_raw (gst_caps_get_structure (caps, i)))
+        gst_caps_append_structure_full (passthrough_caps,
+            gst_structure_copy (gst_caps_get_structure (caps, i)),
+            gst_caps_features_copy (gst_caps_get_features (caps, i)));
+    }
+
+    if (gst_caps_is_empty (passthrough_caps) ||
+        !_can_pass_encoded (self, track))
+      gst_caps_replace (&passthrough_caps, NULL);
+  }
+
+  GST_OBJECT_LOCK (self);
+  if (passthrough_caps == priv->passthrough_caps || (passthrough_caps &&
+          priv->passthrough_caps &&
+          gst_caps_is_equal (passthrough_caps, priv->passthrough_caps))) {
+    GST_OBJECT_UNLOCK (self);
+    if (passthrough_caps)
+      gst_caps_unref (passthrough_caps);
+
+    return;
+  }
+
+  GST_INFO_OBJECT (self, "Passing through: %" GST_PTR_FORMAT,
+      passthrough_caps);
+  gst_caps_replace (&priv->passthrough_caps, passthrough_caps);
+  replug = priv->passthrough_decided;
+  priv->passthrough_decided = FALSE;
+  GST_OBJECT_UNLOCK (self);
+
+  if (passthrough_caps)
+    gst_caps_unref (passthrough_caps);
+
+  if (replug && priv->decodebin) {
+    GST_INFO_OBJECT (self, "Replugging %" GST_PTR_FORMAT, priv->decodebin);
+    gst_element_set_state (priv->decodebin, GST_STATE_READY);
+    gst_element_sync_state_with_parent (priv->decodebin);
+  }
+}
+
+/* Sets the raw caps @decodebin should decode to from the caps of the track
+ * of @self. When smart rendering, the track also accepts some encoded
+ * streams, @decodebin then stops decoding those if they do not need to be
+ * processed, see ges_source_update_passthrough() */
+void
+ges_source_update_decodebin_caps (GESSource * self, GstElement * decodebin)
+{
+  guint i;
+  GstCaps *raw_caps = NULL;
+  const GstCaps *caps = NULL;
+  GESTrack *track = ges_track_element_get_track (GES_TRACK_ELEMENT (self));
+
+  if (track)
+    caps = ges_track_get_caps (track);
+
+  if (caps) {
+    raw_caps = gst_caps_new_empty ();
+    for (i = 0; i < gst_caps_get_size (caps); i++) {
+      if (_structure_is_raw (gst_caps_get_structure (caps, i)))
+        gst_caps_append_structure_full (raw_caps,
+            gst_structure_copy (gst_caps_get_structure (caps, i)),
+            gst_caps_features_copy (gst_caps_get_features (caps, i)));
+    }
+  }
+
+  GST_INFO_OBJECT (self, "Setting caps to: %" GST_PTR_FORMAT, raw_caps);
+  g_object_set (decodebin, "caps", raw_caps, NULL);
+  if (raw_caps)
+    gst_caps_unref (raw_caps);
+
+  if (!g_signal_handler_find (decodebin, G_SIGNAL_MATCH_FUNC, 0, 0, NULL,
+          _autoplug_continue_cb, NULL))
+    g_signal_connect (decodebin, "autoplug-continue",
+        G_CALLBACK (_autoplug_continue_cb), self);
+
+  if (self->priv->decodebin != decodebin) {
+    if (self->priv->decodebin)
+      g_object_remove_weak_pointer (G_OBJECT (self->priv->decodebin),
+          (gpointer *) & self->priv->decodebin);
+    self->priv->decodebin = decodebin;
+    g_object_add_weak_pointer (G_OBJECT (decodebin),
+        (gpointer *) & self->priv->decodebin);
+
+    /* A new decodebin did not plug anything yet */
+    GST_OBJECT_LOCK (self);
+    self->priv->passthrough_decided = FALSE;
+    GST_OBJECT_UNLOCK (self);
+  }
+}
+
 GstElement *
 ges_source_create_topbin (const gchar * bin_name, GstElement * sub_element, ...)
 {
@@ -112,6 +360,10 @@ ges_source_create_topbin (const gchar * bin_name, GstElement * sub_element, ...)
     ghost = gst_ghost_pad_new ("src", srcpad);
     gst_pad_set_active (ghost, TRUE);
     gst_element_add_pad (bin, ghost);
+    /* To output from the conversion elements again after passing an
+     * encoded stream through, see _pad_added_cb() */
+    g_object_set_data_full (G_OBJECT (bin), "ges-conversion-srcpad",
+        gst_object_ref (srcpad), gst_object_unref);
 
     sinkpad = gst_element_get_static_pad (first, "sink");
     if (sub_srcpad)
@@ -140,13 +392,42 @@ ges_source_create_topbin (const gchar * bin_name, GstElement * sub_element, ...)
   return bin;
 }
 
+static void
+ges_source_dispose (GObject * object)
+{
+  GESSourcePrivate *priv = GES_SOURCE (object)->priv;
+
+  if (priv->decodebin) {
+    g_object_remove_weak_pointer (G_OBJECT (priv->decodebin),
+        (gpointer *) & priv->decodebin);
+    priv->decodebin = NULL;
+  }
+
+  G_OBJECT_CLASS (ges_source_parent_class)->dispose (object);
+}
+
+static void
+ges_source_finalize (GObject * object)
+{
+  GESSourcePrivate *priv = GES_SOURCE (object)->priv;
+
+  if (priv->passthrough_caps)
+    gst_caps_unref (priv->passthrough_caps);
+
+  G_OBJECT_CLASS (ges_source_parent_class)->finalize (object);
+}
+
 static void
 ges_source_class_init (GESSourceClass * klass)
 {
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
   GESTrackElementClass *track_class = GES_TRACK_ELEMENT_CLASS (klass);
 
   g_type_class_add_private (klass, sizeof (GESSourcePrivate));
 
+  object_class->dispose = ges_source_dispose;
+  object_class->finalize = ges_source_finalize;
+
   track_class->nleobject_factorytype = "nlesource";
   track_class->create_element = NULL;
 }
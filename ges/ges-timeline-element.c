@@ -75,6 +75,7 @@ enum
 enum
 {
   DEEP_NOTIFY,
+  INTERNAL_NOTIFY,
   LAST_SIGNAL
 };
 
@@ -98,6 +99,12 @@ struct _GESTimelineElementPrivate
   GHashTable *children_props;
 
   GESTimelineElement *copied_from;
+
+  /* Number of ges_timeline_element_freeze_notify() calls not yet matched by
+   * ges_timeline_element_thaw_notify(), and the properties whose "notify"
+   * is held back until then, as (1 << prop_id) flags */
+  guint notify_freeze_count;
+  guint pending_notifies;
 };
 
 typedef struct
@@ -107,11 +114,29 @@ typedef struct
   GESTimelineElement *self;
 } EmitDeepNotifyInIdleData;
 
+/* The children properties of the track elements whose element does not
+ * exist yet are mapped to a placeholder, see
+ * ges_track_element_set_pending_child_property() */
+static void
+_child_set_property (GObject * child, GParamSpec * pspec,
+    const GValue * value)
+{
+  if (!ges_track_element_set_pending_child_property (child, pspec, value))
+    g_object_set_property (child, pspec->name, value);
+}
+
+static void
+_child_get_property (GObject * child, GParamSpec * pspec, GValue * value)
+{
+  if (!ges_track_element_get_pending_child_property (child, pspec, value))
+    g_object_get_property (child, pspec->name, value);
+}
+
 static void
 _set_child_property (GESTimelineElement * self G_GNUC_UNUSED, GObject * child,
     GParamSpec * pspec, GValue * value)
 {
-  g_object_set_property (child, pspec->name, value);
+  _child_set_property (child, pspec, value);
 }
 
 static gboolean
@@ -423,6 +448,15 @@ ges_timeline_element_class_init (GESTimelineElementClass * klass)
       G_SIGNAL_NO_HOOKS, 0, NULL, NULL, g_cclosure_marshal_generic,
       G_TYPE_NONE, 2, G_TYPE_OBJECT, G_TYPE_PARAM);
 
+  /* Not part of the API: emitted right away when the start, in-point,
+   * duration or priority changes, even while the "notify" signals are
+   * held back, so that GES can keep its own state in sync. Same signature
+   * as "notify" */
+  ges_timeline_element_signals[INTERNAL_NOTIFY] =
+      g_signal_new ("internal-notify", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_FIRST | G_SIGNAL_DETAILED | G_SIGNAL_NO_HOOKS, 0, NULL,
+      NULL, g_cclosure_marshal_generic, G_TYPE_NONE, 1, G_TYPE_PARAM);
+
   object_class->dispose = ges_timeline_element_dispose;
   object_class->finalize = ges_timeline_element_finalize;
 
@@ -670,6 +704,28 @@ ges_timeline_element_get_timeline (GESTimelineElement * self)
   return result;
 }
 
+static void
+_notify (GESTimelineElement * self, guint prop_id)
+{
+  GESTimelineElementPrivate *priv = self->priv;
+  GParamSpec *pspec = properties[prop_id];
+
+  g_signal_emit (self, ges_timeline_element_signals[INTERNAL_NOTIFY],
+      g_quark_from_string (pspec->name), pspec);
+
+  /* While the timeline is batching changes, the notifications are held
+   * back until the end of the batch */
+  if (!priv->notify_freeze_count && timeline_is_batching (self->timeline))
+    timeline_freeze_element_notify (self->timeline, self);
+
+  if (priv->notify_freeze_count) {
+    priv->pending_notifies |= 1 << prop_id;
+    return;
+  }
+
+  g_object_notify_by_pspec (G_OBJECT (self), pspec);
+}
+
 /**
  * ges_timeline_element_set_start:
  * @self: a #GESTimelineElement
@@ -714,7 +770,7 @@ ges_timeline_element_set_start (GESTimelineElement * self, GstClockTime start)
   if (klass->set_start) {
     if (klass->set_start (self, start)) {
       self->start = start;
-      g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_START]);
+      _notify (self, PROP_START);
     }
 
     GST_DEBUG_OBJECT (self, "New start: %" GST_TIME_FORMAT,
@@ -752,7 +808,7 @@ ges_timeline_element_set_inpoint (GESTimelineElement * self,
   if (klass->set_inpoint) {
     if (klass->set_inpoint (self, inpoint)) {
       self->inpoint = inpoint;
-      g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_INPOINT]);
+      _notify (self, PROP_INPOINT);
     }
 
     return;
@@ -822,7 +878,7 @@ ges_timeline_element_set_duration (GESTimelineElement * self,
   if (klass->set_duration) {
     if (klass->set_duration (self, duration)) {
       self->duration = duration;
-      g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_DURATION]);
+      _notify (self, PROP_DURATION);
     }
 
     return;
@@ -929,7 +985,7 @@ ges_timeline_element_set_priority (GESTimelineElement * self, guint32 priority)
   if (klass->set_priority) {
     if (klass->set_priority (self, priority)) {
       self->priority = priority;
-      g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_PRIORITY]);
+      _notify (self, PROP_PRIORITY);
     }
     return;
   }
@@ -1369,7 +1425,7 @@ ges_timeline_element_get_child_property_by_pspec (GESTimelineElement * self,
   if (!handler)
     goto not_found;
 
-  g_object_get_property (G_OBJECT (handler->child), pspec->name, value);
+  _child_get_property (handler->child, pspec, value);
 
   return;
 
@@ -1493,7 +1549,7 @@ ges_timeline_element_get_child_property (GESTimelineElement * self,
   if (G_VALUE_TYPE (value) == G_TYPE_INVALID)
     g_value_init (value, pspec->value_type);
 
-  g_object_get_property (child, pspec->name, value);
+  _child_get_property (child, pspec, value);
 
   gst_object_unref (child);
   g_param_spec_unref (pspec);
@@ -1525,6 +1581,10 @@ not_found:
  * contained elements have this property name you will get the first one, unless you
  * specify the class name in @name.
  *
+ * While the element of a #GESTrackElement that creates it on demand does not
+ * exist, see #GESTrack:lazy-elements-window, @element is a placeholder that
+ * can only be used through the children properties API of @self.
+ *
  * Returns: TRUE if @element and @pspec could be found. FALSE otherwise. In that
  * case the values for @pspec and @element are not modified. Unref @element after
  * usage.
@@ -1583,7 +1643,7 @@ ges_timeline_element_set_child_property_valist (GESTimelineElement * self,
     if (error)
       goto cant_copy;
 
-    g_object_set_property (child, pspec->name, &value);
+    _child_set_property (child, pspec, &value);
 
     gst_object_unref (child);
     g_param_spec_unref (pspec);
@@ -1668,7 +1728,7 @@ ges_timeline_element_get_child_property_valist (GESTimelineElement * self,
       goto not_found;
 
     g_value_init (&value, pspec->value_type);
-    g_object_get_property (child, pspec->name, &value);
+    _child_get_property (child, pspec, &value);
     gst_object_unref (child);
     g_param_spec_unref (pspec);
 
@@ -1880,3 +1940,57 @@ ges_timeline_element_get_copied_from (GESTimelineElement * self)
   self->priv->copied_from = NULL;
   return copied_from;
 }
+
+/* Emits the change of one of the start, in-point, duration or priority
+ * properties, for subclasses setting the fields themselves */
+void
+ges_timeline_element_notify (GESTimelineElement * self,
+    const gchar * property_name)
+{
+  guint i, prop_ids[] = { PROP_START, PROP_INPOINT, PROP_DURATION,
+    PROP_PRIORITY
+  };
+
+  for (i = 0; i < G_N_ELEMENTS (prop_ids); i++) {
+    if (!g_strcmp0 (properties[prop_ids[i]]->name, property_name)) {
+      _notify (self, prop_ids[i]);
+
+      return;
+    }
+  }
+
+  g_object_notify (G_OBJECT (self), property_name);
+}
+
+/* Holds back the "notify" signals of the start, in-point, duration and
+ * priority of @self until ges_timeline_element_thaw_notify() is called,
+ * each changed property then being notified once. The "internal-notify"
+ * signal is still emitted on every change */
+void
+ges_timeline_element_freeze_notify (GESTimelineElement * self)
+{
+  self->priv->notify_freeze_count++;
+}
+
+void
+ges_timeline_element_thaw_notify (GESTimelineElement * self)
+{
+  GESTimelineElementPrivate *priv = self->priv;
+  guint i, prop_ids[] = { PROP_START, PROP_INPOINT, PROP_DURATION,
+    PROP_PRIORITY
+  };
+
+  g_return_if_fail (priv->notify_freeze_count > 0);
+
+  if (--priv->notify_freeze_count)
+    return;
+
+  gst_object_ref (self);
+  for (i = 0; i < G_N_ELEMENTS (prop_ids); i++) {
+    if (priv->pending_notifies & (1 << prop_ids[i])) {
+      priv->pending_notifies &= ~(1 << prop_ids[i]);
+      g_object_notify_by_pspec (G_OBJECT (self), properties[prop_ids[i]]);
+    }
+  }
+  gst_object_unref (self);
+}
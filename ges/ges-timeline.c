@@ -87,6 +87,17 @@ GST_DEBUG_CATEGORY_STATIC (ges_timeline_debug);
         g_thread_self());         \
   } G_STMT_END
 
+/* Start or end of a source, also used for the snapping points set by the
+ * user, in which case @source is %NULL */
+typedef struct
+{
+  guint64 time;
+  GESTrackElement *source;
+  gboolean is_end;
+  /* In the endpoints index of the layer and track of @source */
+  GSequenceIter *iter;
+} SourceEndpoint;
+
 typedef struct TrackObjIters
 {
   GSequenceIter *iter_start;
@@ -96,6 +107,11 @@ typedef struct TrackObjIters
 
   GESLayer *layer;
   GESTrackElement *trackelement;
+
+  /* Sources only, the (layer, track) endpoints sequence they are in */
+  GSequence *endpoints;
+  SourceEndpoint start_endpoint;
+  SourceEndpoint end_endpoint;
 } TrackObjIters;
 
 static void
@@ -104,6 +120,25 @@ _destroy_obj_iters (TrackObjIters * iters)
   g_slice_free (TrackObjIters, iters);
 }
 
+static void
+_destroy_endpoint (SourceEndpoint * endpoint)
+{
+  g_slice_free (SourceEndpoint, endpoint);
+}
+
+/* Time range of a layer where something changed since the last commit */
+typedef struct
+{
+  GstClockTime start;
+  GstClockTime end;
+} DirtyRange;
+
+static void
+_destroy_dirty_range (DirtyRange * range)
+{
+  g_slice_free (DirtyRange, range);
+}
+
 /*  The move context is used for the timeline editing modes functions in order to
  *  + Ripple / Roll /  Slide / Move / Trim
  *
@@ -121,6 +156,8 @@ struct _MoveContext
 
   /* Ripple and Roll Objects */
   GList *moving_trackelements;
+  /* Set of the moving_trackelements */
+  GHashTable *moving_trackelements_set;
 
   /* We use it as a set of Clip to move between layers */
   GHashTable *toplevel_containers;
@@ -167,6 +204,13 @@ struct _GESTimelinePrivate
   /* Timeline edition modes and snapping management */
   guint64 snapping_distance;
 
+  /* Factor applied to the video size of the tracks, clips using their
+   * asset proxy when it is lower than 1.0 */
+  gdouble preview_scale;
+  /* {GESClip: GESAsset} the clips switched to a proxy because of
+   * @preview_scale and their original asset */
+  GHashTable *proxied_clips;
+
   /* FIXME: Should we offer an API over those fields ?
    * FIXME: Should other classes than subclasses of Source also
    * be tracked? */
@@ -174,9 +218,9 @@ struct _GESTimelinePrivate
   /* Snapping fields */
   GHashTable *by_start;         /* {Source: start} */
   GHashTable *by_end;           /* {Source: end} */
-  GHashTable *by_object;        /* {timecode: Source} */
   GHashTable *obj_iters;        /* {Source: TrackObjIters} */
-  GSequence *starts_ends;       /* Sorted list of starts/ends */
+  GSequence *starts_ends;       /* Sorted list of SourceEndpoint */
+  GSequence *snapping_points;   /* Sorted list of SourceEndpoint without source */
   /* We keep 1 reference to our trackelement here */
   GSequence *tracksources;      /* Source-s sorted by start/priorities */
 
@@ -185,10 +229,17 @@ struct _GESTimelinePrivate
   /* FIXME: We should definitly offer an API over this,
    * probably through a ges_layer_get_track_elements () method */
   GHashTable *by_layer;         /* {layer: GSequence of TrackElement by start/priorities} */
+  /* {layer: {track: GSequence of SourceEndpoint sorted by time}}, so that
+   * looking for transitions only walks the sources of one layer and track */
+  GHashTable *endpoints;
 
   /* Avoid sorting layers when we are actually resyncing them ourself */
   gboolean resyncing_layers;
   GList *auto_transitions;
+  GHashTable *auto_transitions_by_previous;     /* {Source: GESAutoTransition} */
+  GHashTable *auto_transitions_by_next; /* {Source: GESAutoTransition} */
+  /* Set of the GESAutoTransition-s whose neighbours changed during a batch */
+  GHashTable *pending_auto_transitions;
 
   MoveContext movecontext;
 
@@ -213,6 +264,18 @@ struct _GESTimelinePrivate
   /* For ges_timeline_commit_sync */
   GMutex commited_lock;
   GCond commited_cond;
+  gboolean commited;
+
+  /* Number of ges_timeline_begin_batch() calls not yet matched by
+   * ges_timeline_end_batch() */
+  guint batch_depth;
+  /* The elements whose notifications are held back until the end of the
+   * batch, most recently changed first */
+  GList *frozen_elements;
+
+  /* {layer: DirtyRange}, the layers and time ranges where elements changed
+   * since the last commit, only those get rescanned when committing */
+  GHashTable *dirty_layers;
 };
 
 /* private structure to contain our track-related information */
@@ -233,6 +296,7 @@ enum
   PROP_DURATION,
   PROP_AUTO_TRANSITION,
   PROP_SNAPPING_DISTANCE,
+  PROP_PREVIEW_SCALE,
   PROP_UPDATE,
   PROP_LAST
 };
@@ -251,6 +315,7 @@ enum
   SNAPING_ENDED,
   SELECT_TRACKS_FOR_OBJECT,
   COMMITED,
+  RANGE_SHIFTED,
   LAST_SIGNAL
 };
 
@@ -259,6 +324,7 @@ static GstBinClass *parent_class;
 static guint ges_timeline_signals[LAST_SIGNAL] = { 0 };
 
 static gint custom_find_track (TrackPrivate * tr_priv, GESTrack * track);
+static gboolean _proxy_clip (GESTimeline * timeline, GESClip * clip);
 
 static guint nb_assets = 0;
 
@@ -319,6 +385,9 @@ ges_timeline_get_property (GObject * object, guint property_id,
     case PROP_SNAPPING_DISTANCE:
       g_value_set_uint64 (value, timeline->priv->snapping_distance);
       break;
+    case PROP_PREVIEW_SCALE:
+      g_value_set_double (value, timeline->priv->preview_scale);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
   }
@@ -337,11 +406,26 @@ ges_timeline_set_property (GObject * object, guint property_id,
     case PROP_SNAPPING_DISTANCE:
       timeline->priv->snapping_distance = g_value_get_uint64 (value);
       break;
+    case PROP_PREVIEW_SCALE:
+      ges_timeline_set_preview_scale (timeline, g_value_get_double (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
   }
 }
 
+static void
+_thaw_frozen_elements (GESTimeline * timeline)
+{
+  GList *tmp, *elements = g_list_reverse (timeline->priv->frozen_elements);
+
+  /* The notification handlers can start another batch */
+  timeline->priv->frozen_elements = NULL;
+  for (tmp = elements; tmp; tmp = tmp->next)
+    ges_timeline_element_thaw_notify (tmp->data);
+  g_list_free_full (elements, gst_object_unref);
+}
+
 static void
 ges_timeline_dispose (GObject * object)
 {
@@ -349,6 +433,8 @@ ges_timeline_dispose (GObject * object)
   GESTimelinePrivate *priv = tl->priv;
   GList *tmp, *groups;
 
+  _thaw_frozen_elements (tl);
+
   while (tl->layers) {
     GESLayer *layer = (GESLayer *) tl->layers->data;
     ges_timeline_remove_layer (GES_TIMELINE (object), layer);
@@ -373,14 +459,21 @@ ges_timeline_dispose (GObject * object)
 
   g_hash_table_unref (priv->by_start);
   g_hash_table_unref (priv->by_end);
-  g_hash_table_unref (priv->by_object);
   g_hash_table_unref (priv->by_layer);
+  g_hash_table_unref (priv->endpoints);
   g_hash_table_unref (priv->obj_iters);
+  g_hash_table_unref (priv->dirty_layers);
+  g_hash_table_unref (priv->proxied_clips);
   g_sequence_free (priv->starts_ends);
+  g_sequence_free (priv->snapping_points);
   g_sequence_free (priv->tracksources);
   g_list_free (priv->movecontext.moving_trackelements);
+  g_hash_table_unref (priv->movecontext.moving_trackelements_set);
   g_hash_table_unref (priv->movecontext.toplevel_containers);
 
+  g_hash_table_unref (priv->auto_transitions_by_previous);
+  g_hash_table_unref (priv->auto_transitions_by_next);
+  g_hash_table_unref (priv->pending_auto_transitions);
   g_list_free_full (priv->auto_transitions, gst_object_unref);
 
   g_hash_table_unref (priv->all_elements);
@@ -525,6 +618,20 @@ ges_timeline_class_init (GESTimelineClass * klass)
   g_object_class_install_property (object_class, PROP_SNAPPING_DISTANCE,
       properties[PROP_SNAPPING_DISTANCE]);
 
+  /**
+   * GESTimeline:preview-scale:
+   *
+   * Factor applied to the video size of the tracks for previewing, 1.0
+   * meaning full resolution. When lower than 1.0, the clips whose asset
+   * has a proxy use it instead, so that less data needs to be decoded.
+   */
+  properties[PROP_PREVIEW_SCALE] =
+      g_param_spec_double ("preview-scale", "Preview scale",
+      "Factor applied to the video size of the tracks", G_MINDOUBLE, 1.0,
+      1.0, G_PARAM_READWRITE);
+  g_object_class_install_property (object_class, PROP_PREVIEW_SCALE,
+      properties[PROP_PREVIEW_SCALE]);
+
   /**
    * GESTimeline::track-added:
    * @timeline: the #GESTimeline
@@ -603,7 +710,8 @@ ges_timeline_class_init (GESTimelineClass * klass)
    * GESTimeline::track-elements-snapping:
    * @timeline: the #GESTimeline
    * @obj1: the first #GESTrackElement that was snapping.
-   * @obj2: the second #GESTrackElement that was snapping.
+   * @obj2: (nullable): the second #GESTrackElement that was snapping, %NULL
+   * when snapping to a point added with #ges_timeline_add_snapping_point.
    * @position: the position where the two objects finally snapping.
    *
    * Will be emitted when the 2 #GESTrackElement first snapped
@@ -618,7 +726,8 @@ ges_timeline_class_init (GESTimelineClass * klass)
    * GESTimeline::snapping-end:
    * @timeline: the #GESTimeline
    * @obj1: the first #GESTrackElement that was snapping.
-   * @obj2: the second #GESTrackElement that was snapping.
+   * @obj2: (nullable): the second #GESTrackElement that was snapping, %NULL
+   * when snapping to a point added with #ges_timeline_add_snapping_point.
    * @position: the position where the two objects finally snapping.
    *
    * Will be emitted when the 2 #GESTrackElement ended to snap
@@ -653,6 +762,21 @@ ges_timeline_class_init (GESTimelineClass * klass)
   ges_timeline_signals[COMMITED] =
       g_signal_new ("commited", G_TYPE_FROM_CLASS (klass),
       G_SIGNAL_RUN_LAST, 0, NULL, NULL, NULL, G_TYPE_NONE, 0);
+
+  /**
+   * GESTimeline::range-shifted:
+   * @timeline: the #GESTimeline
+   * @position: the position the shifted elements were following
+   * @offset: how much the elements were moved by
+   *
+   * Will be emitted once a ripple edit moved all the elements following
+   * @position by @offset, after the start of each of them has been
+   * notified.
+   */
+  ges_timeline_signals[RANGE_SHIFTED] =
+      g_signal_new ("range-shifted", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST, 0, NULL, NULL, g_cclosure_marshal_generic,
+      G_TYPE_NONE, 2, G_TYPE_UINT64, G_TYPE_INT64);
 }
 
 static void
@@ -669,6 +793,9 @@ ges_timeline_init (GESTimeline * self)
   self->priv->duration = 0;
   self->priv->auto_transition = FALSE;
   priv->snapping_distance = 0;
+  priv->preview_scale = 1.0;
+  priv->proxied_clips = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+      gst_object_unref, gst_object_unref);
   priv->expected_async_done = 0;
   priv->expected_commited = 0;
 
@@ -679,15 +806,25 @@ ges_timeline_init (GESTimeline * self)
   priv->priv_tracks = NULL;
   priv->by_start = g_hash_table_new (g_direct_hash, g_direct_equal);
   priv->by_end = g_hash_table_new (g_direct_hash, g_direct_equal);
-  priv->by_object = g_hash_table_new (g_direct_hash, g_direct_equal);
   priv->by_layer = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
       (GDestroyNotify) g_sequence_free);
+  priv->endpoints = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+      (GDestroyNotify) g_hash_table_unref);
+  priv->auto_transitions_by_previous =
+      g_hash_table_new (g_direct_hash, g_direct_equal);
+  priv->auto_transitions_by_next =
+      g_hash_table_new (g_direct_hash, g_direct_equal);
+  priv->pending_auto_transitions =
+      g_hash_table_new (g_direct_hash, g_direct_equal);
   priv->obj_iters = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
       (GDestroyNotify) _destroy_obj_iters);
-  priv->starts_ends = g_sequence_new (g_free);
+  priv->starts_ends = g_sequence_new (NULL);
+  priv->snapping_points = g_sequence_new ((GDestroyNotify) _destroy_endpoint);
   priv->tracksources = g_sequence_new (gst_object_unref);
 
   priv->needs_transitions_update = TRUE;
+  priv->dirty_layers = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+      NULL, (GDestroyNotify) _destroy_dirty_range);
 
   priv->all_elements =
       g_hash_table_new_full (g_str_hash, g_str_equal, g_free, gst_object_unref);
@@ -754,6 +891,7 @@ static void
 timeline_update_duration (GESTimeline * timeline)
 {
   GstClockTime *cduration;
+  SourceEndpoint *last;
   GSequenceIter *it = g_sequence_get_end_iter (timeline->priv->starts_ends);
 
   it = g_sequence_iter_prev (it);
@@ -764,9 +902,10 @@ timeline_update_duration (GESTimeline * timeline)
     return;
   }
 
-  cduration = g_sequence_get (it);
+  last = g_sequence_get (it);
+  cduration = &last->time;
 
-  if (cduration && timeline->priv->duration != *cduration) {
+  if (timeline->priv->duration != *cduration) {
     GST_DEBUG ("track duration : %" GST_TIME_FORMAT " current : %"
         GST_TIME_FORMAT, GST_TIME_ARGS (*cduration),
         GST_TIME_ARGS (timeline->priv->duration));
@@ -792,19 +931,143 @@ find_layer_by_prio (GESLayer * a, gpointer pprio)
 static void
 sort_track_elements (GESTimeline * timeline, TrackObjIters * iters)
 {
-  g_sequence_sort_changed (iters->iter_obj,
+  _ges_sequence_sort_changed (iters->iter_obj,
       (GCompareDataFunc) element_start_compare, NULL);
 }
 
 static gint
-compare_uint64 (guint64 * a, guint64 * b, gpointer user_data)
+compare_endpoints (SourceEndpoint * a, SourceEndpoint * b, gpointer user_data)
 {
-  if (*a > *b)
-    return 1;
-  else if (*a == *b)
-    return 0;
-  else
-    return -1;
+  if (a->time != b->time)
+    return a->time > b->time ? 1 : -1;
+
+  /* Ends first so that sources only touching each other are never seen
+   * as overlapping */
+  return b->is_end - a->is_end;
+}
+
+static gboolean
+_sequence_is_sorted (GSequence * sequence, GCompareDataFunc cmp_func)
+{
+  GSequenceIter *iter, *next;
+
+  for (iter = g_sequence_get_begin_iter (sequence);
+      !g_sequence_iter_is_end (iter); iter = next) {
+    next = g_sequence_iter_next (iter);
+
+    if (!g_sequence_iter_is_end (next) &&
+        cmp_func (g_sequence_get (iter), g_sequence_get (next), NULL) > 0)
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+static gboolean
+_endpoints_are_valid (GSequence * endpoints)
+{
+  GSequenceIter *iter;
+
+  for (iter = g_sequence_get_begin_iter (endpoints);
+      !g_sequence_iter_is_end (iter); iter = g_sequence_iter_next (iter)) {
+    SourceEndpoint *endpoint = g_sequence_get (iter);
+    GESTimelineElement *source = GES_TIMELINE_ELEMENT (endpoint->source);
+
+    if (source && endpoint->time != (endpoint->is_end ? _END (source) :
+            _START (source)))
+      return FALSE;
+  }
+
+  return _sequence_is_sorted (endpoints, (GCompareDataFunc) compare_endpoints);
+}
+
+gboolean
+ges_timeline_check_indexes (GESTimeline * timeline)
+{
+  GHashTableIter iter, track_iter;
+  gpointer by_layer, by_track, endpoints;
+  GESTimelinePrivate *priv = timeline->priv;
+
+  if (!_endpoints_are_valid (priv->starts_ends) ||
+      !_sequence_is_sorted (priv->tracksources,
+          (GCompareDataFunc) element_start_compare))
+    return FALSE;
+
+  g_hash_table_iter_init (&iter, priv->by_layer);
+  while (g_hash_table_iter_next (&iter, NULL, &by_layer)) {
+    if (!_sequence_is_sorted (by_layer,
+            (GCompareDataFunc) element_start_compare))
+      return FALSE;
+  }
+
+  g_hash_table_iter_init (&iter, priv->endpoints);
+  while (g_hash_table_iter_next (&iter, NULL, &by_track)) {
+    g_hash_table_iter_init (&track_iter, by_track);
+    while (g_hash_table_iter_next (&track_iter, NULL, &endpoints)) {
+      if (!_endpoints_are_valid (endpoints))
+        return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+static void
+_track_source_endpoints (GESTimeline * timeline, TrackObjIters * iters)
+{
+  GSequence *endpoints;
+  GHashTable *by_track;
+  GESTrack *track = ges_track_element_get_track (iters->trackelement);
+
+  if (!iters->layer || !track)
+    return;
+
+  by_track = g_hash_table_lookup (timeline->priv->endpoints, iters->layer);
+  if (!by_track) {
+    by_track = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+        (GDestroyNotify) g_sequence_free);
+    g_hash_table_insert (timeline->priv->endpoints, iters->layer, by_track);
+  }
+
+  endpoints = g_hash_table_lookup (by_track, track);
+  if (!endpoints) {
+    endpoints = g_sequence_new (NULL);
+    g_hash_table_insert (by_track, track, endpoints);
+  }
+
+  iters->endpoints = endpoints;
+  iters->start_endpoint.iter = g_sequence_insert_sorted (endpoints,
+      &iters->start_endpoint, (GCompareDataFunc) compare_endpoints, NULL);
+  iters->end_endpoint.iter = g_sequence_insert_sorted (endpoints,
+      &iters->end_endpoint, (GCompareDataFunc) compare_endpoints, NULL);
+}
+
+static void
+_untrack_source_endpoints (TrackObjIters * iters)
+{
+  if (!iters->endpoints)
+    return;
+
+  g_sequence_remove (iters->start_endpoint.iter);
+  g_sequence_remove (iters->end_endpoint.iter);
+  iters->endpoints = NULL;
+}
+
+/* Makes sure no source references @endpoints anymore, before it gets freed */
+static void
+_forget_endpoints (GESTimeline * timeline, GSequence * endpoints)
+{
+  GSequenceIter *iter;
+
+  for (iter = g_sequence_get_begin_iter (endpoints);
+      !g_sequence_iter_is_end (iter); iter = g_sequence_iter_next (iter)) {
+    SourceEndpoint *endpoint = g_sequence_get (iter);
+    TrackObjIters *iters = g_hash_table_lookup (timeline->priv->obj_iters,
+        endpoint->source);
+
+    if (iters)
+      iters->endpoints = NULL;
+  }
 }
 
 static gint
@@ -824,8 +1087,11 @@ sort_starts_ends_end (GESTimeline * timeline, TrackObjIters * iters)
 
   *end = _START (obj) + _DURATION (obj);
 
-  g_sequence_sort_changed (iters->iter_end, (GCompareDataFunc) compare_uint64,
-      NULL);
+  _ges_sequence_sort_changed (iters->iter_end,
+      (GCompareDataFunc) compare_endpoints, NULL);
+  if (iters->endpoints)
+    _ges_sequence_sort_changed (iters->end_endpoint.iter,
+        (GCompareDataFunc) compare_endpoints, NULL);
   timeline_update_duration (timeline);
 }
 
@@ -838,8 +1104,11 @@ sort_starts_ends_start (GESTimeline * timeline, TrackObjIters * iters)
 
   *start = _START (obj);
 
-  g_sequence_sort_changed (iters->iter_start,
-      (GCompareDataFunc) compare_uint64, NULL);
+  _ges_sequence_sort_changed (iters->iter_start,
+      (GCompareDataFunc) compare_endpoints, NULL);
+  if (iters->endpoints)
+    _ges_sequence_sort_changed (iters->start_endpoint.iter,
+        (GCompareDataFunc) compare_endpoints, NULL);
   timeline_update_duration (timeline);
 }
 
@@ -870,8 +1139,16 @@ _destroy_auto_transition_cb (GESAutoTransition * auto_transition,
   ges_layer_remove_clip (layer, transition);
   g_signal_handlers_disconnect_by_func (auto_transition,
       _destroy_auto_transition_cb, timeline);
-
-
+  g_hash_table_remove (priv->pending_auto_transitions, auto_transition);
+
+  if (g_hash_table_lookup (priv->auto_transitions_by_previous,
+          auto_transition->previous_source) == auto_transition)
+    g_hash_table_remove (priv->auto_transitions_by_previous,
+        auto_transition->previous_source);
+  if (g_hash_table_lookup (priv->auto_transitions_by_next,
+          auto_transition->next_source) == auto_transition)
+    g_hash_table_remove (priv->auto_transitions_by_next,
+        auto_transition->next_source);
   priv->auto_transitions =
       g_list_remove (priv->auto_transitions, auto_transition);
   gst_object_unref (auto_transition);
@@ -906,6 +1183,10 @@ create_transition (GESTimeline * timeline, GESTrackElement * previous,
 
   timeline->priv->auto_transitions =
       g_list_prepend (timeline->priv->auto_transitions, auto_transition);
+  g_hash_table_insert (timeline->priv->auto_transitions_by_previous, previous,
+      auto_transition);
+  g_hash_table_insert (timeline->priv->auto_transitions_by_next, next,
+      auto_transition);
 
   return auto_transition;
 }
@@ -919,26 +1200,24 @@ _find_transition_from_auto_transitions (GESTimeline * timeline,
     GESLayer * layer, GESTrack * track, GESTrackElement * prev,
     GESTrackElement * next, GstClockTime transition_duration)
 {
-  GList *tmp;
-
-  for (tmp = timeline->priv->auto_transitions; tmp; tmp = tmp->next) {
-    GESAutoTransition *auto_trans = (GESAutoTransition *) tmp->data;
-
-    /* We already have a transition linked to one of the elements we want to
-     * find a transition for */
-    if (auto_trans->previous_source == prev || auto_trans->next_source == next) {
-      if (auto_trans->previous_source != prev
-          || auto_trans->next_source != next) {
-        timeline->priv->needs_rollback = TRUE;
-        GST_INFO_OBJECT (timeline, "Failed creating auto transition, "
-            " trying to have 3 clips overlapping, rolling back");
-      }
-
-      return auto_trans;
-    }
+  GESAutoTransition *auto_trans;
+
+  auto_trans = g_hash_table_lookup (timeline->priv->auto_transitions_by_previous,
+      prev);
+  if (!auto_trans)
+    auto_trans = g_hash_table_lookup (timeline->priv->auto_transitions_by_next,
+        next);
+
+  /* We already have a transition linked to one of the elements we want to
+   * find a transition for */
+  if (auto_trans && (auto_trans->previous_source != prev
+          || auto_trans->next_source != next)) {
+    timeline->priv->needs_rollback = TRUE;
+    GST_INFO_OBJECT (timeline, "Failed creating auto transition, "
+        " trying to have 3 clips overlapping, rolling back");
   }
 
-  return NULL;
+  return auto_trans;
 }
 
 static GESAutoTransition *
@@ -989,69 +1268,111 @@ _create_auto_transition_from_transitions (GESTimeline * timeline,
   return NULL;
 }
 
-/* Create all transition that do not exist on @layer.
- * @get_auto_transition is called to check if a particular transition exists.
- * If @track is specified, we will create the transitions only for that particular
- * track. */
-static void
-_create_transitions_on_layer (GESTimeline * timeline, GESLayer * layer,
-    GESTrack * track, GESTrackElement * initiating_obj,
-    GetAutoTransitionFunc get_auto_transition)
+static gboolean
+_is_track_element_in (GESTrackElement * element, guint32 layer_prio,
+    GESTrack * track)
+{
+  return _ges_track_element_get_layer_priority (element) == layer_prio &&
+      (!track || track == ges_track_element_get_track (element));
+}
+
+/* Gets the sources of @layer which start before @position and end after it,
+ * sorted by start */
+static GList *
+_get_sources_overlapping (GESTimeline * timeline, GESLayer * layer,
+    GESTrack * track, GstClockTime position)
 {
-  guint32 layer_prio;
+  GList *clips, *tmp, *child, *sources = NULL;
+  guint32 layer_prio = ges_layer_get_priority (layer);
+
+  clips = ges_layer_get_clips_in_interval (layer, position, position + 1);
+  for (tmp = clips; tmp; tmp = tmp->next) {
+    for (child = GES_CONTAINER_CHILDREN (tmp->data); child;
+        child = child->next) {
+      GESTrackElement *source = child->data;
+
+      /* Only the sources tracked in starts_ends */
+      if (!g_hash_table_contains (timeline->priv->by_start, source) ||
+          !_is_track_element_in (source, layer_prio, track))
+        continue;
+
+      if (_START (source) < position && _END (source) > position)
+        sources = g_list_insert_sorted (sources, source,
+            (GCompareFunc) element_start_compare);
+    }
+  }
+  g_list_free_full (clips, gst_object_unref);
+
+  return sources;
+}
+
+/* Create all transition that do not exist between the sources of @track in
+ * @layer, walking their @endpoints.
+ * Returns %FALSE if we went through the end of @initiating_obj, meaning
+ * there is nothing else to look for */
+static gboolean
+_create_transitions_on_layer_track (GESTimeline * timeline, GESLayer * layer,
+    GESTrack * track, GSequence * endpoints, GESTrackElement * initiating_obj,
+    GetAutoTransitionFunc get_auto_transition, GstClockTime start,
+    GstClockTime end)
+{
+  GList *tmp;
   GSequenceIter *iter;
   GESAutoTransition *transition;
   GESContainer *toplevel_next;
   MoveContext *mv_ctx = &timeline->priv->movecontext;
-  GESTrack *ctrack = track;
-  GList *entered = NULL;        /* List of TrackElement for wich we walk through the
-                                 * "start" but not the "end" in the starts_ends list */
-  GESTimelinePrivate *priv = timeline->priv;
+  GQueue entered = G_QUEUE_INIT;        /* TrackElement-s for wich we walked
+                                         * through the start but not the end */
+
+  iter = g_sequence_get_begin_iter (endpoints);
+  if (start > 0) {
+    guint64 pos = start;
+    SourceEndpoint key = { pos, NULL, TRUE, NULL };
+
+    /* Start at the first start or end at @start, the sources we would have
+     * walked through the start of until there are already entered */
+    iter = g_sequence_search (endpoints, &key,
+        (GCompareDataFunc) compare_endpoints, NULL);
+    while (!g_sequence_iter_is_begin (iter)) {
+      GSequenceIter *prev = g_sequence_iter_prev (iter);
+
+      if (((SourceEndpoint *) g_sequence_get (prev))->time < start)
+        break;
+      iter = prev;
+    }
 
-  if (!layer || !ges_layer_get_auto_transition (layer))
-    return;
+    entered.head = _get_sources_overlapping (timeline, layer, track, start);
+    entered.tail = g_list_last (entered.head);
+    entered.length = g_list_length (entered.head);
+  }
 
-  layer_prio = ges_layer_get_priority (layer);
-  for (iter = g_sequence_get_begin_iter (priv->starts_ends);
-      iter && !g_sequence_iter_is_end (iter);
-      iter = g_sequence_iter_next (iter)) {
-    GList *tmp;
-    guint *start_or_end = g_sequence_get (iter);
-    GESTrackElement *next = g_hash_table_lookup (timeline->priv->by_object,
-        start_or_end);
+  for (; !g_sequence_iter_is_end (iter); iter = g_sequence_iter_next (iter)) {
+    SourceEndpoint *endpoint = g_sequence_get (iter);
+    GESTrackElement *next = endpoint->source;
     GESContainer *toplevel =
         get_toplevel_container (GES_TIMELINE_ELEMENT (next));
 
-    /* Only object that are in that layer and track */
-    if (_ges_track_element_get_layer_priority (next) != layer_prio ||
-        (track && track != ges_track_element_get_track (next)))
-      continue;
-
-    if (track == NULL)
-      ctrack = ges_track_element_get_track (next);
+    if (GST_CLOCK_TIME_IS_VALID (end) && endpoint->time > end)
+      break;
 
-    if (start_or_end == g_hash_table_lookup (priv->by_end, next)) {
+    if (endpoint->is_end) {
       if (initiating_obj == next) {
         /* We passed the objects that initiated the research
          * we are now done */
-        g_list_free (entered);
-        return;
+        g_queue_clear (&entered);
+        return FALSE;
       }
-      entered = g_list_remove (entered, next);
+      g_queue_remove (&entered, next);
 
       continue;
     }
 
     toplevel_next = get_toplevel_container (next);
-    for (tmp = entered; tmp; tmp = tmp->next) {
+    for (tmp = entered.head; tmp; tmp = tmp->next) {
       gint64 transition_duration;
       GESTrackElement *prev = tmp->data;
       GESContainer *toplevel_prev = get_toplevel_container (prev);
 
-      /* If we are not in the same track, we do not create a transition */
-      if (ctrack != ges_track_element_get_track (prev))
-        continue;
-
       /* If elements are in the same toplevel element, we do not create a transition */
       if (get_toplevel_container (GES_TIMELINE_ELEMENT (prev)) == toplevel)
         continue;
@@ -1066,7 +1387,7 @@ _create_transitions_on_layer (GESTimeline * timeline, GESLayer * layer,
       if (transition_duration > 0 && transition_duration < _DURATION (prev) &&
           transition_duration < _DURATION (next)) {
         transition =
-            get_auto_transition (timeline, layer, ctrack, prev, next,
+            get_auto_transition (timeline, layer, track, prev, next,
             transition_duration);
         if (!transition)
           create_transition (timeline, prev, next, NULL, layer,
@@ -1076,7 +1397,50 @@ _create_transitions_on_layer (GESTimeline * timeline, GESLayer * layer,
 
     /* And add that object to the entered list so that it we can possibly set
      * a transition on its end edge */
-    entered = g_list_append (entered, next);
+    g_queue_push_tail (&entered, next);
+  }
+
+  g_queue_clear (&entered);
+
+  return TRUE;
+}
+
+/* Create all transition that do not exist on @layer.
+ * @get_auto_transition is called to check if a particular transition exists.
+ * If @track is specified, we will create the transitions only for that particular
+ * track.
+ * Only the transitions starting between @start and @end are looked for. */
+static void
+_create_transitions_on_layer (GESTimeline * timeline, GESLayer * layer,
+    GESTrack * track, GESTrackElement * initiating_obj,
+    GetAutoTransitionFunc get_auto_transition, GstClockTime start,
+    GstClockTime end)
+{
+  GHashTable *by_track;
+  GHashTableIter iter;
+  gpointer ctrack, endpoints;
+
+  if (!layer || !ges_layer_get_auto_transition (layer))
+    return;
+
+  by_track = g_hash_table_lookup (timeline->priv->endpoints, layer);
+  if (!by_track)
+    return;
+
+  if (track) {
+    endpoints = g_hash_table_lookup (by_track, track);
+    if (endpoints)
+      _create_transitions_on_layer_track (timeline, layer, track, endpoints,
+          initiating_obj, get_auto_transition, start, end);
+
+    return;
+  }
+
+  g_hash_table_iter_init (&iter, by_track);
+  while (g_hash_table_iter_next (&iter, &ctrack, &endpoints)) {
+    if (!_create_transitions_on_layer_track (timeline, layer, ctrack,
+            endpoints, initiating_obj, get_auto_transition, start, end))
+      return;
   }
 }
 
@@ -1094,6 +1458,12 @@ timeline_create_transitions (GESTimeline * timeline,
   if (!priv->needs_transitions_update)
     return;
 
+  /* Transitions get created for all layers at the end of the batch */
+  if (priv->batch_depth) {
+    GST_LOG_OBJECT (timeline, "Batching, not creating transitions yet");
+    return;
+  }
+
   if (mv_ctx->moving_trackelements &&
       GES_TIMELINE_ELEMENT_START (track_element) > mv_ctx->start) {
     GST_DEBUG_OBJECT (timeline, "Not creating transition around %"
@@ -1109,7 +1479,7 @@ timeline_create_transitions (GESTimeline * timeline,
 
   _create_transitions_on_layer (timeline,
       layer_node ? layer_node->data : NULL, track, track_element,
-      _find_transition_from_auto_transitions);
+      _find_transition_from_auto_transitions, 0, GST_CLOCK_TIME_NONE);
 
   GST_DEBUG_OBJECT (timeline, "Done updating transitions");
 }
@@ -1118,9 +1488,12 @@ timeline_create_transitions (GESTimeline * timeline,
 static inline void
 init_movecontext (MoveContext * mv_ctx, gboolean first_init)
 {
-  if (G_UNLIKELY (first_init))
+  if (G_UNLIKELY (first_init)) {
     mv_ctx->toplevel_containers =
         g_hash_table_new (g_direct_hash, g_direct_equal);
+    mv_ctx->moving_trackelements_set =
+        g_hash_table_new (g_direct_hash, g_direct_equal);
+  }
 
   mv_ctx->moving_trackelements = NULL;
   mv_ctx->start = G_MAXUINT64;
@@ -1137,19 +1510,65 @@ static inline void
 clean_movecontext (MoveContext * mv_ctx)
 {
   g_list_free (mv_ctx->moving_trackelements);
+  g_hash_table_remove_all (mv_ctx->moving_trackelements_set);
   g_hash_table_remove_all (mv_ctx->toplevel_containers);
   init_movecontext (mv_ctx, FALSE);
 }
 
+static void
+_mark_layer_dirty (GESTimeline * timeline, GESLayer * layer,
+    GstClockTime start, GstClockTime end)
+{
+  DirtyRange *range;
+
+  if (!layer)
+    return;
+
+  range = g_hash_table_lookup (timeline->priv->dirty_layers, layer);
+  if (!range) {
+    range = g_slice_new (DirtyRange);
+    range->start = start;
+    range->end = end;
+    g_hash_table_insert (timeline->priv->dirty_layers, layer, range);
+  } else {
+    range->start = MIN (range->start, start);
+    range->end = MAX (range->end, end);
+  }
+
+  GST_LOG_OBJECT (timeline, "%" GST_PTR_FORMAT " dirty from %" GST_TIME_FORMAT
+      " to %" GST_TIME_FORMAT, layer, GST_TIME_ARGS (range->start),
+      GST_TIME_ARGS (range->end));
+}
+
+/* Marks dirty the range covered by @trackelement in its layer, including
+ * the position it had before a move for sources */
+static void
+_mark_track_element_dirty (GESTimeline * timeline,
+    GESTrackElement * trackelement, GESLayer * layer)
+{
+  guint64 *pstart, *pend;
+  GstClockTime start = _START (trackelement), end = _END (trackelement);
+
+  pstart = g_hash_table_lookup (timeline->priv->by_start, trackelement);
+  if (pstart)
+    start = MIN (start, *pstart);
+
+  pend = g_hash_table_lookup (timeline->priv->by_end, trackelement);
+  if (pend)
+    end = MAX (end, *pend);
+
+  _mark_layer_dirty (timeline, layer, start, end);
+}
+
 static void
 stop_tracking_track_element (GESTimeline * timeline,
     GESTrackElement * trackelement)
 {
-  guint64 *start, *end;
   TrackObjIters *iters;
   GESTimelinePrivate *priv = timeline->priv;
 
   iters = g_hash_table_lookup (priv->obj_iters, trackelement);
+  _mark_track_element_dirty (timeline, trackelement, iters->layer);
   if (G_LIKELY (iters->iter_by_layer)) {
     g_sequence_remove (iters->iter_by_layer);
   } else {
@@ -1158,13 +1577,9 @@ stop_tracking_track_element (GESTimeline * timeline,
   }
 
   if (GES_IS_SOURCE (trackelement)) {
-    start = g_hash_table_lookup (priv->by_start, trackelement);
-    end = g_hash_table_lookup (priv->by_end, trackelement);
-
+    _untrack_source_endpoints (iters);
     g_hash_table_remove (priv->by_start, trackelement);
     g_hash_table_remove (priv->by_end, trackelement);
-    g_hash_table_remove (priv->by_object, end);
-    g_hash_table_remove (priv->by_object, start);
     g_sequence_remove (iters->iter_start);
     g_sequence_remove (iters->iter_end);
     g_sequence_remove (iters->iter_obj);
@@ -1177,7 +1592,6 @@ static void
 start_tracking_track_element (GESTimeline * timeline,
     GESTrackElement * trackelement)
 {
-  guint64 *pstart, *pend;
   GSequence *by_layer_sequence;
   TrackObjIters *iters;
   GESTimelinePrivate *priv = timeline->priv;
@@ -1210,29 +1624,31 @@ start_tracking_track_element (GESTimeline * timeline,
         g_sequence_insert_sorted (by_layer_sequence, trackelement,
         (GCompareDataFunc) element_start_compare, NULL);
     iters->layer = layer;
+    _mark_track_element_dirty (timeline, trackelement, layer);
   }
 
   if (GES_IS_SOURCE (trackelement)) {
     /* Track only sources for timeline edition and snapping */
-    pstart = g_malloc (sizeof (guint64));
-    pend = g_malloc (sizeof (guint64));
-    *pstart = _START (trackelement);
-    *pend = *pstart + _DURATION (trackelement);
-
-    iters->iter_start = g_sequence_insert_sorted (priv->starts_ends, pstart,
-        (GCompareDataFunc) compare_uint64, NULL);
-    iters->iter_end = g_sequence_insert_sorted (priv->starts_ends, pend,
-        (GCompareDataFunc) compare_uint64, NULL);
+    iters->start_endpoint.time = _START (trackelement);
+    iters->start_endpoint.source = trackelement;
+    iters->end_endpoint.time = _END (trackelement);
+    iters->end_endpoint.source = trackelement;
+    iters->end_endpoint.is_end = TRUE;
+
+    iters->iter_start = g_sequence_insert_sorted (priv->starts_ends,
+        &iters->start_endpoint, (GCompareDataFunc) compare_endpoints, NULL);
+    iters->iter_end = g_sequence_insert_sorted (priv->starts_ends,
+        &iters->end_endpoint, (GCompareDataFunc) compare_endpoints, NULL);
     iters->iter_obj =
         g_sequence_insert_sorted (priv->tracksources,
         gst_object_ref (trackelement), (GCompareDataFunc) element_start_compare,
         NULL);
     iters->trackelement = trackelement;
 
-    g_hash_table_insert (priv->by_start, trackelement, pstart);
-    g_hash_table_insert (priv->by_object, pstart, trackelement);
-    g_hash_table_insert (priv->by_end, trackelement, pend);
-    g_hash_table_insert (priv->by_object, pend, trackelement);
+    g_hash_table_insert (priv->by_start, trackelement,
+        &iters->start_endpoint.time);
+    g_hash_table_insert (priv->by_end, trackelement, &iters->end_endpoint.time);
+    _track_source_endpoints (timeline, iters);
 
     timeline->priv->movecontext.needs_move_ctx = TRUE;
 
@@ -1243,10 +1659,11 @@ start_tracking_track_element (GESTimeline * timeline,
 
 static inline void
 ges_timeline_emit_snappig (GESTimeline * timeline, GESTrackElement * obj1,
-    guint64 * timecode)
+    SourceEndpoint * snap)
 {
   GESTrackElement *obj2;
   MoveContext *mv_ctx = &timeline->priv->movecontext;
+  guint64 *timecode = snap ? &snap->time : NULL;
   GstClockTime snap_time = timecode ? *timecode : 0;
   GstClockTime last_snap_ts = mv_ctx->last_snap_ts ?
       *mv_ctx->last_snap_ts : GST_CLOCK_TIME_NONE;
@@ -1256,7 +1673,7 @@ ges_timeline_emit_snappig (GESTimeline * timeline, GESTrackElement * obj1,
       GST_TIME_ARGS (snap_time));
 
   if (timecode == NULL) {
-    if (mv_ctx->last_snaped1 != NULL && mv_ctx->last_snaped2 != NULL) {
+    if (mv_ctx->last_snaped1 != NULL && mv_ctx->last_snap_ts != NULL) {
       g_signal_emit (timeline, ges_timeline_signals[SNAPING_ENDED], 0,
           mv_ctx->last_snaped1, mv_ctx->last_snaped2, last_snap_ts);
 
@@ -1267,7 +1684,7 @@ ges_timeline_emit_snappig (GESTimeline * timeline, GESTrackElement * obj1,
     return;
   }
 
-  obj2 = g_hash_table_lookup (timeline->priv->by_object, timecode);
+  obj2 = snap->source;
 
   if (last_snap_ts != *timecode) {
     g_signal_emit (timeline, ges_timeline_signals[SNAPING_ENDED], 0,
@@ -1289,60 +1706,92 @@ ges_timeline_emit_snappig (GESTimeline * timeline, GESTrackElement * obj1,
   }
 }
 
-static GstClockTime *
-ges_timeline_snap_position (GESTimeline * timeline,
-    GESTrackElement * trackelement, GstClockTime * current,
-    GstClockTime timecode, gboolean emit)
+/* Looks for the closest of @points to @timecode, closer than @smallest_offset
+ * and not belonging to @container or to the containers being moved */
+static SourceEndpoint *
+_find_snapping_endpoint (GESTimeline * timeline, GSequence * points,
+    GESContainer * container, GstClockTime timecode,
+    GstClockTime * smallest_offset)
 {
   GESTimelinePrivate *priv = timeline->priv;
   GSequenceIter *iter, *end_iter;
-  GESContainer *container = get_toplevel_container (trackelement);
-  GstClockTime *ret = NULL;
-  GstClockTime smallest_offset = G_MAXUINT64;
-  GstClockTime tmp_pos;
+  SourceEndpoint key = { 0, NULL, FALSE, NULL };
+  SourceEndpoint *ret = NULL;
+  GESContainer *last_container = NULL;
+  gboolean last_excluded = FALSE;
 
-  tmp_pos = timecode - priv->snapping_distance;
+  key.time = timecode - priv->snapping_distance;
   /* Rippling, not snapping with previous elements */
   if (priv->movecontext.moving_trackelements)
-    tmp_pos = timecode;
-  iter = g_sequence_search (priv->starts_ends, &tmp_pos,
-      (GCompareDataFunc) compare_uint64, NULL);
+    key.time = timecode;
+  iter = g_sequence_search (points, &key,
+      (GCompareDataFunc) compare_endpoints, NULL);
 
-  tmp_pos = timecode + priv->snapping_distance;
-  end_iter = g_sequence_search (priv->starts_ends, &tmp_pos,
-      (GCompareDataFunc) compare_uint64, NULL);
+  key.time = timecode + priv->snapping_distance;
+  end_iter = g_sequence_search (points, &key,
+      (GCompareDataFunc) compare_endpoints, NULL);
 
   for (; iter != end_iter && !g_sequence_iter_is_end (iter);
       iter = g_sequence_iter_next (iter)) {
-    GstClockTime *iter_tc = g_sequence_get (iter);
-    GESTrackElement *tmp_trackelement =
-        g_hash_table_lookup (priv->by_object, iter_tc);
-    GESContainer *tmp_container = get_toplevel_container (tmp_trackelement);
+    SourceEndpoint *endpoint = g_sequence_get (iter);
     GstClockTimeDiff diff;
 
-    if (tmp_container == container)
-      continue;
+    if (endpoint->source) {
+      GESContainer *tmp_container = get_toplevel_container (endpoint->source);
 
-    if (g_hash_table_lookup (priv->movecontext.toplevel_containers,
-            tmp_container))
-      continue;
+      /* Successive endpoints mostly belong to the same container (the
+       * sources of a clip in each track), only check it once */
+      if (tmp_container != last_container) {
+        last_container = tmp_container;
+        last_excluded = tmp_container == container ||
+            g_hash_table_lookup (priv->movecontext.toplevel_containers,
+            tmp_container);
+      }
 
-    if (timecode > *iter_tc)
-      diff = timecode - *iter_tc;
+      if (last_excluded)
+        continue;
+    }
+
+    if (timecode > endpoint->time)
+      diff = timecode - endpoint->time;
     else
-      diff = *iter_tc - timecode;
+      diff = endpoint->time - timecode;
 
-    if (diff > smallest_offset)
+    if (diff > *smallest_offset)
       break;
 
-    smallest_offset = diff;
-    ret = iter_tc;
+    *smallest_offset = diff;
+    ret = endpoint;
+  }
+
+  return ret;
+}
+
+static SourceEndpoint *
+ges_timeline_snap_position (GESTimeline * timeline,
+    GESTrackElement * trackelement, GstClockTime * current,
+    GstClockTime timecode, gboolean emit)
+{
+  GESContainer *container = get_toplevel_container (trackelement);
+  SourceEndpoint *ret, *point;
+  GstClockTime smallest_offset = G_MAXUINT64, point_offset;
+
+  ret = _find_snapping_endpoint (timeline, timeline->priv->starts_ends,
+      container, timecode, &smallest_offset);
+
+  /* Snapping points only win over sources when strictly closer */
+  point_offset = smallest_offset ? smallest_offset - 1 : 0;
+  if (smallest_offset) {
+    point = _find_snapping_endpoint (timeline, timeline->priv->snapping_points,
+        container, timecode, &point_offset);
+    if (point)
+      ret = point;
   }
 
   /* We emit the snapping signal only if we snapped with a different value
    * than the current one */
   if (emit) {
-    GstClockTime snap_time = ret ? *ret : GST_CLOCK_TIME_NONE;
+    GstClockTime snap_time = ret ? ret->time : GST_CLOCK_TIME_NONE;
 
     if (!timeline->priv->needs_rollback)
       ges_timeline_emit_snappig (timeline, trackelement, ret);
@@ -1430,6 +1879,8 @@ ges_move_context_set_objects (GESTimeline * timeline, GESTrackElement * obj,
               _START (tmptrackelement) - _INPOINT (tmptrackelement));
           mv_ctx->moving_trackelements =
               g_list_prepend (mv_ctx->moving_trackelements, tmptrackelement);
+          g_hash_table_add (mv_ctx->moving_trackelements_set,
+              tmptrackelement);
         }
 
 
@@ -1474,6 +1925,8 @@ ges_move_context_set_objects (GESTimeline * timeline, GESTrackElement * obj,
           mv_ctx->max_trim_pos = MIN (mv_ctx->max_trim_pos, tmpend);
           mv_ctx->moving_trackelements =
               g_list_prepend (mv_ctx->moving_trackelements, tmptrackelement);
+          g_hash_table_add (mv_ctx->moving_trackelements_set,
+              tmptrackelement);
         }
       }
       break;
@@ -1595,7 +2048,8 @@ ges_timeline_trim_object_simple (GESTimeline * timeline,
     GESTimelineElement * element, GList * layers, GESEdge edge,
     guint64 position, gboolean snapping)
 {
-  guint64 start, inpoint, duration, max_duration, *snapped, *cur;
+  guint64 start, inpoint, duration, max_duration, *cur;
+  SourceEndpoint *snapped;
   gboolean ret = TRUE;
   gint64 real_dur;
   GESTrackElement *track_element;
@@ -1651,7 +2105,7 @@ ges_timeline_trim_object_simple (GESTimeline * timeline,
         snapped = ges_timeline_snap_position (timeline, track_element, cur,
             position, TRUE);
         if (snapped)
-          position = *snapped;
+          position = snapped->time;
       }
 
       /* Calculate new values */
@@ -1707,7 +2161,7 @@ ges_timeline_trim_object_simple (GESTimeline * timeline,
       snapped = ges_timeline_snap_position (timeline, track_element, cur,
           position, TRUE);
       if (snapped)
-        position = *snapped;
+        position = snapped->time;
 
       /* Calculate new values */
       real_dur = position - start;
@@ -1731,15 +2185,95 @@ ges_timeline_trim_object_simple (GESTimeline * timeline,
   return ret;
 }
 
+/* Whether rippling moved the point from which elements are moved from
+ * @old_point to @new_point, going over sources that are not part of the move
+ * context. If not, the context can be used for the next edits as is */
+static gboolean
+_ripple_crossed_sources (GESTimeline * timeline, guint64 new_point,
+    guint64 old_point)
+{
+  GSequenceIter *iter;
+  SourceEndpoint key = { 0, NULL, TRUE, NULL };
+  MoveContext *mv_ctx = &timeline->priv->movecontext;
+
+  /* Everything that was before the point still is */
+  if (new_point >= old_point)
+    return FALSE;
+
+  key.time = new_point;
+  iter = g_sequence_search (timeline->priv->starts_ends, &key,
+      (GCompareDataFunc) compare_endpoints, NULL);
+  for (; !g_sequence_iter_is_end (iter); iter = g_sequence_iter_next (iter)) {
+    SourceEndpoint *endpoint = g_sequence_get (iter);
+
+    if (endpoint->time >= old_point)
+      break;
+
+    if (endpoint->is_end || g_hash_table_contains
+        (mv_ctx->moving_trackelements_set, endpoint->source) ||
+        GES_TIMELINE_ELEMENT_PARENT (endpoint->source) ==
+        GES_TIMELINE_ELEMENT (mv_ctx->clip))
+      continue;
+
+    GST_DEBUG_OBJECT (timeline, "Rippled over %" GES_TIMELINE_ELEMENT_FORMAT
+        ", resetting the move context",
+        GES_TIMELINE_ELEMENT_ARGS (endpoint->source));
+
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/* Moves the elements of the move context by @offset, to be done in a
+ * batch so that the elements and the timeline are notified once and the
+ * transitions, priorities and gaps are updated once.
+ *
+ * moving_trackelements is sorted by decreasing start, moving the last
+ * elements first when going forward (and the first ones first when going
+ * backward), the elements never go over each other, so they mostly keep
+ * their place in the sorted sequences tracking them */
+static void
+_ripple_moving_elements (GESTimeline * timeline, gint64 offset,
+    gboolean update_group_offsets)
+{
+  GList *tmp;
+  GESContainer *container;
+  GESTrackElement *trackelement;
+  MoveContext *mv_ctx = &timeline->priv->movecontext;
+  GHashTable *moved_clips = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+  tmp = offset > 0 ? mv_ctx->moving_trackelements :
+      g_list_last (mv_ctx->moving_trackelements);
+  for (; tmp; tmp = offset > 0 ? tmp->next : tmp->prev) {
+    trackelement = GES_TRACK_ELEMENT (tmp->data);
+
+    container = add_toplevel_container (mv_ctx, trackelement);
+    /* Make sure not to move 2 times the same Clip */
+    if (g_hash_table_contains (moved_clips, container))
+      continue;
+
+    if (update_group_offsets && GES_IS_GROUP (container))
+      container->children_control_mode = GES_CHILDREN_UPDATE_OFFSETS;
+    _set_start0 (GES_TIMELINE_ELEMENT (trackelement),
+        _START (trackelement) + offset);
+    if (update_group_offsets && GES_IS_GROUP (container))
+      container->children_control_mode = GES_CHILDREN_UPDATE;
+
+    g_hash_table_add (moved_clips, container);
+  }
+
+  g_hash_table_unref (moved_clips);
+}
+
 gboolean
 timeline_ripple_object (GESTimeline * timeline, GESTrackElement * obj,
     GList * layers, GESEdge edge, guint64 position)
 {
-  GList *tmp, *moved_clips = NULL;
-  GESTrackElement *trackelement;
-  GESContainer *container;
-  guint64 duration, new_start, *snapped, *cur;
+  guint64 duration, *cur;
+  SourceEndpoint *snapped;
   gint64 offset;
+  gboolean needs_move_ctx;
 
   MoveContext *mv_ctx = &timeline->priv->movecontext;
 
@@ -1757,43 +2291,28 @@ timeline_ripple_object (GESTimeline * timeline, GESTrackElement * obj,
       cur = g_hash_table_lookup (timeline->priv->by_end, obj);
       snapped = ges_timeline_snap_position (timeline, obj, cur, position, TRUE);
       if (snapped)
-        position = *snapped;
+        position = snapped->time;
 
       offset = position - _START (obj);
 
-      for (tmp = mv_ctx->moving_trackelements; tmp; tmp = tmp->next) {
-        trackelement = GES_TRACK_ELEMENT (tmp->data);
-        new_start = _START (trackelement) + offset;
-
-        container = add_toplevel_container (mv_ctx, trackelement);
-        /* Make sure not to move 2 times the same Clip */
-        if (g_list_find (moved_clips, container) == NULL) {
-          _set_start0 (GES_TIMELINE_ELEMENT (trackelement), new_start);
-          moved_clips = g_list_prepend (moved_clips, container);
-        }
-
-      }
-      g_list_free (moved_clips);
+      /* Moving the elements ourself does not invalidate the context */
+      needs_move_ctx = mv_ctx->needs_move_ctx;
+      ges_timeline_begin_batch (timeline);
+      _ripple_moving_elements (timeline, offset, FALSE);
       _set_start0 (GES_TIMELINE_ELEMENT (obj), position);
+      ges_timeline_end_batch (timeline);
+
+      if (mv_ctx->start != G_MAXUINT64)
+        mv_ctx->start += offset;
+      mv_ctx->needs_move_ctx = needs_move_ctx ||
+          _ripple_crossed_sources (timeline, position, position - offset);
 
-      moved_clips = NULL;
       if (timeline->priv->needs_rollback && !timeline->priv->rolling_back) {
         timeline->priv->rolling_back = TRUE;
-        for (tmp = mv_ctx->moving_trackelements; tmp; tmp = tmp->next) {
-          trackelement = GES_TRACK_ELEMENT (tmp->data);
-          new_start = _START (trackelement) - offset;
-
-          container = add_toplevel_container (mv_ctx, trackelement);
-          /* Make sure not to move 2 times the same Clip */
-          if (g_list_find (moved_clips, container) == NULL) {
-            _set_start0 (GES_TIMELINE_ELEMENT (trackelement), new_start);
-            moved_clips = g_list_prepend (moved_clips, container);
-          }
-
-        }
-        g_list_free (moved_clips);
-        moved_clips = NULL;
+        ges_timeline_begin_batch (timeline);
+        _ripple_moving_elements (timeline, -offset, FALSE);
         _set_start0 (GES_TIMELINE_ELEMENT (obj), position - offset);
+        ges_timeline_end_batch (timeline);
 
         ges_timeline_emit_snappig (timeline, obj, NULL);
         mv_ctx->needs_move_ctx = TRUE;
@@ -1802,6 +2321,9 @@ timeline_ripple_object (GESTimeline * timeline, GESTrackElement * obj,
         goto error;
       }
 
+      if (offset)
+        g_signal_emit (timeline, ges_timeline_signals[RANGE_SHIFTED], 0,
+            position - offset, offset);
       break;
     case GES_EDGE_END:
       timeline->priv->needs_transitions_update = FALSE;
@@ -1810,10 +2332,11 @@ timeline_ripple_object (GESTimeline * timeline, GESTrackElement * obj,
       cur = g_hash_table_lookup (timeline->priv->by_end, obj);
       snapped = ges_timeline_snap_position (timeline, obj, cur, position, TRUE);
       if (snapped)
-        position = *snapped;
+        position = snapped->time;
 
       duration = _DURATION (obj);
 
+      needs_move_ctx = mv_ctx->needs_move_ctx;
       if (!ges_timeline_trim_object_simple (timeline,
               GES_TIMELINE_ELEMENT (obj), NULL, GES_EDGE_END, position,
               FALSE)) {
@@ -1821,24 +2344,16 @@ timeline_ripple_object (GESTimeline * timeline, GESTrackElement * obj,
       }
 
       offset = _DURATION (obj) - duration;
-      for (tmp = mv_ctx->moving_trackelements; tmp; tmp = tmp->next) {
-        trackelement = GES_TRACK_ELEMENT (tmp->data);
-        new_start = _START (trackelement) + offset;
-
-        container = add_toplevel_container (mv_ctx, trackelement);
-        if (GES_IS_GROUP (container))
-          container->children_control_mode = GES_CHILDREN_UPDATE_OFFSETS;
-        /* Make sure not to move 2 times the same Clip */
-        if (g_list_find (moved_clips, container) == NULL) {
-          _set_start0 (GES_TIMELINE_ELEMENT (trackelement), new_start);
-          moved_clips = g_list_prepend (moved_clips, container);
-        }
-        if (GES_IS_GROUP (container))
-          container->children_control_mode = GES_CHILDREN_UPDATE;
-      }
-
-      g_list_free (moved_clips);
+      ges_timeline_begin_batch (timeline);
+      _ripple_moving_elements (timeline, offset, TRUE);
+      ges_timeline_end_batch (timeline);
+      mv_ctx->needs_move_ctx = needs_move_ctx ||
+          _ripple_crossed_sources (timeline, _END (obj), _END (obj) - offset);
       timeline->priv->needs_transitions_update = TRUE;
+
+      if (offset)
+        g_signal_emit (timeline, ges_timeline_signals[RANGE_SHIFTED], 0,
+            _END (obj) - offset, offset);
       GST_DEBUG ("Done Rippling end");
       break;
     case GES_EDGE_START:
@@ -1920,7 +2435,8 @@ timeline_roll_object (GESTimeline * timeline, GESTrackElement * obj,
     GList * layers, GESEdge edge, guint64 position)
 {
   MoveContext *mv_ctx = &timeline->priv->movecontext;
-  guint64 start, duration, end, tmpstart, tmpduration, tmpend, *snapped, *cur;
+  guint64 start, duration, end, tmpstart, tmpduration, tmpend, *cur;
+  SourceEndpoint *snapped;
   gboolean ret = TRUE;
   GList *tmp;
 
@@ -1949,7 +2465,7 @@ timeline_roll_object (GESTimeline * timeline, GESTrackElement * obj,
       cur = g_hash_table_lookup (timeline->priv->by_start, obj);
       snapped = ges_timeline_snap_position (timeline, obj, cur, position, TRUE);
       if (snapped)
-        position = *snapped;
+        position = snapped->time;
 
       ret &= ges_timeline_trim_object_simple (timeline,
           GES_TIMELINE_ELEMENT (obj), layers, GES_EDGE_START, position, FALSE);
@@ -1994,7 +2510,7 @@ timeline_roll_object (GESTimeline * timeline, GESTrackElement * obj,
       cur = g_hash_table_lookup (timeline->priv->by_end, obj);
       snapped = ges_timeline_snap_position (timeline, obj, cur, position, TRUE);
       if (snapped)
-        position = *snapped;
+        position = snapped->time;
 
       ret &= ges_timeline_trim_object_simple (timeline,
           GES_TIMELINE_ELEMENT (obj), NULL, GES_EDGE_END, position, FALSE);
@@ -2065,14 +2581,16 @@ ges_timeline_move_object_simple (GESTimeline * timeline,
     guint64 position)
 {
   GstClockTime cpos = GES_TIMELINE_ELEMENT_START (element);
-  guint64 *snap_end, *snap_st, *cur, position_offset, off1, off2, top_end;
+  guint64 *cur, position_offset, off1, off2, top_end;
+  SourceEndpoint *snap_end, *snap_st;
   GESTrackElement *track_element;
   GESContainer *toplevel;
 
   /* We only work with GESSource-s and we check that we are not already moving
    * the specified element ourself */
   if (GES_IS_SOURCE (element) == FALSE ||
-      g_list_find (timeline->priv->movecontext.moving_trackelements, element))
+      g_hash_table_contains (timeline->priv->movecontext.
+          moving_trackelements_set, element))
     return FALSE;
 
   timeline->priv->needs_rollback = FALSE;
@@ -2090,7 +2608,8 @@ ges_timeline_move_object_simple (GESTimeline * timeline,
   snap_end = ges_timeline_snap_position (timeline, track_element, cur, top_end,
       FALSE);
   if (snap_end)
-    off1 = top_end > *snap_end ? top_end - *snap_end : *snap_end - top_end;
+    off1 = top_end > snap_end->time ? top_end - snap_end->time :
+        snap_end->time - top_end;
   else
     off1 = G_MAXUINT64;
 
@@ -2099,16 +2618,17 @@ ges_timeline_move_object_simple (GESTimeline * timeline,
       ges_timeline_snap_position (timeline, track_element, cur, position,
       FALSE);
   if (snap_st)
-    off2 = position > *snap_st ? position - *snap_st : *snap_st - position;
+    off2 = position > snap_st->time ? position - snap_st->time :
+        snap_st->time - position;
   else
     off2 = G_MAXUINT64;
 
   /* In the case we could snap on both sides, we snap on the end */
   if (snap_end && off1 <= off2) {
-    position = position + *snap_end - top_end;
+    position = position + snap_end->time - top_end;
     ges_timeline_emit_snappig (timeline, track_element, snap_end);
   } else if (snap_st) {
-    position = position + *snap_st - position;
+    position = position + snap_st->time - position;
     ges_timeline_emit_snappig (timeline, track_element, snap_st);
   } else
     ges_timeline_emit_snappig (timeline, track_element, NULL);
@@ -2311,7 +2831,7 @@ layer_auto_transition_changed_cb (GESLayer * layer,
 
   timeline->priv->needs_rollback = FALSE;
   _create_transitions_on_layer (timeline, layer, NULL, NULL,
-      _create_auto_transition_from_transitions);
+      _create_auto_transition_from_transitions, 0, GST_CLOCK_TIME_NONE);
 
   clips = ges_layer_get_clips (layer);
   for (tmp = clips; tmp; tmp = tmp->next) {
@@ -2518,11 +3038,25 @@ layer_object_added_cb (GESLayer * layer, GESClip * clip, GESTimeline * timeline)
         "TrackElement", clip);
     timeline->priv->movecontext.needs_move_ctx = TRUE;
     _create_transitions_on_layer (timeline, layer, NULL, NULL,
-        _find_transition_from_auto_transitions);
+        _find_transition_from_auto_transitions, 0, GST_CLOCK_TIME_NONE);
     return;
   }
 
+  if (timeline->priv->preview_scale != 1.0) {
+    GESAsset *asset = ges_extractable_get_asset (GES_EXTRACTABLE (clip));
 
+    /* The project references the original asset, the clip is added back
+     * with its proxy while being switched to it */
+    project =
+        GES_PROJECT (ges_extractable_get_asset (GES_EXTRACTABLE (timeline)));
+    ges_project_add_asset (project, asset);
+    if (_proxy_clip (timeline, clip))
+      return;
+  }
+
+
+  /* Clips without any TrackElement need their priorities resynced too */
+  _mark_layer_dirty (timeline, layer, _START (clip), _END (clip));
   add_object_to_tracks (timeline, clip, NULL);
 
   GST_DEBUG ("Making sure that the asset is in our project");
@@ -2559,6 +3093,8 @@ layer_object_removed_cb (GESLayer * layer, GESClip * clip,
 
   GST_DEBUG ("Clip %p removed from layer %p", clip, layer);
 
+  g_hash_table_remove (timeline->priv->proxied_clips, clip);
+
   /* Go over the clip's track element and figure out which one belongs to
    * the list of tracks we control */
 
@@ -2601,8 +3137,9 @@ trackelement_start_changed_cb (GESTrackElement * child,
   GESTimelinePrivate *priv = timeline->priv;
   TrackObjIters *iters = g_hash_table_lookup (priv->obj_iters, child);
 
+  _mark_track_element_dirty (timeline, child, iters->layer);
   if (G_LIKELY (iters->iter_by_layer))
-    g_sequence_sort_changed (iters->iter_by_layer,
+    _ges_sequence_sort_changed (iters->iter_by_layer,
         (GCompareDataFunc) element_start_compare, NULL);
 
   if (GES_IS_SOURCE (child)) {
@@ -2635,6 +3172,10 @@ trackelement_priority_changed_cb (GESTrackElement * child,
   TrackObjIters *iters = g_hash_table_lookup (priv->obj_iters,
       child);
 
+  _mark_track_element_dirty (timeline, child, iters->layer);
+  if (layer != iters->layer)
+    _mark_track_element_dirty (timeline, child, layer);
+
   if (G_UNLIKELY (layer == NULL)) {
     GST_ERROR_OBJECT (timeline,
         "Changing a TrackElement prio, which would not "
@@ -2643,6 +3184,7 @@ trackelement_priority_changed_cb (GESTrackElement * child,
       g_sequence_remove (iters->iter_by_layer);
     iters->iter_by_layer = NULL;
     iters->layer = NULL;
+    _untrack_source_endpoints (iters);
   } else {
     /* If it moves from layer, properly change it */
     if (layer != iters->layer) {
@@ -2659,8 +3201,13 @@ trackelement_priority_changed_cb (GESTrackElement * child,
           g_sequence_insert_sorted (by_layer_sequence, child,
           (GCompareDataFunc) element_start_compare, NULL);
       iters->layer = layer;
+
+      if (GES_IS_SOURCE (child)) {
+        _untrack_source_endpoints (iters);
+        _track_source_endpoints (timeline, iters);
+      }
     } else {
-      g_sequence_sort_changed (iters->iter_by_layer,
+      _ges_sequence_sort_changed (iters->iter_by_layer,
           (GCompareDataFunc) element_start_compare, NULL);
     }
   }
@@ -2676,6 +3223,7 @@ trackelement_duration_changed_cb (GESTrackElement * child,
   GESTimelinePrivate *priv = timeline->priv;
   TrackObjIters *iters = g_hash_table_lookup (priv->obj_iters, child);
 
+  _mark_track_element_dirty (timeline, child, iters->layer);
   if (GES_IS_SOURCE (child)) {
     sort_starts_ends_end (timeline, iters);
 
@@ -2697,14 +3245,15 @@ track_element_added_cb (GESTrack * track, GESTrackElement * track_element,
     GESTimeline * timeline)
 {
   /* Auto transition should be updated before we receive the signal */
-  g_signal_connect_after (GES_TRACK_ELEMENT (track_element), "notify::start",
-      G_CALLBACK (trackelement_start_changed_cb), timeline);
   g_signal_connect_after (GES_TRACK_ELEMENT (track_element),
-      "notify::duration", G_CALLBACK (trackelement_duration_changed_cb),
+      "internal-notify::start", G_CALLBACK (trackelement_start_changed_cb),
       timeline);
   g_signal_connect_after (GES_TRACK_ELEMENT (track_element),
-      "notify::priority", G_CALLBACK (trackelement_priority_changed_cb),
-      timeline);
+      "internal-notify::duration",
+      G_CALLBACK (trackelement_duration_changed_cb), timeline);
+  g_signal_connect_after (GES_TRACK_ELEMENT (track_element),
+      "internal-notify::priority",
+      G_CALLBACK (trackelement_priority_changed_cb), timeline);
 
   start_tracking_track_element (timeline, track_element);
 }
@@ -2828,6 +3377,29 @@ timeline_remove_element (GESTimeline * timeline, GESTimelineElement * element)
   return g_hash_table_remove (timeline->priv->all_elements, element->name);
 }
 
+gboolean
+timeline_is_batching (GESTimeline * timeline)
+{
+  return timeline && timeline->priv->batch_depth > 0;
+}
+
+void
+timeline_freeze_element_notify (GESTimeline * timeline,
+    GESTimelineElement * element)
+{
+  ges_timeline_element_freeze_notify (element);
+  timeline->priv->frozen_elements =
+      g_list_prepend (timeline->priv->frozen_elements,
+      gst_object_ref (element));
+}
+
+void
+timeline_queue_auto_transition_update (GESTimeline * timeline,
+    GESAutoTransition * auto_transition)
+{
+  g_hash_table_add (timeline->priv->pending_auto_transitions, auto_transition);
+}
+
 void
 timeline_fill_gaps (GESTimeline * timeline)
 {
@@ -3086,6 +3658,9 @@ gboolean
 ges_timeline_remove_layer (GESTimeline * timeline, GESLayer * layer)
 {
   GList *layer_objects, *tmp;
+  GHashTable *by_track;
+  GHashTableIter iter;
+  gpointer endpoints;
 
   GST_DEBUG ("timeline:%p, layer:%p", timeline, layer);
 
@@ -3115,6 +3690,14 @@ ges_timeline_remove_layer (GESTimeline * timeline, GESLayer * layer)
       layer_auto_transition_changed_cb, timeline);
 
   g_hash_table_remove (timeline->priv->by_layer, layer);
+  by_track = g_hash_table_lookup (timeline->priv->endpoints, layer);
+  if (by_track) {
+    g_hash_table_iter_init (&iter, by_track);
+    while (g_hash_table_iter_next (&iter, NULL, &endpoints))
+      _forget_endpoints (timeline, endpoints);
+    g_hash_table_remove (timeline->priv->endpoints, layer);
+  }
+  g_hash_table_remove (timeline->priv->dirty_layers, layer);
   timeline->layers = g_list_remove (timeline->layers, layer);
   ges_layer_set_timeline (layer, NULL);
 
@@ -3175,6 +3758,8 @@ ges_timeline_add_track (GESTimeline * timeline, GESTrack * track)
 
   /* Inform the track that it's currently being used by ourself */
   ges_track_set_timeline (track, timeline);
+  if (track->type == GES_TRACK_TYPE_VIDEO)
+    ges_track_set_preview_scale (track, timeline->priv->preview_scale);
 
   GST_DEBUG ("Done adding track, emitting 'track-added' signal");
 
@@ -3235,6 +3820,8 @@ ges_timeline_remove_track (GESTimeline * timeline, GESTrack * track)
   GList *tmp;
   TrackPrivate *tr_priv;
   GESTimelinePrivate *priv;
+  GHashTableIter iter;
+  gpointer by_track;
 
   g_return_val_if_fail (GES_IS_TRACK (track), FALSE);
   g_return_val_if_fail (GES_IS_TIMELINE (timeline), FALSE);
@@ -3272,6 +3859,17 @@ ges_timeline_remove_track (GESTimeline * timeline, GESTrack * track)
   g_signal_handlers_disconnect_by_func (track, track_element_removed_cb,
       timeline);
 
+  /* Elements of that track are not followed anymore */
+  g_hash_table_iter_init (&iter, priv->endpoints);
+  while (g_hash_table_iter_next (&iter, NULL, &by_track)) {
+    GSequence *endpoints = g_hash_table_lookup (by_track, track);
+
+    if (endpoints) {
+      _forget_endpoints (timeline, endpoints);
+      g_hash_table_remove (by_track, track);
+    }
+  }
+
   /* Signal track removal to all layers/objects */
   g_signal_emit (timeline, ges_timeline_signals[TRACK_REMOVED], 0, track);
 
@@ -3411,6 +4009,38 @@ track_commited_cb (GESTrack * track, GESTimeline * timeline)
   }
 }
 
+/* Creates the transitions and resyncs the priorities of what changed in the
+ * layers since the last time they were updated */
+static void
+_update_dirty_layers (GESTimeline * timeline)
+{
+  GHashTableIter iter;
+  GESLayer *layer;
+  DirtyRange *range;
+  GHashTable *dirty_layers = timeline->priv->dirty_layers;
+
+  /* Creating transitions and resyncing priorities marks the layers dirty
+   * again, that is already taken care of here */
+  timeline->priv->dirty_layers =
+      g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+      (GDestroyNotify) _destroy_dirty_range);
+  g_hash_table_iter_init (&iter, dirty_layers);
+  while (g_hash_table_iter_next (&iter, (gpointer *) & layer,
+          (gpointer *) & range)) {
+    GST_DEBUG_OBJECT (timeline, "Updating %" GST_PTR_FORMAT " from %"
+        GST_TIME_FORMAT " to %" GST_TIME_FORMAT, layer,
+        GST_TIME_ARGS (range->start), GST_TIME_ARGS (range->end));
+
+    _create_transitions_on_layer (timeline, layer, NULL, NULL,
+        _find_transition_from_auto_transitions, range->start, range->end);
+
+    /* Ensure clip priorities are correct after an edit */
+    ges_layer_resync_priorities (layer);
+  }
+  g_hash_table_unref (dirty_layers);
+  g_hash_table_remove_all (timeline->priv->dirty_layers);
+}
+
 /* Must be called with the timeline's DYN_LOCK */
 static gboolean
 ges_timeline_commit_unlocked (GESTimeline * timeline)
@@ -3420,15 +4050,7 @@ ges_timeline_commit_unlocked (GESTimeline * timeline)
 
   GST_DEBUG_OBJECT (timeline, "commiting changes");
 
-  for (tmp = timeline->layers; tmp; tmp = tmp->next) {
-    GESLayer *layer = tmp->data;
-
-    _create_transitions_on_layer (timeline, layer, NULL, NULL,
-        _find_transition_from_auto_transitions);
-
-    /* Ensure clip priorities are correct after an edit */
-    ges_layer_resync_priorities (layer);
-  }
+  _update_dirty_layers (timeline);
 
   timeline->priv->expected_commited =
       g_list_length (timeline->priv->priv_tracks);
@@ -3496,6 +4118,7 @@ static void
 commited_cb (GESTimeline * timeline)
 {
   g_mutex_lock (&timeline->priv->commited_lock);
+  timeline->priv->commited = TRUE;
   g_cond_signal (&timeline->priv->commited_cond);
   g_mutex_unlock (&timeline->priv->commited_lock);
 }
@@ -3527,9 +4150,11 @@ ges_timeline_commit_sync (GESTimeline * timeline)
   gboolean ret;
   gboolean wait_for_signal;
 
-  /* Let's make sure our state is stable */
-  gst_element_get_state (GST_ELEMENT (timeline), NULL, NULL,
-      GST_CLOCK_TIME_NONE);
+  /* Let's make sure our state is stable, meanwhile the compositions might
+   * be waiting for us to create the elements of their sources */
+  while (gst_element_get_state (GST_ELEMENT (timeline), NULL, NULL,
+          10 * GST_MSECOND) == GST_STATE_CHANGE_ASYNC)
+    ges_track_element_handle_pending_requests ();
 
   /* Let's make sure no track gets added between now and the actual commiting */
   LOCK_DYN (timeline);
@@ -3543,10 +4168,20 @@ ges_timeline_commit_sync (GESTimeline * timeline)
         g_signal_connect (timeline, "commited", (GCallback) commited_cb, NULL);
 
     g_mutex_lock (&timeline->priv->commited_lock);
+    timeline->priv->commited = FALSE;
 
     ret = ges_timeline_commit_unlocked (timeline);
-    g_cond_wait (&timeline->priv->commited_cond,
-        &timeline->priv->commited_lock);
+    while (!timeline->priv->commited) {
+      gint64 end_time = g_get_monotonic_time () + 10 * G_TIME_SPAN_MILLISECOND;
+
+      if (g_cond_wait_until (&timeline->priv->commited_cond,
+              &timeline->priv->commited_lock, end_time))
+        continue;
+
+      g_mutex_unlock (&timeline->priv->commited_lock);
+      ges_track_element_handle_pending_requests ();
+      g_mutex_lock (&timeline->priv->commited_lock);
+    }
     g_mutex_unlock (&timeline->priv->commited_lock);
     g_signal_handler_disconnect (timeline, handler_id);
   }
@@ -3556,6 +4191,85 @@ ges_timeline_commit_sync (GESTimeline * timeline)
   return ret;
 }
 
+/**
+ * ges_timeline_begin_batch:
+ * @timeline: a #GESTimeline
+ *
+ * Starts a batch of changes on @timeline, typically adding many clips at
+ * once or moving many elements around. Until the batch is closed with
+ * #ges_timeline_end_batch:
+ *
+ *  - the priorities of the clips are not resynced,
+ *  - the auto transitions are neither created nor moved along their
+ *    neighbours,
+ *  - the gaps of the tracks are not updated,
+ *  - the property notifications of @timeline itself are held back, each
+ *    changed property being notified once,
+ *  - the notifications of the #GESTimelineElement:start,
+ *    #GESTimelineElement:in-point, #GESTimelineElement:duration and
+ *    #GESTimelineElement:priority of the elements of @timeline are held
+ *    back the same way, each element notifying each of those properties
+ *    at most once.
+ *
+ * All of that is done once when the batch ends, only for what changed.
+ *
+ * Batches can be nested, the work is done when the outermost one ends.
+ */
+void
+ges_timeline_begin_batch (GESTimeline * timeline)
+{
+  g_return_if_fail (GES_IS_TIMELINE (timeline));
+
+  if (timeline->priv->batch_depth++ == 0)
+    g_object_freeze_notify (G_OBJECT (timeline));
+
+  GST_DEBUG_OBJECT (timeline, "Beginning batch (depth %u)",
+      timeline->priv->batch_depth);
+}
+
+/**
+ * ges_timeline_end_batch:
+ * @timeline: a #GESTimeline
+ *
+ * Ends a batch of changes started with #ges_timeline_begin_batch. When the
+ * outermost batch ends, the auto transitions are updated, the clip
+ * priorities resynced, the gaps of the tracks updated and the held back
+ * notifications of the elements of @timeline, then of @timeline itself,
+ * emitted.
+ */
+void
+ges_timeline_end_batch (GESTimeline * timeline)
+{
+  GHashTableIter iter;
+  GESAutoTransition *auto_transition;
+  GESTimelinePrivate *priv;
+
+  g_return_if_fail (GES_IS_TIMELINE (timeline));
+  g_return_if_fail (timeline->priv->batch_depth > 0);
+
+  priv = timeline->priv;
+  priv->batch_depth--;
+  GST_DEBUG_OBJECT (timeline, "Ending batch (depth %u)", priv->batch_depth);
+
+  if (priv->batch_depth)
+    return;
+
+  /* Updating a transition can destroy others, pick them one at a time */
+  while (g_hash_table_size (priv->pending_auto_transitions)) {
+    g_hash_table_iter_init (&iter, priv->pending_auto_transitions);
+    g_hash_table_iter_next (&iter, (gpointer *) & auto_transition, NULL);
+    g_hash_table_iter_remove (&iter);
+
+    ges_auto_transition_update (auto_transition);
+  }
+
+  _update_dirty_layers (timeline);
+  timeline_fill_gaps (timeline);
+
+  _thaw_frozen_elements (timeline);
+  g_object_thaw_notify (G_OBJECT (timeline));
+}
+
 /**
  * ges_timeline_get_duration:
  * @timeline: a #GESTimeline
@@ -3652,6 +4366,224 @@ ges_timeline_set_snapping_distance (GESTimeline * timeline,
   timeline->priv->snapping_distance = snapping_distance;
 }
 
+/**
+ * ges_timeline_get_preview_scale:
+ * @timeline: a #GESTimeline
+ *
+ * Gets the preview scale of the timeline, see
+ * ges_timeline_set_preview_scale().
+ *
+ * Returns: The #GESTimeline:preview-scale of @timeline
+ */
+gdouble
+ges_timeline_get_preview_scale (GESTimeline * timeline)
+{
+  g_return_val_if_fail (GES_IS_TIMELINE (timeline), 1.0);
+
+  return timeline->priv->preview_scale;
+}
+
+static void
+_swap_clip_asset (GESTimeline * timeline, GESClip * clip, GESAsset * asset)
+{
+  GST_INFO_OBJECT (timeline, "Swapping %s for %s in %s",
+      ges_extractable_get_id (GES_EXTRACTABLE (clip)), ges_asset_get_id (asset),
+      GES_TIMELINE_ELEMENT_NAME (clip));
+  if (!ges_extractable_set_asset (GES_EXTRACTABLE (clip), asset))
+    GST_ERROR_OBJECT (timeline, "Could not set %s on %s",
+        ges_asset_get_id (asset), GES_TIMELINE_ELEMENT_NAME (clip));
+}
+
+/* Switches @clip to the proxy of its asset, if any, remembering its
+ * original asset. Returns whether @clip was switched */
+static gboolean
+_proxy_clip (GESTimeline * timeline, GESClip * clip)
+{
+  GESAsset *asset, *proxy;
+
+  if (!GES_IS_URI_CLIP (clip))
+    return FALSE;
+
+  asset = ges_extractable_get_asset (GES_EXTRACTABLE (clip));
+  proxy = ges_asset_get_proxy (asset);
+  if (!proxy || !GES_IS_URI_CLIP_ASSET (proxy))
+    return FALSE;
+
+  /* Setting the asset removes @clip from its layer and adds it back, only
+   * remember it afterward as being removed drops it from proxied_clips */
+  gst_object_ref (asset);
+  _swap_clip_asset (timeline, clip, proxy);
+  g_hash_table_insert (timeline->priv->proxied_clips, gst_object_ref (clip),
+      asset);
+
+  return TRUE;
+}
+
+static void
+_use_proxies (GESTimeline * timeline)
+{
+  GList *tmp, *clips, *clip;
+
+  for (tmp = timeline->layers; tmp; tmp = tmp->next) {
+    clips = ges_layer_get_clips (tmp->data);
+    for (clip = clips; clip; clip = clip->next)
+      _proxy_clip (timeline, clip->data);
+    g_list_free_full (clips, gst_object_unref);
+  }
+}
+
+/* Switches the clips _proxy_clip() switched back to their original asset */
+static void
+_restore_proxied_clips (GESTimeline * timeline)
+{
+  GESClip *clip;
+  GESAsset *asset;
+  GHashTableIter iter;
+  GHashTable *proxied_clips = timeline->priv->proxied_clips;
+
+  /* Swapping the assets removes the clips from their layer and adds them
+   * back, which would change proxied_clips while iterating it */
+  timeline->priv->proxied_clips =
+      g_hash_table_new_full (g_direct_hash, g_direct_equal, gst_object_unref,
+      gst_object_unref);
+
+  g_hash_table_iter_init (&iter, proxied_clips);
+  while (g_hash_table_iter_next (&iter, (gpointer *) & clip,
+          (gpointer *) & asset))
+    _swap_clip_asset (timeline, clip, asset);
+  g_hash_table_unref (proxied_clips);
+}
+
+/* Only used by the formatters, so that the clips using a proxy because of
+ * the preview scale are saved with their original asset */
+GESAsset *
+timeline_get_clip_original_asset (GESTimeline * timeline, GESClip * clip)
+{
+  return g_hash_table_lookup (timeline->priv->proxied_clips, clip);
+}
+
+/**
+ * ges_timeline_set_preview_scale:
+ * @timeline: a #GESTimeline
+ * @scale: The factor to apply to the video size, in ]0, 1]
+ *
+ * Sets a factor to apply to the video size of the tracks of @timeline,
+ * their restriction caps, the position and size of the sources and the
+ * output of the mixer being scaled accordingly, so that previewing is
+ * cheaper. Properties keep being expressed in full resolution.
+ *
+ * When @scale is lower than 1.0, the #GESUriClip-s whose asset has a
+ * proxy (see ges_asset_set_proxy()) are switched to it, including the ones
+ * added meanwhile, and switched back to their original asset when @scale
+ * goes back to 1.0. A clip removed from @timeline meanwhile keeps using
+ * the proxy. The timeline needs to be committed for the change to take
+ * effect.
+ *
+ * GES does not generate the proxies: without any proxy set by the
+ * application, only the video size is scaled and the sources keep being
+ * decoded in full resolution.
+ *
+ * Saving @timeline meanwhile saves the original assets of those clips,
+ * while a #GESPipeline refuses to render it until @scale is back to 1.0.
+ */
+void
+ges_timeline_set_preview_scale (GESTimeline * timeline, gdouble scale)
+{
+  GList *tmp;
+  gboolean was_scaled;
+
+  g_return_if_fail (GES_IS_TIMELINE (timeline));
+  g_return_if_fail (scale > 0.0 && scale <= 1.0);
+
+  if (timeline->priv->preview_scale == scale)
+    return;
+
+  was_scaled = timeline->priv->preview_scale != 1.0;
+  timeline->priv->preview_scale = scale;
+
+  ges_timeline_begin_batch (timeline);
+  if (!was_scaled)
+    _use_proxies (timeline);
+  else if (scale == 1.0)
+    _restore_proxied_clips (timeline);
+
+  for (tmp = timeline->tracks; tmp; tmp = tmp->next) {
+    if (GES_TRACK (tmp->data)->type == GES_TRACK_TYPE_VIDEO)
+      ges_track_set_preview_scale (tmp->data, scale);
+  }
+  ges_timeline_end_batch (timeline);
+
+  g_object_notify_by_pspec (G_OBJECT (timeline),
+      properties[PROP_PREVIEW_SCALE]);
+}
+
+/**
+ * ges_timeline_add_snapping_point:
+ * @timeline: a #GESTimeline
+ * @position: The position to add
+ *
+ * Adds a position, other than the edges of the sources, to which
+ * moved and trimmed elements will snap, such as the playhead or
+ * a marker. The same @position can be added several times, in which
+ * case it needs to be removed as many times.
+ *
+ * When snapping to such a point, the second #GESTrackElement passed to
+ * the #GESTimeline::snapping-started and #GESTimeline::snapping-ended
+ * signals is %NULL.
+ */
+void
+ges_timeline_add_snapping_point (GESTimeline * timeline, GstClockTime position)
+{
+  SourceEndpoint *point;
+
+  g_return_if_fail (GES_IS_TIMELINE (timeline));
+  g_return_if_fail (GST_CLOCK_TIME_IS_VALID (position));
+
+  point = g_slice_new0 (SourceEndpoint);
+  point->time = position;
+  g_sequence_insert_sorted (timeline->priv->snapping_points, point,
+      (GCompareDataFunc) compare_endpoints, NULL);
+}
+
+/**
+ * ges_timeline_remove_snapping_point:
+ * @timeline: a #GESTimeline
+ * @position: The position to remove
+ *
+ * Removes a position added with #ges_timeline_add_snapping_point.
+ *
+ * Returns: %TRUE if @position was a snapping point of @timeline,
+ * %FALSE otherwise
+ */
+gboolean
+ges_timeline_remove_snapping_point (GESTimeline * timeline,
+    GstClockTime position)
+{
+  GSequenceIter *iter;
+  SourceEndpoint key = { 0, NULL, FALSE, NULL };
+  MoveContext *mv_ctx;
+
+  g_return_val_if_fail (GES_IS_TIMELINE (timeline), FALSE);
+
+  key.time = position;
+  iter = g_sequence_lookup (timeline->priv->snapping_points, &key,
+      (GCompareDataFunc) compare_endpoints, NULL);
+  if (!iter)
+    return FALSE;
+
+  /* Do not keep a pointer to the freed point in the snapping context */
+  mv_ctx = &timeline->priv->movecontext;
+  if (mv_ctx->last_snap_ts == &((SourceEndpoint *) g_sequence_get (iter))->time) {
+    mv_ctx->last_snap_ts = NULL;
+    mv_ctx->last_snaped1 = NULL;
+    mv_ctx->last_snaped2 = NULL;
+  }
+
+  g_sequence_remove (iter);
+
+  return TRUE;
+}
+
 /**
  * ges_timeline_get_element:
  * @timeline: a #GESTimeline
@@ -142,6 +142,10 @@ GES_API
 gboolean ges_timeline_commit (GESTimeline * timeline);
 GES_API
 gboolean ges_timeline_commit_sync (GESTimeline * timeline);
+GES_API
+void ges_timeline_begin_batch (GESTimeline * timeline);
+GES_API
+void ges_timeline_end_batch (GESTimeline * timeline);
 
 GES_API
 GstClockTime ges_timeline_get_duration (GESTimeline *timeline);
@@ -155,6 +159,14 @@ GstClockTime ges_timeline_get_snapping_distance (GESTimeline * timeline);
 GES_API
 void ges_timeline_set_snapping_distance (GESTimeline * timeline, GstClockTime snapping_distance);
 GES_API
+gdouble ges_timeline_get_preview_scale (GESTimeline * timeline);
+GES_API
+void ges_timeline_set_preview_scale (GESTimeline * timeline, gdouble scale);
+GES_API
+void ges_timeline_add_snapping_point (GESTimeline * timeline, GstClockTime position);
+GES_API
+gboolean ges_timeline_remove_snapping_point (GESTimeline * timeline, GstClockTime position);
+GES_API
 GESTimelineElement * ges_timeline_get_element (GESTimeline * timeline, const gchar *name);
 GES_API
 gboolean ges_timeline_is_empty (GESTimeline * timeline);
@@ -35,6 +35,7 @@
 #include "ges-track-element.h"
 #include "ges-clip.h"
 #include "ges-meta-container.h"
+#include "ges-source.h"
 
 G_DEFINE_ABSTRACT_TYPE (GESTrackElement, ges_track_element,
     GES_TYPE_TIMELINE_ELEMENT);
@@ -53,8 +54,45 @@ struct _GESTrackElementPrivate
 
   GHashTable *bindings_hashtable;       /* We need this if we want to be able to serialize
                                            and deserialize keyframes */
+
+  /* {GstControlBinding: ControlSourceWindow} for the bindings using a
+   * GstTimedValueControlSource */
+  GHashTable *control_source_windows;
+
+  /* TRUE when @element is created on demand, see
+   * GESTrackElementClass.ABI.abi.element_on_demand. It is created in the
+   * main thread when the composition asks for it, see
+   * _queue_element_request(), and detached from the composition thread
+   * when released, @released_element then waits for the main thread to
+   * save its children properties values in @pending_children_props
+   * ({GParamSpec: GValue}). While there is no element, the children
+   * properties are mapped to @children_placeholder, see
+   * _add_placeholder_children_props(), and the values set on them are
+   * kept in @pending_children_props too. @element_lock protects all of
+   * them */
+  gboolean element_on_demand;
+  GRecMutex element_lock;
+  GstElement *released_element;
+  GHashTable *pending_children_props;
+  GObject *children_placeholder;
 };
 
+/* Keeps track of how the keyframes of a control source were fitted in the
+ * inpoint/duration window of the element */
+typedef struct
+{
+  GstTimedValueControlSource *source;
+  gboolean absolute;
+
+  /* Keyframes that are out of the window, sorted by timestamp */
+  GSequence *hidden_before;
+  GSequence *hidden_after;
+
+  /* Keyframes we created at the window boundaries, or GST_CLOCK_TIME_NONE */
+  GstClockTime start_keyframe;
+  GstClockTime end_keyframe;
+} ControlSourceWindow;
+
 enum
 {
   PROP_0,
@@ -92,6 +130,7 @@ static GParamSpec **default_list_children_properties (GESTrackElement * object,
 static void
 _update_control_bindings (GESTimelineElement * element, GstClockTime inpoint,
     GstClockTime duration);
+static void _control_source_window_free (ControlSourceWindow * window);
 
 static gboolean
 _lookup_child (GESTrackElement * object,
@@ -102,6 +141,17 @@ _lookup_child (GESTrackElement * object,
       (GES_TIMELINE_ELEMENT (object), prop_name, (GObject **) element, pspec);
 }
 
+static GstElement *_ensure_element (GESTrackElement * self);
+static void _save_released_children_props (GESTrackElement * self);
+
+/* {GType: GPtrArray of GParamSpec} the children properties of the
+ * elements created on demand, recorded when the first element of each
+ * class gets created */
+static GMutex children_pspecs_lock;
+static GHashTable *children_pspecs = NULL;
+
+static GQuark children_placeholder_quark;
+
 static gboolean
 strv_find_str (const gchar ** strv, const char *str)
 {
@@ -165,6 +215,7 @@ ges_track_element_dispose (GObject * object)
 
   if (priv->bindings_hashtable)
     g_hash_table_destroy (priv->bindings_hashtable);
+  g_clear_pointer (&priv->control_source_windows, g_hash_table_unref);
 
   if (priv->nleobject) {
     GstState cstate;
@@ -181,15 +232,37 @@ ges_track_element_dispose (GObject * object)
         gst_element_set_state (priv->nleobject, GST_STATE_NULL);
     }
 
+    g_signal_handlers_disconnect_by_data (priv->nleobject, element);
     g_object_set_qdata (G_OBJECT (priv->nleobject),
         NLE_OBJECT_TRACK_ELEMENT_QUARK, NULL);
     gst_object_unref (priv->nleobject);
     priv->nleobject = NULL;
   }
 
+  g_clear_pointer (&priv->pending_children_props, g_hash_table_unref);
+  if (priv->released_element) {
+    gst_object_unref (priv->released_element);
+    priv->released_element = NULL;
+  }
+  if (priv->children_placeholder) {
+    g_object_set_qdata (priv->children_placeholder,
+        children_placeholder_quark, NULL);
+    g_clear_object (&priv->children_placeholder);
+  }
+
   G_OBJECT_CLASS (ges_track_element_parent_class)->dispose (object);
 }
 
+static void
+ges_track_element_finalize (GObject * object)
+{
+  GESTrackElement *element = GES_TRACK_ELEMENT (object);
+
+  g_rec_mutex_clear (&element->priv->element_lock);
+
+  G_OBJECT_CLASS (ges_track_element_parent_class)->finalize (object);
+}
+
 static void
 ges_track_element_constructed (GObject * gobject)
 {
@@ -250,6 +323,7 @@ ges_track_element_class_init (GESTrackElementClass * klass)
   object_class->get_property = ges_track_element_get_property;
   object_class->set_property = ges_track_element_set_property;
   object_class->dispose = ges_track_element_dispose;
+  object_class->finalize = ges_track_element_finalize;
   object_class->constructed = ges_track_element_constructed;
 
 
@@ -312,6 +386,9 @@ ges_track_element_class_init (GESTrackElementClass * klass)
   klass->create_gnl_object = ges_track_element_create_gnl_object_func;
   klass->list_children_properties = default_list_children_properties;
   klass->lookup_child = _lookup_child;
+
+  children_placeholder_quark =
+      g_quark_from_static_string ("ges-track-element-children-placeholder");
 }
 
 static void
@@ -329,6 +406,9 @@ ges_track_element_init (GESTrackElement * self)
 
   priv->bindings_hashtable = g_hash_table_new_full (g_str_hash, g_str_equal,
       g_free, NULL);
+  priv->control_source_windows = g_hash_table_new_full (NULL, NULL, NULL,
+      (GDestroyNotify) _control_source_window_free);
+  g_rec_mutex_init (&priv->element_lock);
 }
 
 static gfloat
@@ -365,96 +445,282 @@ interpolate_values_for_position (GstTimedValue * first_value,
   return value_at_pos;
 }
 
+static GstTimedValue *
+_timed_value_new (GstClockTime timestamp, gdouble value)
+{
+  GstTimedValue *timed_value = g_slice_new (GstTimedValue);
+
+  timed_value->timestamp = timestamp;
+  timed_value->value = value;
+
+  return timed_value;
+}
+
 static void
-_update_control_bindings (GESTimelineElement * element, GstClockTime inpoint,
-    GstClockTime duration)
+_timed_value_free (GstTimedValue * timed_value)
 {
-  GParamSpec **specs;
-  guint n, n_specs;
-  GstControlBinding *binding;
-  GstTimedValueControlSource *source;
-  GESTrackElement *self = GES_TRACK_ELEMENT (element);
+  g_slice_free (GstTimedValue, timed_value);
+}
 
-  specs = ges_track_element_list_children_properties (self, &n_specs);
+static ControlSourceWindow *
+_control_source_window_new (GstTimedValueControlSource * source,
+    gboolean absolute)
+{
+  ControlSourceWindow *window = g_slice_new0 (ControlSourceWindow);
 
-  for (n = 0; n < n_specs; ++n) {
-    GList *values, *tmp;
-    gboolean absolute;
-    GstTimedValue *last, *first, *prev = NULL, *next = NULL;
-    gfloat value_at_pos;
+  window->source = gst_object_ref (source);
+  window->absolute = absolute;
+  window->hidden_before =
+      g_sequence_new ((GDestroyNotify) _timed_value_free);
+  window->hidden_after = g_sequence_new ((GDestroyNotify) _timed_value_free);
+  window->start_keyframe = GST_CLOCK_TIME_NONE;
+  window->end_keyframe = GST_CLOCK_TIME_NONE;
 
-    binding = ges_track_element_get_control_binding (self, specs[n]->name);
+  return window;
+}
 
-    if (!binding)
-      continue;
+static void
+_control_source_window_free (ControlSourceWindow * window)
+{
+  gst_object_unref (window->source);
+  g_sequence_free (window->hidden_before);
+  g_sequence_free (window->hidden_after);
+  g_slice_free (ControlSourceWindow, window);
+}
 
-    g_object_get (binding, "control_source", &source, NULL);
+static gint
+_compare_control_points (gconstpointer a, gconstpointer b, gpointer udata)
+{
+  GstClockTime ts_a = ((GstControlPoint *) a)->timestamp;
+  GstClockTime ts_b = ((GstControlPoint *) b)->timestamp;
+
+  if (ts_a < ts_b)
+    return -1;
+  if (ts_a > ts_b)
+    return 1;
+  return 0;
+}
 
-    g_object_get (binding, "absolute", &absolute, NULL);
-    if (duration == 0) {
-      gst_timed_value_control_source_unset_all (GST_TIMED_VALUE_CONTROL_SOURCE
-          (source));
-      continue;
+/* Returns %TRUE if @source has a keyframe at @position, otherwise sets
+ * @before and @after to the keyframes around @position, their timestamp
+ * being GST_CLOCK_TIME_NONE if there is none */
+static gboolean
+_get_surrounding_keyframes (GstTimedValueControlSource * source,
+    GstClockTime position, GstTimedValue * before, GstTimedValue * after)
+{
+  GSequenceIter *iter;
+  GstControlPoint *point, key = { 0, };
+  gboolean exact = FALSE;
+
+  before->timestamp = after->timestamp = GST_CLOCK_TIME_NONE;
+
+  GST_TIMED_VALUE_CONTROL_SOURCE_LOCK (source);
+  if (source->values) {
+    key.timestamp = position;
+    /* Points right after the keyframes at or before @position */
+    iter = g_sequence_search (source->values, &key, _compare_control_points,
+        NULL);
+
+    if (!g_sequence_iter_is_begin (iter)) {
+      point = g_sequence_get (g_sequence_iter_prev (iter));
+      exact = point->timestamp == position;
+      before->timestamp = point->timestamp;
+      before->value = point->value;
+    }
+
+    if (!g_sequence_iter_is_end (iter)) {
+      point = g_sequence_get (iter);
+      after->timestamp = point->timestamp;
+      after->value = point->value;
     }
+  }
+  GST_TIMED_VALUE_CONTROL_SOURCE_UNLOCK (source);
 
-    values =
-        gst_timed_value_control_source_get_all (GST_TIMED_VALUE_CONTROL_SOURCE
-        (source));
+  return exact;
+}
 
-    if (g_list_length (values) == 0)
-      continue;
+static GstTimedValue *
+_get_last_hidden_before (ControlSourceWindow * window)
+{
+  GSequenceIter *iter = g_sequence_get_end_iter (window->hidden_before);
+
+  if (g_sequence_iter_is_begin (iter))
+    return NULL;
+
+  return g_sequence_get (g_sequence_iter_prev (iter));
+}
+
+static GstTimedValue *
+_get_first_hidden_after (ControlSourceWindow * window)
+{
+  GSequenceIter *iter = g_sequence_get_begin_iter (window->hidden_after);
+
+  if (g_sequence_iter_is_end (iter))
+    return NULL;
+
+  return g_sequence_get (iter);
+}
+
+/* Puts back into the control source the hidden keyframes that are at or
+ * after @position if @before, at or before it otherwise */
+static void
+_restore_keyframes (ControlSourceWindow * window, GstClockTime position,
+    gboolean before)
+{
+  GstTimedValue *value;
 
-    first = values->data;
+  while ((value = before ? _get_last_hidden_before (window) :
+          _get_first_hidden_after (window))) {
+    GSequenceIter *iter;
 
-    for (tmp = values->next; tmp; tmp = tmp->next) {
-      next = tmp->data;
+    if (before ? value->timestamp < position : value->timestamp > position)
+      break;
+
+    gst_timed_value_control_source_set (window->source, value->timestamp,
+        value->value);
+
+    iter = before ?
+        g_sequence_iter_prev (g_sequence_get_end_iter (window->hidden_before)) :
+        g_sequence_get_begin_iter (window->hidden_after);
+    g_sequence_remove (iter);
+  }
+}
+
+/* Removes from the control source the keyframes that are strictly before
+ * @position if @before, strictly after it otherwise, and keeps them
+ * around so they can be restored when the window grows back */
+static void
+_hide_keyframes (ControlSourceWindow * window, GstClockTime position,
+    gboolean before)
+{
+  GList *tmp, *values = NULL;
+  GSequenceIter *iter, *first_hidden_after;
+  GstTimedValueControlSource *source = window->source;
 
-      if (next->timestamp > inpoint)
+  GST_TIMED_VALUE_CONTROL_SOURCE_LOCK (source);
+  if (source->values && before) {
+    for (iter = g_sequence_get_begin_iter (source->values);
+        !g_sequence_iter_is_end (iter); iter = g_sequence_iter_next (iter)) {
+      GstControlPoint *point = g_sequence_get (iter);
+
+      if (point->timestamp >= position)
         break;
+
+      values = g_list_prepend (values, _timed_value_new (point->timestamp,
+              point->value));
     }
+    values = g_list_reverse (values);
+  } else if (source->values) {
+    for (iter = g_sequence_get_end_iter (source->values);
+        !g_sequence_iter_is_begin (iter);) {
+      GstControlPoint *point;
+
+      iter = g_sequence_iter_prev (iter);
+      point = g_sequence_get (iter);
+      if (point->timestamp <= position)
+        break;
 
-    value_at_pos =
-        interpolate_values_for_position (first, next, inpoint, absolute);
-    gst_timed_value_control_source_unset (source, first->timestamp);
-    gst_timed_value_control_source_set (source, inpoint, value_at_pos);
+      values = g_list_prepend (values, _timed_value_new (point->timestamp,
+              point->value));
+    }
+  }
+  GST_TIMED_VALUE_CONTROL_SOURCE_UNLOCK (source);
 
-    values =
-        gst_timed_value_control_source_get_all (GST_TIMED_VALUE_CONTROL_SOURCE
-        (source));
+  first_hidden_after = g_sequence_get_begin_iter (window->hidden_after);
+  for (tmp = values; tmp; tmp = tmp->next) {
+    GstTimedValue *value = tmp->data;
 
-    if (duration != GST_CLOCK_TIME_NONE) {
-      last = g_list_last (values)->data;
+    gst_timed_value_control_source_unset (source, value->timestamp);
+
+    /* Keyframes we created ourselves are not worth keeping */
+    if (value->timestamp == window->start_keyframe) {
+      window->start_keyframe = GST_CLOCK_TIME_NONE;
+      _timed_value_free (value);
+    } else if (value->timestamp == window->end_keyframe) {
+      window->end_keyframe = GST_CLOCK_TIME_NONE;
+      _timed_value_free (value);
+    } else if (before) {
+      g_sequence_append (window->hidden_before, value);
+    } else {
+      g_sequence_insert_before (first_hidden_after, value);
+    }
+  }
+  g_list_free (values);
+}
 
-      for (tmp = g_list_last (values)->prev; tmp; tmp = tmp->prev) {
-        prev = tmp->data;
+static void
+_update_control_source_window (ControlSourceWindow * window,
+    GstClockTime inpoint, GstClockTime duration)
+{
+  GstTimedValue before, after;
+  GstTimedValue *hidden;
+  GstTimedValueControlSource *source = window->source;
+
+  if (duration == 0) {
+    gst_timed_value_control_source_unset_all (source);
+    g_sequence_remove_range (g_sequence_get_begin_iter (window->hidden_before),
+        g_sequence_get_end_iter (window->hidden_before));
+    g_sequence_remove_range (g_sequence_get_begin_iter (window->hidden_after),
+        g_sequence_get_end_iter (window->hidden_after));
+    window->start_keyframe = window->end_keyframe = GST_CLOCK_TIME_NONE;
 
-        if (prev->timestamp < duration + inpoint)
-          break;
-      }
+    return;
+  }
 
-      value_at_pos =
-          interpolate_values_for_position (prev, last, duration + inpoint,
-          absolute);
+  /* Handle the end first so that the keyframes it restores are hidden
+   * again if they are before @inpoint */
+  if (GST_CLOCK_TIME_IS_VALID (duration)) {
+    GstClockTime end = inpoint + duration;
 
-      gst_timed_value_control_source_unset (source, last->timestamp);
-      gst_timed_value_control_source_set (source, duration + inpoint,
-          value_at_pos);
-      values =
-          gst_timed_value_control_source_get_all (GST_TIMED_VALUE_CONTROL_SOURCE
-          (source));
+    if (GST_CLOCK_TIME_IS_VALID (window->end_keyframe)) {
+      gst_timed_value_control_source_unset (source, window->end_keyframe);
+      window->end_keyframe = GST_CLOCK_TIME_NONE;
     }
 
-    for (tmp = values; tmp; tmp = tmp->next) {
-      GstTimedValue *value = tmp->data;
-      if (value->timestamp < inpoint)
-        gst_timed_value_control_source_unset (source, value->timestamp);
-      else if (duration != GST_CLOCK_TIME_NONE
-          && value->timestamp > duration + inpoint)
-        gst_timed_value_control_source_unset (source, value->timestamp);
+    _restore_keyframes (window, end, FALSE);
+    _hide_keyframes (window, end, FALSE);
+
+    hidden = _get_first_hidden_after (window);
+    if (hidden && !_get_surrounding_keyframes (source, end, &before, &after)
+        && GST_CLOCK_TIME_IS_VALID (before.timestamp)) {
+      gst_timed_value_control_source_set (source, end,
+          interpolate_values_for_position (&before, hidden, end,
+              window->absolute));
+      window->end_keyframe = end;
     }
   }
 
-  g_free (specs);
+  if (GST_CLOCK_TIME_IS_VALID (window->start_keyframe)) {
+    gst_timed_value_control_source_unset (source, window->start_keyframe);
+    window->start_keyframe = GST_CLOCK_TIME_NONE;
+  }
+
+  _restore_keyframes (window, inpoint, TRUE);
+  _hide_keyframes (window, inpoint, TRUE);
+
+  hidden = _get_last_hidden_before (window);
+  if (hidden && !_get_surrounding_keyframes (source, inpoint, &before, &after)) {
+    gst_timed_value_control_source_set (source, inpoint,
+        interpolate_values_for_position (hidden,
+            GST_CLOCK_TIME_IS_VALID (after.timestamp) ? &after : NULL,
+            inpoint, window->absolute));
+    window->start_keyframe = inpoint;
+  }
+}
+
+/* Only the keyframes around the boundaries of the window are touched, the
+ * ones that fall out of it are hidden and put back if it grows again */
+static void
+_update_control_bindings (GESTimelineElement * element, GstClockTime inpoint,
+    GstClockTime duration)
+{
+  GHashTableIter iter;
+  ControlSourceWindow *window;
+  GESTrackElement *self = GES_TRACK_ELEMENT (element);
+
+  g_hash_table_iter_init (&iter, self->priv->control_source_windows);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & window))
+    _update_control_source_window (window, inpoint, duration);
 }
 
 static gboolean
@@ -616,7 +882,10 @@ ges_track_element_create_gnl_object_func (GESTrackElement * self)
   if (G_UNLIKELY (nleobject == NULL))
     goto no_nleobject;
 
-  if (klass->create_element) {
+  if (klass->create_element && klass->ABI.abi.element_on_demand) {
+    GST_DEBUG ("The element will be created when needed");
+    self->priv->element_on_demand = TRUE;
+  } else if (klass->create_element) {
     GST_DEBUG ("Calling subclass 'create_element' vmethod");
     child = klass->create_element (self);
 
@@ -788,7 +1057,421 @@ ges_track_element_add_children_props (GESTrackElement * self,
   gst_iterator_free (it);
 }
 
+static GPtrArray *
+_get_cached_children_pspecs (GESTrackElement * self)
+{
+  GPtrArray *specs = NULL;
+
+  g_mutex_lock (&children_pspecs_lock);
+  if (children_pspecs)
+    specs = g_hash_table_lookup (children_pspecs,
+        GSIZE_TO_POINTER (G_OBJECT_TYPE (self)));
+  g_mutex_unlock (&children_pspecs_lock);
+
+  return specs;
+}
+
+/* Records the children properties of the element of @self for the other
+ * elements of its class */
+static void
+_cache_children_pspecs (GESTrackElement * self)
+{
+  guint i, n_specs;
+  GParamSpec **specs;
+  GPtrArray *cached;
+
+  if (_get_cached_children_pspecs (self))
+    return;
+
+  specs = ges_timeline_element_list_children_properties (GES_TIMELINE_ELEMENT
+      (self), &n_specs);
+  cached = g_ptr_array_new_full (n_specs, (GDestroyNotify) g_param_spec_unref);
+  for (i = 0; i < n_specs; i++)
+    g_ptr_array_add (cached, specs[i]);
+  g_free (specs);
+
+  g_mutex_lock (&children_pspecs_lock);
+  if (!children_pspecs)
+    children_pspecs = g_hash_table_new_full (NULL, NULL, NULL,
+        (GDestroyNotify) g_ptr_array_unref);
+  if (!g_hash_table_contains (children_pspecs,
+          GSIZE_TO_POINTER (G_OBJECT_TYPE (self))))
+    g_hash_table_insert (children_pspecs,
+        GSIZE_TO_POINTER (G_OBJECT_TYPE (self)), cached);
+  else
+    g_ptr_array_unref (cached);
+  g_mutex_unlock (&children_pspecs_lock);
+}
+
+/* Maps the children properties of @self to a placeholder while it has no
+ * element, so that they can be listed, looked up, set and get without
+ * creating it, see ges_track_element_set_pending_child_property() */
+static void
+_add_placeholder_children_props (GESTrackElement * self)
+{
+  guint i;
+  GPtrArray *specs;
+  GESTrackElementPrivate *priv = self->priv;
+
+  g_rec_mutex_lock (&priv->element_lock);
+  specs = _get_cached_children_pspecs (self);
+  if (priv->element || priv->released_element || !specs) {
+    g_rec_mutex_unlock (&priv->element_lock);
+    return;
+  }
+
+  if (!priv->children_placeholder) {
+    priv->children_placeholder = g_object_new (G_TYPE_OBJECT, NULL);
+    g_object_set_qdata (priv->children_placeholder,
+        children_placeholder_quark, self);
+  }
+
+  for (i = 0; i < specs->len; i++)
+    ges_timeline_element_add_child_property (GES_TIMELINE_ELEMENT (self),
+        g_ptr_array_index (specs, i), priv->children_placeholder);
+
+  if (GES_IS_CONTAINER (GES_TIMELINE_ELEMENT_PARENT (self)))
+    _ges_container_add_child_properties (GES_CONTAINER
+        (GES_TIMELINE_ELEMENT_PARENT (self)), GES_TIMELINE_ELEMENT (self));
+  g_rec_mutex_unlock (&priv->element_lock);
+}
+
+static void
+_remove_placeholder_children_props (GESTrackElement * self)
+{
+  guint i;
+  GPtrArray *specs = _get_cached_children_pspecs (self);
+
+  if (!specs || !self->priv->children_placeholder)
+    return;
+
+  if (GES_IS_CONTAINER (GES_TIMELINE_ELEMENT_PARENT (self)))
+    _ges_container_remove_child_properties (GES_CONTAINER
+        (GES_TIMELINE_ELEMENT_PARENT (self)), GES_TIMELINE_ELEMENT (self));
+
+  for (i = 0; i < specs->len; i++)
+    ges_timeline_element_remove_child_property (GES_TIMELINE_ELEMENT (self),
+        g_ptr_array_index (specs, i));
+}
+
+/* Creates the element of @self if it is created on demand and does not
+ * exist yet, setting the values its children properties got while it did
+ * not exist. Must be called from the main thread */
+static GstElement *
+_ensure_element (GESTrackElement * self)
+{
+  GstElement *child;
+  GHashTableIter iter;
+  GParamSpec *pspec;
+  GValue *value;
+  GESTrackElementPrivate *priv = self->priv;
+
+  if (!priv->element_on_demand)
+    return priv->element;
+
+  g_rec_mutex_lock (&priv->element_lock);
+  if (priv->element || !priv->nleobject)
+    goto done;
+
+  /* The values to restore are those of the last released element */
+  _save_released_children_props (self);
+  _remove_placeholder_children_props (self);
+
+  GST_DEBUG_OBJECT (self, "Creating element on demand");
+  child = GES_TRACK_ELEMENT_GET_CLASS (self)->create_element (self);
+  if (G_UNLIKELY (!child)) {
+    GST_ERROR_OBJECT (self, "create_element returned NULL");
+    goto done;
+  }
+
+  if (G_UNLIKELY (!gst_bin_add (GST_BIN (priv->nleobject), child))) {
+    GST_ERROR_OBJECT (self, "Error adding the contents to the nleobject");
+    gst_object_unref (child);
+    goto done;
+  }
+  priv->element = child;
+  _cache_children_pspecs (self);
+
+  if (GES_IS_CONTAINER (GES_TIMELINE_ELEMENT_PARENT (self)))
+    _ges_container_add_child_properties (GES_CONTAINER
+        (GES_TIMELINE_ELEMENT_PARENT (self)), GES_TIMELINE_ELEMENT (self));
+
+  if (priv->pending_children_props) {
+    g_hash_table_iter_init (&iter, priv->pending_children_props);
+    while (g_hash_table_iter_next (&iter, (gpointer *) & pspec,
+            (gpointer *) & value))
+      ges_timeline_element_set_child_property_by_pspec (GES_TIMELINE_ELEMENT
+          (self), pspec, value);
+    g_clear_pointer (&priv->pending_children_props, g_hash_table_unref);
+  }
+
+  /* Depends on the children properties values */
+  if (GES_IS_SOURCE (self))
+    ges_source_update_passthrough (GES_SOURCE (self));
+
+done:
+  g_rec_mutex_unlock (&priv->element_lock);
+
+  return priv->element;
+}
+
+static void
+_free_gvalue (GValue * value)
+{
+  g_value_unset (value);
+  g_slice_free (GValue, value);
+}
+
+static void
+_ensure_pending_children_props (GESTrackElement * self)
+{
+  if (!self->priv->pending_children_props)
+    self->priv->pending_children_props =
+        g_hash_table_new_full ((GHashFunc) ges_pspec_hash, ges_pspec_equal,
+        (GDestroyNotify) g_param_spec_unref, (GDestroyNotify) _free_gvalue);
+}
+
+/* Saves the values of the children properties of the element released
+ * from the composition thread, so that they are set back when it gets
+ * created again, and drops them from @self and its clip.
+ *
+ * Must be called from the main thread */
+static void
+_save_released_children_props (GESTrackElement * self)
+{
+  guint i, n_specs;
+  GParamSpec **specs;
+  GESTrackElementPrivate *priv = self->priv;
+
+  g_rec_mutex_lock (&priv->element_lock);
+  if (!priv->released_element) {
+    g_rec_mutex_unlock (&priv->element_lock);
+    return;
+  }
+
+  GST_DEBUG_OBJECT (self, "Saving the children properties of released %"
+      GST_PTR_FORMAT, priv->released_element);
+
+  if (GES_IS_CONTAINER (GES_TIMELINE_ELEMENT_PARENT (self)))
+    _ges_container_remove_child_properties (GES_CONTAINER
+        (GES_TIMELINE_ELEMENT_PARENT (self)), GES_TIMELINE_ELEMENT (self));
+
+  _ensure_pending_children_props (self);
+  specs = ges_timeline_element_list_children_properties (GES_TIMELINE_ELEMENT
+      (self), &n_specs);
+  for (i = 0; i < n_specs; i++) {
+    GValue *value = g_slice_new0 (GValue);
+
+    g_value_init (value, specs[i]->value_type);
+    ges_timeline_element_get_child_property_by_pspec (GES_TIMELINE_ELEMENT
+        (self), specs[i], value);
+    g_hash_table_replace (priv->pending_children_props, specs[i], value);
+    ges_timeline_element_remove_child_property (GES_TIMELINE_ELEMENT (self),
+        specs[i]);
+  }
+  g_free (specs);
+
+  gst_object_unref (priv->released_element);
+  priv->released_element = NULL;
+  g_rec_mutex_unlock (&priv->element_lock);
+}
+
+/* nlesource asks for its element to be created and released from the
+ * composition thread, which must not wait for the main thread. Creating
+ * the element modifies the children properties of the clip and connects
+ * to the track, so the composition thread only queues it to be handled
+ * from the default main context, the composition waits for the element to
+ * be added before using it */
+typedef struct
+{
+  GESTrackElement *self;
+  void (*func) (GESTrackElement * self);
+} ElementRequest;
+
+static GMutex element_requests_lock;
+static GQueue element_requests = G_QUEUE_INIT;
+
+static gboolean
+_handle_element_requests (gpointer unused)
+{
+  ElementRequest *request;
+
+  g_mutex_lock (&element_requests_lock);
+  while ((request = g_queue_pop_head (&element_requests))) {
+    g_mutex_unlock (&element_requests_lock);
+    request->func (request->self);
+    gst_object_unref (request->self);
+    g_slice_free (ElementRequest, request);
+    g_mutex_lock (&element_requests_lock);
+  }
+  g_mutex_unlock (&element_requests_lock);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+_queue_element_request (GESTrackElement * self,
+    void (*func) (GESTrackElement * self))
+{
+  ElementRequest *request = g_slice_new (ElementRequest);
+
+  request->self = gst_object_ref (self);
+  request->func = func;
+
+  g_mutex_lock (&element_requests_lock);
+  if (g_queue_is_empty (&element_requests))
+    g_idle_add (_handle_element_requests, NULL);
+  g_queue_push_tail (&element_requests, request);
+  g_mutex_unlock (&element_requests_lock);
+}
+
+/* INTERNAL USAGE
+ *
+ * Handles the pending element requests of the composition threads, for
+ * the places where the main thread blocks waiting for a composition */
+void
+ges_track_element_handle_pending_requests (void)
+{
+  _handle_element_requests (NULL);
+}
+
+static void
+_create_element (GESTrackElement * self)
+{
+  _ensure_element (self);
+}
+
+static void
+_finish_release (GESTrackElement * self)
+{
+  _save_released_children_props (self);
+  _add_placeholder_children_props (self);
+}
+
+static void
+_need_element_cb (GstElement * nleobject, GESTrackElement * self)
+{
+  _queue_element_request (self, _create_element);
+}
+
+/* Emitted from the composition thread while @nleobject is not used, the
+ * element gets detached right away so that the composition can rely on it
+ * being gone */
+static void
+_release_element_cb (GstElement * nleobject, GESTrackElement * self)
+{
+  GstElement *element;
+  GESTrackElementPrivate *priv = self->priv;
+
+  g_rec_mutex_lock (&priv->element_lock);
+  element = priv->element;
+
+  /* Keyframes are attached to the children of the element */
+  if (!element || g_hash_table_size (priv->bindings_hashtable)) {
+    g_rec_mutex_unlock (&priv->element_lock);
+    return;
+  }
+
+  GST_DEBUG_OBJECT (self, "Releasing %" GST_PTR_FORMAT, element);
+
+  priv->released_element = gst_object_ref (element);
+  priv->element = NULL;
+  gst_element_set_state (element, GST_STATE_NULL);
+  gst_bin_remove (GST_BIN (nleobject), element);
+  g_rec_mutex_unlock (&priv->element_lock);
+
+  _queue_element_request (self, _finish_release);
+}
+
+/* INTERNAL USAGE
+ *
+ * Sets the value of a child property of the element created on demand
+ * of a track element while it does not exist, @child being the
+ * placeholder it is mapped to. The value is set on the element once it
+ * gets created.
+ *
+ * Returns: %FALSE if @child is not such a placeholder
+ */
+gboolean
+ges_track_element_set_pending_child_property (GObject * child,
+    GParamSpec * pspec, const GValue * value)
+{
+  GValue *pending;
+  GESTrackElement *self =
+      g_object_get_qdata (child, children_placeholder_quark);
+
+  if (!self)
+    return FALSE;
+
+  pending = g_slice_new0 (GValue);
+  g_value_init (pending, pspec->value_type);
+  if (!g_value_transform (value, pending)) {
+    GST_WARNING_OBJECT (self, "Can not set %s from a %s", pspec->name,
+        G_VALUE_TYPE_NAME (value));
+    _free_gvalue (pending);
+
+    return TRUE;
+  }
+  g_param_value_validate (pspec, pending);
+
+  g_rec_mutex_lock (&self->priv->element_lock);
+  _ensure_pending_children_props (self);
+  g_hash_table_replace (self->priv->pending_children_props,
+      g_param_spec_ref (pspec), pending);
+  g_rec_mutex_unlock (&self->priv->element_lock);
+
+  return TRUE;
+}
+
+/* INTERNAL USAGE
+ *
+ * Gets the value of a child property mapped to @child, see
+ * ges_track_element_set_pending_child_property(). Properties that were
+ * not set hold the default value of @pspec.
+ *
+ * Returns: %FALSE if @child is not a placeholder
+ */
+gboolean
+ges_track_element_get_pending_child_property (GObject * child,
+    GParamSpec * pspec, GValue * value)
+{
+  GValue *pending = NULL;
+  GValue default_value = G_VALUE_INIT;
+  GESTrackElement *self =
+      g_object_get_qdata (child, children_placeholder_quark);
+
+  if (!self)
+    return FALSE;
+
+  g_rec_mutex_lock (&self->priv->element_lock);
+  if (self->priv->pending_children_props)
+    pending = g_hash_table_lookup (self->priv->pending_children_props, pspec);
+
+  if (!pending) {
+    g_value_init (&default_value, pspec->value_type);
+    g_param_value_set_default (pspec, &default_value);
+    pending = &default_value;
+  }
+
+  g_value_transform (pending, value);
+  g_rec_mutex_unlock (&self->priv->element_lock);
+
+  if (G_IS_VALUE (&default_value))
+    g_value_unset (&default_value);
+
+  return TRUE;
+}
+
 /* INTERNAL USAGE */
+gboolean
+ges_track_element_has_element (GESTrackElement * object)
+{
+  /* The children properties of a released element are around until they
+   * get saved */
+  return !object->priv->element_on_demand || object->priv->element != NULL
+      || object->priv->released_element != NULL;
+}
+
 gboolean
 ges_track_element_set_track (GESTrackElement * object, GESTrack * track)
 {
@@ -800,11 +1483,33 @@ ges_track_element_set_track (GESTrackElement * object, GESTrack * track)
 
   object->priv->track = track;
 
+  if (object->priv->element_on_demand) {
+    g_signal_handlers_disconnect_by_data (object->priv->nleobject, object);
+
+    if (track && GST_CLOCK_TIME_IS_VALID
+        (ges_track_get_lazy_elements_window (track))) {
+      g_signal_connect (object->priv->nleobject, "need-element",
+          G_CALLBACK (_need_element_cb), object);
+      g_signal_connect (object->priv->nleobject, "release-element",
+          G_CALLBACK (_release_element_cb), object);
+    }
+  }
+
   if (object->priv->track) {
     ges_track_element_set_track_type (object, track->type);
 
     g_object_set (object->priv->nleobject,
         "caps", ges_track_get_caps (object->priv->track), NULL);
+
+    /* Tracks that do not create elements lazily get them right away, and
+     * so does the first element of each class so that the children
+     * properties of the others are known before they get created */
+    if (object->priv->element_on_demand &&
+        (!GST_CLOCK_TIME_IS_VALID (ges_track_get_lazy_elements_window
+                (track)) || !_get_cached_children_pspecs (object)))
+      _ensure_element (object);
+    else if (object->priv->element_on_demand)
+      _add_placeholder_children_props (object);
   }
 
   g_object_notify_by_pspec (G_OBJECT (object), properties[PROP_TRACK]);
@@ -894,8 +1599,9 @@ ges_track_element_get_nleobject (GESTrackElement * object)
  *
  * Get the #GstElement this track element is controlling within GNonLin.
  *
- * Returns: (transfer none): the #GstElement this track element is controlling
- * within GNonLin.
+ * Returns: (transfer none) (nullable): the #GstElement this track element is
+ * controlling within GNonLin, %NULL if it is created on demand, see
+ * #GESTrack:lazy-elements-window, and does not exist at the moment.
  */
 GstElement *
 ges_track_element_get_element (GESTrackElement * object)
@@ -1419,6 +2125,7 @@ ges_track_element_remove_control_binding (GESTrackElement * object,
     g_signal_emit (object, ges_track_element_signals[CONTROL_BINDING_REMOVED],
         0, binding);
 
+    g_hash_table_remove (priv->control_source_windows, binding);
     gst_object_unref (target);
     gst_object_unref (binding);
     g_hash_table_remove (priv->bindings_hashtable, property_name);
@@ -1463,6 +2170,9 @@ ges_track_element_set_control_source (GESTrackElement * object,
     return FALSE;
   }
 
+  /* Bindings are attached to the children of the element */
+  _ensure_element (object);
+
   if (!ges_track_element_lookup_child (object, property_name, &element, &pspec)) {
     GST_WARNING ("You need to provide a valid and controllable property name");
     return FALSE;
@@ -1490,6 +2200,10 @@ ges_track_element_set_control_source (GESTrackElement * object,
     gst_object_add_control_binding (GST_OBJECT (element), binding);
     g_hash_table_insert (priv->bindings_hashtable, g_strdup (property_name),
         binding);
+    if (GST_IS_TIMED_VALUE_CONTROL_SOURCE (source))
+      g_hash_table_insert (priv->control_source_windows, binding,
+          _control_source_window_new (GST_TIMED_VALUE_CONTROL_SOURCE (source),
+              direct_absolute));
     g_signal_emit (object, ges_track_element_signals[CONTROL_BINDING_ADDED],
         0, binding);
     return TRUE;
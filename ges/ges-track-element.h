@@ -122,7 +122,15 @@ struct _GESTrackElementClass {
                                             GParamSpec **pspec);
   /*< private >*/
   /* Padding for API extension */
-  gpointer _ges_reserved[GES_PADDING_LARGE];
+  union {
+    gpointer _ges_reserved[GES_PADDING_LARGE];
+    struct {
+      /* Whether #create_element can be called lazily, when the element is
+       * about to be used. Subclasses setting it must cope with their
+       * element being created late, and released and created again */
+      gboolean element_on_demand;
+    } abi;
+  } ABI;
 };
 
 GES_API
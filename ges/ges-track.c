@@ -31,6 +31,8 @@
 #include "ges-internal.h"
 #include "ges-track.h"
 #include "ges-track-element.h"
+#include "ges-source.h"
+#include "ges-video-source.h"
 #include "ges-meta-container.h"
 #include "ges-video-track.h"
 #include "ges-audio-track.h"
@@ -55,6 +57,16 @@ typedef struct
   GESTrack *track;
 } Gap;
 
+/* A gap as computed from the track elements, before it gets filled */
+typedef struct
+{
+  GstClockTime start;
+  GstClockTime duration;
+} GapRange;
+
+/* Number of gaps removed from the composition kept around to be reused */
+#define MAX_SPARE_GAPS 16
+
 struct _GESTrackPrivate
 {
   /*< private > */
@@ -62,7 +74,22 @@ struct _GESTrackPrivate
   GSequence *trackelements_by_start;
   GHashTable *trackelements_iter;
   GList *gaps;
+  /* Gaps removed from the composition, kept to be reused instead of
+   * creating new filling elements, at most MAX_SPARE_GAPS */
+  GList *spare_gaps;
+  guint n_spare_gaps;
   gboolean last_gap_disabled;
+  /* Whether the gaps between elements are all filled by @gap_filler, a
+   * single expandable source placed below everything else */
+  gboolean shared_gap_filler;
+  GstElement *gap_filler;
+
+  /* Distance from the playback position beyond which the elements created
+   * on demand are released, GST_CLOCK_TIME_NONE if they are not created on
+   * demand */
+  GstClockTime lazy_elements_window;
+  /* Whether the elements created on demand ever get released */
+  gboolean release_lazy_elements;
 
   guint64 duration;
 
@@ -78,6 +105,25 @@ struct _GESTrackPrivate
   GstElement *mixing_operation;
   GstElement *capsfilter;
 
+  /* Factor applied to the restriction caps video size, see
+   * ges_timeline_set_preview_scale() */
+  gdouble preview_scale;
+
+  /* Whether the sources can pass their encoded streams through is only
+   * evaluated while @caps accept encoded streams, see update_passthrough().
+   * @passthrough_ranges holds the GapRange each element covered when last
+   * evaluated, %NULL when nothing was, @passthrough_dirty the elements that
+   * changed since then and @passthrough_removed the GapRange of the
+   * removed ones */
+  GHashTable *passthrough_ranges;
+  GHashTable *passthrough_dirty;
+  GArray *passthrough_removed;
+  /* Set when all the sources need to be evaluated again */
+  gboolean passthrough_outdated;
+  /* Longest duration an element ever had, bounding how long before a
+   * position the elements overlapping it can start */
+  GstClockTime max_element_duration;
+
   /* Virtual method to create GstElement that fill gaps */
   GESCreateElementForGapFunc create_element_for_gaps;
 };
@@ -90,6 +136,9 @@ enum
   ARG_TYPE,
   ARG_DURATION,
   ARG_MIXING,
+  ARG_SHARED_GAP_FILLER,
+  ARG_LAZY_ELEMENTS_WINDOW,
+  ARG_RELEASE_LAZY_ELEMENTS,
   ARG_LAST,
   TRACK_ELEMENT_ADDED,
   TRACK_ELEMENT_REMOVED,
@@ -112,6 +161,58 @@ add_trackelement_to_list_foreach (GESTrackElement * trackelement, GList ** list)
   *list = g_list_prepend (*list, trackelement);
 }
 
+static void
+gap_set_times (Gap * gap, GstClockTime start, GstClockTime duration)
+{
+  if (gap->start == start && gap->duration == duration)
+    return;
+
+  GST_DEBUG_OBJECT (gap->track, "Moving gap from %" GST_TIME_FORMAT
+      " (duration %" GST_TIME_FORMAT ") to %" GST_TIME_FORMAT " (duration %"
+      GST_TIME_FORMAT ")", GST_TIME_ARGS (gap->start),
+      GST_TIME_ARGS (gap->duration), GST_TIME_ARGS (start),
+      GST_TIME_ARGS (duration));
+
+  gap->start = start;
+  gap->duration = duration;
+  g_object_set (gap->nleobj, "start", start, "duration", duration, NULL);
+}
+
+static Gap *
+gap_new_from_spare (GESTrack * track, GstClockTime start,
+    GstClockTime duration)
+{
+  Gap *gap = track->priv->spare_gaps->data;
+
+  track->priv->spare_gaps =
+      g_list_delete_link (track->priv->spare_gaps, track->priv->spare_gaps);
+  track->priv->n_spare_gaps--;
+
+  /* The composition resets the timing of the objects removed from it */
+  gap->start = start;
+  gap->duration = duration;
+  g_object_set (gap->nleobj, "start", start, "duration", duration,
+      "priority", 1, NULL);
+
+  if (G_UNLIKELY (ges_nle_composition_add_object (track->priv->composition,
+              gap->nleobj) == FALSE)) {
+    GST_WARNING_OBJECT (track, "Could not add gap to the composition");
+    gst_object_unref (gap->nleobj);
+    g_slice_free (Gap, gap);
+
+    return NULL;
+  }
+
+  /* The composition holds the object now */
+  gst_object_unref (gap->nleobj);
+
+  GST_DEBUG_OBJECT (track,
+      "Reused gap with start %" GST_TIME_FORMAT " duration %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (gap->start), GST_TIME_ARGS (gap->duration));
+
+  return gap;
+}
+
 static Gap *
 gap_new (GESTrack * track, GstClockTime start, GstClockTime duration)
 {
@@ -119,6 +220,9 @@ gap_new (GESTrack * track, GstClockTime start, GstClockTime duration)
 
   Gap *new_gap;
 
+  if (track->priv->spare_gaps)
+    return gap_new_from_spare (track, start, duration);
+
   nlesrc = gst_element_factory_make ("nlesource", NULL);
   elem = track->priv->create_element_for_gaps (track);
   if (G_UNLIKELY (gst_bin_add (GST_BIN (nlesrc), elem) == FALSE)) {
@@ -177,11 +281,103 @@ free_gap (Gap * gap)
   g_slice_free (Gap, gap);
 }
 
+static void
+free_spare_gap (Gap * gap)
+{
+  gst_object_unref (gap->nleobj);
+  g_slice_free (Gap, gap);
+}
+
+/* Removes @gap from the composition, keeping its filling element around
+ * unless there are enough spare ones already */
+static void
+recycle_gap (Gap * gap)
+{
+  GESTrack *track = gap->track;
+
+  if (track->priv->n_spare_gaps >= MAX_SPARE_GAPS) {
+    free_gap (gap);
+
+    return;
+  }
+
+  GST_DEBUG_OBJECT (track, "Recycling gap with start %" GST_TIME_FORMAT
+      " duration %" GST_TIME_FORMAT, GST_TIME_ARGS (gap->start),
+      GST_TIME_ARGS (gap->duration));
+
+  gst_object_ref (gap->nleobj);
+  ges_nle_composition_remove_object (track->priv->composition, gap->nleobj);
+  track->priv->spare_gaps = g_list_prepend (track->priv->spare_gaps, gap);
+  track->priv->n_spare_gaps++;
+}
+
+static inline void
+add_gap_range (GArray * ranges, GstClockTime start, GstClockTime duration)
+{
+  GapRange range = { start, duration };
+
+  g_array_append_val (ranges, range);
+}
+
+/* Adds or removes the shared gap filler according to the
+ * #GESTrack:shared-gap-filler property */
+static void
+update_shared_gap_filler (GESTrack * track)
+{
+  GstElement *nlesrc, *elem;
+  GESTrackPrivate *priv = track->priv;
+
+  if (!priv->shared_gap_filler) {
+    if (priv->gap_filler) {
+      GST_DEBUG_OBJECT (track, "Removing shared gap filler");
+      ges_nle_composition_remove_object (priv->composition, priv->gap_filler);
+      priv->gap_filler = NULL;
+    }
+
+    return;
+  }
+
+  if (priv->gap_filler)
+    return;
+
+  nlesrc = gst_element_factory_make ("nlesource", "shared-gap-filler");
+  elem = priv->create_element_for_gaps (track);
+  if (G_UNLIKELY (gst_bin_add (GST_BIN (nlesrc), elem) == FALSE)) {
+    GST_WARNING_OBJECT (track, "Could not create shared gap filler");
+
+    if (nlesrc)
+      gst_object_unref (nlesrc);
+
+    if (elem)
+      gst_object_unref (elem);
+
+    return;
+  }
+
+  /* Expandable so it spans the whole composition, with the lowest possible
+   * priority so it only shows where nothing else is playing */
+  g_object_set (nlesrc, "expandable", TRUE, "priority", G_MAXUINT, NULL);
+  if (G_UNLIKELY (ges_nle_composition_add_object (priv->composition,
+              nlesrc) == FALSE)) {
+    GST_WARNING_OBJECT (track, "Could not add shared gap filler to the"
+        " composition");
+    gst_object_unref (nlesrc);
+
+    return;
+  }
+
+  GST_DEBUG_OBJECT (track, "Added shared gap filler");
+  priv->gap_filler = nlesrc;
+}
+
 static inline void
 update_gaps (GESTrack * track)
 {
   Gap *gap;
-  GList *gaps;
+  guint i;
+  GList *tmp, *gaps;
+  GArray *ranges, *unfilled;
+  GHashTable *gaps_by_start, *unused;
   GSequenceIter *it;
 
   GESTrackElement *trackelement;
@@ -195,8 +391,9 @@ update_gaps (GESTrack * track)
     return;
   }
 
-  gaps = priv->gaps;
-  priv->gaps = NULL;
+  update_shared_gap_filler (track);
+
+  ranges = g_array_new (FALSE, FALSE, sizeof (GapRange));
 
   /* 1- And recalculate gaps */
   for (it = g_sequence_get_begin_iter (priv->trackelements_by_start);
@@ -209,27 +406,20 @@ update_gaps (GESTrack * track)
     start = _START (trackelement);
     end = start + _DURATION (trackelement);
 
-    if (start > duration) {
-      /* 2- Fill gap */
-      gap = gap_new (track, duration, start - duration);
-
-      if (G_LIKELY (gap != NULL))
-        priv->gaps = g_list_prepend (priv->gaps, gap);
-    }
+    /* The shared gap filler already covers the gaps between elements */
+    if (start > duration && !priv->shared_gap_filler)
+      add_gap_range (ranges, duration, start - duration);
 
     duration = MAX (duration, end);
   }
 
-  /* 3- Add a gap at the end of the timeline if needed */
+  /* 2- Add a gap at the end of the timeline if needed, the shared gap filler
+   * does not extend the composition so this one is always needed */
   if (priv->timeline) {
     g_object_get (priv->timeline, "duration", &timeline_duration, NULL);
 
     if (duration < timeline_duration) {
-      gap = gap_new (track, duration, timeline_duration - duration);
-
-      if (G_LIKELY (gap != NULL)) {
-        priv->gaps = g_list_prepend (priv->gaps, gap);
-      }
+      add_gap_range (ranges, duration, timeline_duration - duration);
 
       priv->duration = timeline_duration;
     }
@@ -237,12 +427,65 @@ update_gaps (GESTrack * track)
 
   if (!track->priv->last_gap_disabled) {
     GST_DEBUG_OBJECT (track, "Adding a one second gap at the end");
-    gap = gap_new (track, timeline_duration, 1);
+    add_gap_range (ranges, timeline_duration, 1);
+  }
+
+  /* 3- Keep the gaps which did not move, only updating their duration */
+  gaps = priv->gaps;
+  priv->gaps = NULL;
+  unused = g_hash_table_new (g_direct_hash, g_direct_equal);
+  gaps_by_start = g_hash_table_new (g_int64_hash, g_int64_equal);
+  for (tmp = gaps; tmp; tmp = tmp->next) {
+    g_hash_table_add (unused, tmp->data);
+    g_hash_table_insert (gaps_by_start, &((Gap *) tmp->data)->start,
+        tmp->data);
+  }
+
+  unfilled = g_array_new (FALSE, FALSE, sizeof (GapRange));
+  for (i = 0; i < ranges->len; i++) {
+    GapRange *range = &g_array_index (ranges, GapRange, i);
+
+    gap = g_hash_table_lookup (gaps_by_start, &range->start);
+    if (gap && g_hash_table_remove (unused, gap)) {
+      gap_set_times (gap, range->start, range->duration);
+      priv->gaps = g_list_prepend (priv->gaps, gap);
+    } else {
+      g_array_append_val (unfilled, *range);
+    }
+  }
+  g_hash_table_unref (gaps_by_start);
+
+  /* 4- Retime the gaps which moved to fill the new ones */
+  tmp = gaps;
+  for (i = 0; i < unfilled->len; i++) {
+    GapRange *range = &g_array_index (unfilled, GapRange, i);
+
+    for (gap = NULL; tmp && !gap; tmp = tmp->next) {
+      if (g_hash_table_remove (unused, tmp->data))
+        gap = tmp->data;
+    }
+
+    if (gap) {
+      gap_set_times (gap, range->start, range->duration);
+    } else {
+      gap = gap_new (track, range->start, range->duration);
+      if (G_UNLIKELY (gap == NULL))
+        continue;
+    }
+
     priv->gaps = g_list_prepend (priv->gaps, gap);
   }
 
-  /* 4- Remove old gaps */
-  g_list_free_full (gaps, (GDestroyNotify) free_gap);
+  /* 5- Recycle the old gaps which are not needed anymore */
+  for (; tmp; tmp = tmp->next) {
+    if (g_hash_table_contains (unused, tmp->data))
+      recycle_gap (tmp->data);
+  }
+
+  g_hash_table_unref (unused);
+  g_list_free (gaps);
+  g_array_unref (unfilled);
+  g_array_unref (ranges);
 }
 
 void
@@ -258,6 +501,10 @@ track_resort_and_fill_gaps (GESTrack * track)
   g_sequence_sort (track->priv->trackelements_by_start,
       (GCompareDataFunc) element_start_compare, NULL);
 
+  /* The gaps are updated once the timeline batch is done */
+  if (timeline_is_batching (track->priv->timeline))
+    return;
+
   if (track->priv->updating == TRUE) {
     update_gaps (track);
   }
@@ -270,15 +517,255 @@ update_field (GQuark field_id, const GValue * value, GstStructure * original)
   return TRUE;
 }
 
+/* Calls @func on the elements of @track intersecting [@start, @end) until
+ * it returns %FALSE, only going over the neighbours of that range in
+ * trackelements_by_start, which needs to be sorted */
+static void
+foreach_element_in_range (GESTrack * track, GstClockTime start,
+    GstClockTime end, GHRFunc func, gpointer user_data)
+{
+  GSequenceIter *begin, *iter, *mid;
+  GESTimelineElement *element;
+  GESTrackPrivate *priv = track->priv;
+
+  /* Look for the first element starting at or after @end */
+  begin = g_sequence_get_begin_iter (priv->trackelements_by_start);
+  iter = g_sequence_get_end_iter (priv->trackelements_by_start);
+  while (begin != iter) {
+    mid = g_sequence_range_get_midpoint (begin, iter);
+    if (_START (g_sequence_get (mid)) < end)
+      begin = g_sequence_iter_next (mid);
+    else
+      iter = mid;
+  }
+
+  while (!g_sequence_iter_is_begin (iter)) {
+    iter = g_sequence_iter_prev (iter);
+    element = g_sequence_get (iter);
+
+    if (_START (element) + priv->max_element_duration <= start)
+      break;
+
+    if (_END (element) > start && !func (element, NULL, user_data))
+      break;
+  }
+}
+
+typedef struct
+{
+  GESTimelineElement *ignored;
+  gboolean found;
+} FindActiveData;
+
+static gboolean
+find_active_element (GESTimelineElement * element, gpointer unused,
+    FindActiveData * data)
+{
+  if (element == data->ignored ||
+      !ges_track_element_is_active (GES_TRACK_ELEMENT (element)))
+    return TRUE;
+
+  GST_DEBUG_OBJECT (data->ignored, "Overlapping %" GST_PTR_FORMAT, element);
+  data->found = TRUE;
+
+  return FALSE;
+}
+
+/* Whether an active element of @track, other than @ignored, intersects
+ * [@start, @end) */
+gboolean
+track_has_active_element_in_range (GESTrack * track, GstClockTime start,
+    GstClockTime end, GESTrackElement * ignored)
+{
+  FindActiveData data = { GES_TIMELINE_ELEMENT (ignored), FALSE };
+
+  foreach_element_in_range (track, start, end,
+      (GHRFunc) find_active_element, &data);
+
+  return data.found;
+}
+
+static gboolean
+add_source (GESTimelineElement * element, gpointer unused, GHashTable * sources)
+{
+  if (GES_IS_SOURCE (element))
+    g_hash_table_add (sources, element);
+
+  return TRUE;
+}
+
+static gboolean
+caps_accept_encoded (const GstCaps * caps)
+{
+  guint i;
+
+  if (!caps || gst_caps_is_any (caps))
+    return FALSE;
+
+  for (i = 0; i < gst_caps_get_size (caps); i++) {
+    if (!g_str_has_suffix (gst_structure_get_name (gst_caps_get_structure
+                (caps, i)), "/x-raw"))
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+static void
+store_passthrough_range (GESTrack * track, GESTimelineElement * element)
+{
+  GapRange *range = g_slice_new (GapRange);
+
+  range->start = _START (element);
+  range->duration = _DURATION (element);
+  g_hash_table_insert (track->priv->passthrough_ranges, element, range);
+}
+
+static void
+free_passthrough_range (GapRange * range)
+{
+  g_slice_free (GapRange, range);
+}
+
+/* Updates whether the sources of @track can pass their encoded streams
+ * through, see ges_source_update_passthrough(). Nothing is done while the
+ * track caps only accept raw streams, and only the sources around the
+ * elements that changed since the last update are evaluated again */
+static void
+update_passthrough (GESTrack * track)
+{
+  guint i;
+  GList *tmp, *sources;
+  GHashTableIter iter;
+  GSequenceIter *it;
+  GapRange *range;
+  GESTimelineElement *element;
+  gboolean encoded;
+  GHashTable *to_update;
+  GESTrackPrivate *priv = track->priv;
+
+  encoded = caps_accept_encoded (priv->caps);
+  if (priv->passthrough_outdated ||
+      encoded != (priv->passthrough_ranges != NULL)) {
+    /* Evaluating everything again, or making all the sources decode their
+     * streams as the caps do not accept encoded streams anymore */
+    priv->passthrough_outdated = FALSE;
+    g_clear_pointer (&priv->passthrough_ranges, g_hash_table_unref);
+    g_hash_table_remove_all (priv->passthrough_dirty);
+    g_array_set_size (priv->passthrough_removed, 0);
+    if (encoded)
+      priv->passthrough_ranges = g_hash_table_new_full (g_direct_hash,
+          g_direct_equal, NULL, (GDestroyNotify) free_passthrough_range);
+
+    for (it = g_sequence_get_begin_iter (priv->trackelements_by_start);
+        !g_sequence_iter_is_end (it); it = g_sequence_iter_next (it)) {
+      element = g_sequence_get (it);
+      if (encoded)
+        store_passthrough_range (track, element);
+      if (GES_IS_SOURCE (element))
+        ges_source_update_passthrough (GES_SOURCE (element));
+    }
+
+    return;
+  }
+
+  if (!encoded)
+    return;
+
+  if (!g_hash_table_size (priv->passthrough_dirty) &&
+      !priv->passthrough_removed->len)
+    return;
+
+  /* The sources overlapping the elements that changed, before or after
+   * the change, and the sources that changed themselves */
+  to_update = g_hash_table_new (g_direct_hash, g_direct_equal);
+  g_hash_table_iter_init (&iter, priv->passthrough_dirty);
+  while (g_hash_table_iter_next (&iter, (gpointer *) & element, NULL)) {
+    range = g_hash_table_lookup (priv->passthrough_ranges, element);
+    if (range)
+      foreach_element_in_range (track, range->start,
+          range->start + range->duration, (GHRFunc) add_source, to_update);
+
+    foreach_element_in_range (track, _START (element), _END (element),
+        (GHRFunc) add_source, to_update);
+    add_source (element, NULL, to_update);
+    store_passthrough_range (track, element);
+  }
+  g_hash_table_remove_all (priv->passthrough_dirty);
+
+  for (i = 0; i < priv->passthrough_removed->len; i++) {
+    range = &g_array_index (priv->passthrough_removed, GapRange, i);
+    foreach_element_in_range (track, range->start,
+        range->start + range->duration, (GHRFunc) add_source, to_update);
+  }
+  g_array_set_size (priv->passthrough_removed, 0);
+
+  sources = g_hash_table_get_keys (to_update);
+  for (tmp = sources; tmp; tmp = tmp->next)
+    ges_source_update_passthrough (tmp->data);
+  g_list_free (sources);
+  g_hash_table_unref (to_update);
+}
+
+static void
+mark_passthrough_dirty (GESTrack * track, GESTrackElement * element)
+{
+  if (track->priv->passthrough_ranges)
+    g_hash_table_add (track->priv->passthrough_dirty, element);
+}
+
+static void
+update_max_element_duration (GESTrack * track, GESTrackElement * element)
+{
+  if (GST_CLOCK_TIME_IS_VALID (_DURATION (element)))
+    track->priv->max_element_duration =
+        MAX (track->priv->max_element_duration, _DURATION (element));
+}
+
+/* Called when what the sources can pass through changes for all of them */
+static void
+mark_passthrough_outdated (GESTrack * track)
+{
+  if (track->priv->passthrough_ranges)
+    track->priv->passthrough_outdated = TRUE;
+}
+
 /* callbacks */
 static void
 sort_track_elements_cb (GESTrackElement * child,
     GParamSpec * arg G_GNUC_UNUSED, GESTrack * track)
 {
-  g_sequence_sort (track->priv->trackelements_by_start,
+  update_max_element_duration (track, child);
+  mark_passthrough_dirty (track, child);
+  _ges_sequence_sort_changed (g_hash_table_lookup
+      (track->priv->trackelements_iter, child),
       (GCompareDataFunc) element_start_compare, NULL);
 }
 
+static void
+element_active_changed_cb (GESTrackElement * child,
+    GParamSpec * arg G_GNUC_UNUSED, GESTrack * track)
+{
+  mark_passthrough_dirty (track, child);
+}
+
+/* The volume and the control bindings of a source also tell whether it
+ * can pass its encoded stream through */
+static void
+source_child_property_changed_cb (GESTrackElement * child,
+    GObject * prop_object G_GNUC_UNUSED, GParamSpec * arg G_GNUC_UNUSED,
+    GESTrack * track)
+{
+  mark_passthrough_dirty (track, child);
+}
+
+static void
+source_binding_changed_cb (GESTrackElement * child,
+    GstControlBinding * binding G_GNUC_UNUSED, GESTrack * track)
+{
+  mark_passthrough_dirty (track, child);
+}
+
 static void
 _ghost_nlecomposition_srcpad (GESTrack * track)
 {
@@ -339,6 +826,23 @@ ges_track_get_composition (GESTrack * track)
   return track->priv->composition;
 }
 
+GList *
+ges_track_get_gap_objects (GESTrack * track)
+{
+  GList *tmp, *objects = NULL;
+
+  for (tmp = track->priv->gaps; tmp; tmp = tmp->next)
+    objects = g_list_prepend (objects, ((Gap *) tmp->data)->nleobj);
+
+  return objects;
+}
+
+GstElement *
+ges_track_get_gap_filler_object (GESTrack * track)
+{
+  return track->priv->gap_filler;
+}
+
 /* FIXME: Find out how to avoid doing this "hack" using the GDestroyNotify
  * function pointer in the trackelements_by_start GSequence
  *
@@ -371,7 +875,13 @@ remove_object_internal (GESTrack * track, GESTrackElement * object)
     }
   }
 
-  g_signal_handlers_disconnect_by_func (object, sort_track_elements_cb, NULL);
+  g_signal_handlers_disconnect_by_func (object, sort_track_elements_cb, track);
+  g_signal_handlers_disconnect_by_func (object, element_active_changed_cb,
+      track);
+  g_signal_handlers_disconnect_by_func (object,
+      source_child_property_changed_cb, track);
+  g_signal_handlers_disconnect_by_func (object, source_binding_changed_cb,
+      track);
 
   ges_track_element_set_track (object, NULL);
   ges_timeline_element_set_timeline (GES_TIMELINE_ELEMENT (object), NULL);
@@ -425,6 +935,15 @@ ges_track_get_property (GObject * object, guint property_id,
     case ARG_MIXING:
       g_value_set_boolean (value, track->priv->mixing);
       break;
+    case ARG_SHARED_GAP_FILLER:
+      g_value_set_boolean (value, track->priv->shared_gap_filler);
+      break;
+    case ARG_LAZY_ELEMENTS_WINDOW:
+      g_value_set_uint64 (value, track->priv->lazy_elements_window);
+      break;
+    case ARG_RELEASE_LAZY_ELEMENTS:
+      g_value_set_boolean (value, track->priv->release_lazy_elements);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
   }
@@ -449,6 +968,15 @@ ges_track_set_property (GObject * object, guint property_id,
     case ARG_MIXING:
       ges_track_set_mixing (track, g_value_get_boolean (value));
       break;
+    case ARG_SHARED_GAP_FILLER:
+      ges_track_set_shared_gap_filler (track, g_value_get_boolean (value));
+      break;
+    case ARG_LAZY_ELEMENTS_WINDOW:
+      ges_track_set_lazy_elements_window (track, g_value_get_uint64 (value));
+      break;
+    case ARG_RELEASE_LAZY_ELEMENTS:
+      ges_track_set_release_lazy_elements (track, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
   }
@@ -460,12 +988,20 @@ ges_track_dispose (GObject * object)
   GESTrack *track = (GESTrack *) object;
   GESTrackPrivate *priv = track->priv;
 
+  g_clear_pointer (&priv->passthrough_ranges, g_hash_table_unref);
+  g_hash_table_remove_all (priv->passthrough_dirty);
+
   /* Remove all TrackElements and drop our reference */
   g_hash_table_unref (priv->trackelements_iter);
   g_sequence_foreach (track->priv->trackelements_by_start,
       (GFunc) dispose_trackelements_foreach, track);
   g_sequence_free (priv->trackelements_by_start);
   g_list_free_full (priv->gaps, (GDestroyNotify) free_gap);
+  g_list_free_full (priv->spare_gaps, (GDestroyNotify) free_spare_gap);
+  if (priv->gap_filler) {
+    ges_nle_composition_remove_object (priv->composition, priv->gap_filler);
+    priv->gap_filler = NULL;
+  }
   ges_nle_object_commit (track->priv->composition, TRUE);
 
   if (priv->composition) {
@@ -490,6 +1026,11 @@ ges_track_dispose (GObject * object)
 static void
 ges_track_finalize (GObject * object)
 {
+  GESTrackPrivate *priv = GES_TRACK (object)->priv;
+
+  g_hash_table_unref (priv->passthrough_dirty);
+  g_array_unref (priv->passthrough_removed);
+
   G_OBJECT_CLASS (ges_track_parent_class)->finalize (object);
 }
 
@@ -641,6 +1182,65 @@ ges_track_class_init (GESTrackClass * klass)
   g_object_class_install_property (object_class, ARG_MIXING,
       properties[ARG_MIXING]);
 
+  /**
+   * GESTrack:shared-gap-filler:
+   *
+   * Whether the gaps between the elements of the track are all filled by
+   * a single expandable source placed below every other element, instead
+   * of having one filling source per gap. This avoids creating and
+   * changing the state of new elements each time the gaps change, which
+   * is mostly interesting on sparse timelines.
+   */
+  properties[ARG_SHARED_GAP_FILLER] =
+      g_param_spec_boolean ("shared-gap-filler", "Shared gap filler",
+      "Whether a single source fills all the gaps of the track", FALSE,
+      G_PARAM_READWRITE);
+  g_object_class_install_property (object_class, ARG_SHARED_GAP_FILLER,
+      properties[ARG_SHARED_GAP_FILLER]);
+
+  /**
+   * GESTrack:lazy-elements-window:
+   *
+   * When set, the GStreamer elements of the sources that support it, like
+   * the #GESUriClip ones, are only created when they are about to be
+   * played, and are released once they are further than that distance from
+   * the playback position. %GST_CLOCK_TIME_NONE, the default, means that
+   * they are created as soon as they are added to the track. See
+   * #GESTrack:release-lazy-elements to create them lazily without ever
+   * releasing them.
+   *
+   * It only applies to the elements added to the track after it is set.
+   *
+   * The elements are requested ahead of time for the sources starting
+   * within that window after the playback position, and created from the
+   * default #GMainContext, so it has to be iterated while the track is
+   * prerolling and playing. The track waits for the elements it needs
+   * without blocking its streaming thread. It is also taken care of while
+   * waiting in ges_timeline_commit_sync().
+   */
+  properties[ARG_LAZY_ELEMENTS_WINDOW] =
+      g_param_spec_uint64 ("lazy-elements-window", "Lazy elements window",
+      "Distance from the playback position beyond which the elements created"
+      " on demand are released", 0, G_MAXUINT64, GST_CLOCK_TIME_NONE,
+      G_PARAM_READWRITE);
+  g_object_class_install_property (object_class, ARG_LAZY_ELEMENTS_WINDOW,
+      properties[ARG_LAZY_ELEMENTS_WINDOW]);
+
+  /**
+   * GESTrack:release-lazy-elements:
+   *
+   * Whether the elements created on demand, see
+   * #GESTrack:lazy-elements-window, are released once they are further
+   * than that window from the playback position. When %FALSE they are
+   * kept around once created.
+   */
+  properties[ARG_RELEASE_LAZY_ELEMENTS] =
+      g_param_spec_boolean ("release-lazy-elements", "Release lazy elements",
+      "Whether the elements created on demand get released", TRUE,
+      G_PARAM_READWRITE);
+  g_object_class_install_property (object_class, ARG_RELEASE_LAZY_ELEMENTS,
+      properties[ARG_RELEASE_LAZY_ELEMENTS]);
+
   gst_element_class_add_static_pad_template (gstelement_class,
       &ges_track_src_pad_template);
 
@@ -695,6 +1295,13 @@ ges_track_init (GESTrack * self)
   self->priv->gaps = NULL;
   self->priv->mixing = TRUE;
   self->priv->restriction_caps = NULL;
+  self->priv->lazy_elements_window = GST_CLOCK_TIME_NONE;
+  self->priv->release_lazy_elements = TRUE;
+  self->priv->preview_scale = 1.0;
+  self->priv->passthrough_dirty =
+      g_hash_table_new (g_direct_hash, g_direct_equal);
+  self->priv->passthrough_removed =
+      g_array_new (FALSE, FALSE, sizeof (GapRange));
 
   g_signal_connect (G_OBJECT (self->priv->composition), "notify::duration",
       G_CALLBACK (composition_duration_cb), self);
@@ -771,6 +1378,89 @@ ges_track_set_timeline (GESTrack * track, GESTimeline * timeline)
   track_resort_and_fill_gaps (track);
 }
 
+/* The restriction caps only concern raw streams, the encoded ones the track
+ * accepts when smart rendering are output as they are */
+static void
+_update_capsfilter_caps (GESTrack * track)
+{
+  guint i;
+  GstCaps *caps;
+  GESTrackPrivate *priv = track->priv;
+
+  if (!priv->restriction_caps)
+    return;
+
+  caps = gst_caps_copy (priv->restriction_caps);
+  if (priv->preview_scale != 1.0) {
+    for (i = 0; i < gst_caps_get_size (caps); i++) {
+      gint width, height;
+      GstStructure *structure = gst_caps_get_structure (caps, i);
+
+      if (gst_structure_get_int (structure, "width", &width))
+        gst_structure_set (structure, "width", G_TYPE_INT,
+            _ges_scale_video_size (width, priv->preview_scale), NULL);
+      if (gst_structure_get_int (structure, "height", &height))
+        gst_structure_set (structure, "height", G_TYPE_INT,
+            _ges_scale_video_size (height, priv->preview_scale), NULL);
+    }
+  }
+
+  for (i = 0; priv->caps && i < gst_caps_get_size (priv->caps); i++) {
+    GstStructure *structure = gst_caps_get_structure (priv->caps, i);
+
+    if (!g_str_has_suffix (gst_structure_get_name (structure), "/x-raw"))
+      gst_caps_append_structure (caps, gst_structure_copy (structure));
+  }
+
+  g_object_set (priv->capsfilter, "caps", caps, NULL);
+  gst_caps_unref (caps);
+}
+
+/* Sizes are kept even as most raw formats are subsampled */
+gint
+_ges_scale_video_size (gint size, gdouble scale)
+{
+  gint scaled;
+
+  if (scale == 1.0 || size <= 0)
+    return size;
+
+  scaled = ((gint) (size * scale + 1.0)) & ~1;
+
+  return MAX (scaled, 2);
+}
+
+void
+ges_track_set_preview_scale (GESTrack * track, gdouble scale)
+{
+  GSequenceIter *it;
+
+  g_return_if_fail (GES_IS_TRACK (track));
+  g_return_if_fail (scale > 0.0 && scale <= 1.0);
+
+  if (track->priv->preview_scale == scale)
+    return;
+
+  GST_DEBUG_OBJECT (track, "Setting preview scale to %f", scale);
+  track->priv->preview_scale = scale;
+  _update_capsfilter_caps (track);
+
+  /* Let the frame positioners follow the new output size */
+  for (it = g_sequence_get_begin_iter (track->priv->trackelements_by_start);
+      !g_sequence_iter_is_end (it); it = g_sequence_iter_next (it)) {
+    if (GES_IS_VIDEO_SOURCE (g_sequence_get (it)))
+      ges_video_source_sync_preview_scale (g_sequence_get (it));
+  }
+}
+
+gdouble
+ges_track_get_preview_scale (GESTrack * track)
+{
+  g_return_val_if_fail (GES_IS_TRACK (track), 1.0);
+
+  return track->priv->preview_scale;
+}
+
 /**
  * ges_track_set_caps:
  * @track: a #GESTrack
@@ -802,6 +1492,8 @@ ges_track_set_caps (GESTrack * track, const GstCaps * caps)
     gst_caps_set_features (priv->caps, i, gst_caps_features_new_any ());
 
   g_object_set (priv->composition, "caps", caps, NULL);
+  _update_capsfilter_caps (track);
+  mark_passthrough_outdated (track);
   /* FIXME : update all trackelements ? */
 }
 
@@ -828,7 +1520,7 @@ ges_track_set_restriction_caps (GESTrack * track, const GstCaps * caps)
     gst_caps_unref (priv->restriction_caps);
   priv->restriction_caps = gst_caps_copy (caps);
 
-  g_object_set (priv->capsfilter, "caps", caps, NULL);
+  _update_capsfilter_caps (track);
 
   g_object_notify (G_OBJECT (track), "restriction-caps");
 }
@@ -914,10 +1606,37 @@ ges_track_set_mixing (GESTrack * track, gboolean mixing)
   }
 
   track->priv->mixing = mixing;
+  mark_passthrough_outdated (track);
 
   GST_DEBUG_OBJECT (track, "The track has been set to mixing = %d", mixing);
 }
 
+/**
+ * ges_track_set_shared_gap_filler:
+ * @track: a #GESTrack
+ * @shared: TRUE if all the gaps should be filled by a single source
+ *
+ * Sets whether the gaps of the #GESTrack should all be filled by a single
+ * source. See #GESTrack:shared-gap-filler.
+ */
+void
+ges_track_set_shared_gap_filler (GESTrack * track, gboolean shared)
+{
+  g_return_if_fail (GES_IS_TRACK (track));
+
+  if (shared == track->priv->shared_gap_filler)
+    return;
+
+  GST_DEBUG_OBJECT (track, "Setting shared gap filler to %d", shared);
+  track->priv->shared_gap_filler = shared;
+
+  if (track->priv->updating == TRUE)
+    update_gaps (track);
+
+  g_object_notify_by_pspec (G_OBJECT (track),
+      properties[ARG_SHARED_GAP_FILLER]);
+}
+
 /**
  * ges_track_add_element:
  * @track: a #GESTrack
@@ -975,15 +1694,30 @@ ges_track_add_element (GESTrack * track, GESTrackElement * object)
   g_signal_emit (track, ges_track_signals[TRACK_ELEMENT_ADDED], 0,
       GES_TRACK_ELEMENT (object));
 
-  g_signal_connect (GES_TRACK_ELEMENT (object), "notify::start",
+  g_signal_connect (GES_TRACK_ELEMENT (object), "internal-notify::start",
       G_CALLBACK (sort_track_elements_cb), track);
 
-  g_signal_connect (GES_TRACK_ELEMENT (object), "notify::duration",
+  g_signal_connect (GES_TRACK_ELEMENT (object), "internal-notify::duration",
       G_CALLBACK (sort_track_elements_cb), track);
 
-  g_signal_connect (GES_TRACK_ELEMENT (object), "notify::priority",
+  g_signal_connect (GES_TRACK_ELEMENT (object), "internal-notify::priority",
       G_CALLBACK (sort_track_elements_cb), track);
 
+  g_signal_connect (GES_TRACK_ELEMENT (object), "notify::active",
+      G_CALLBACK (element_active_changed_cb), track);
+
+  if (GES_IS_SOURCE (object)) {
+    g_signal_connect (object, "deep-notify",
+        G_CALLBACK (source_child_property_changed_cb), track);
+    g_signal_connect (object, "control-binding-added",
+        G_CALLBACK (source_binding_changed_cb), track);
+    g_signal_connect (object, "control-binding-removed",
+        G_CALLBACK (source_binding_changed_cb), track);
+  }
+
+  update_max_element_duration (track, object);
+  mark_passthrough_dirty (track, object);
+
   return TRUE;
 }
 
@@ -1036,8 +1770,19 @@ ges_track_remove_element (GESTrack * track, GESTrackElement * object)
 
   GST_DEBUG_OBJECT (track, "Removing %" GST_PTR_FORMAT, object);
 
+  /* The sources @object was overlapping need to be evaluated again */
+  if (priv->passthrough_ranges) {
+    GapRange *range = g_hash_table_lookup (priv->passthrough_ranges, object);
+
+    if (range)
+      g_array_append_val (priv->passthrough_removed, *range);
+    g_hash_table_remove (priv->passthrough_ranges, object);
+    g_hash_table_remove (priv->passthrough_dirty, object);
+  }
+
   it = g_hash_table_lookup (priv->trackelements_iter, object);
   g_sequence_remove (it);
+  g_hash_table_remove (priv->trackelements_iter, object);
   track_resort_and_fill_gaps (track);
 
   if (remove_object_internal (track, object) == TRUE) {
@@ -1049,6 +1794,7 @@ ges_track_remove_element (GESTrack * track, GESTrackElement * object)
   g_hash_table_insert (track->priv->trackelements_iter, object,
       g_sequence_insert_sorted (track->priv->trackelements_by_start, object,
           (GCompareDataFunc) element_start_compare, NULL));
+  mark_passthrough_dirty (track, object);
 
   return FALSE;
 }
@@ -1101,6 +1847,113 @@ ges_track_get_mixing (GESTrack * track)
   return track->priv->mixing;
 }
 
+/**
+ * ges_track_get_shared_gap_filler:
+ * @track: a #GESTrack
+ *
+ * Gets whether the gaps of the #GESTrack are all filled by a single source.
+ *
+ * Returns: %TRUE if a single source fills all the gaps, %FALSE otherwise.
+ */
+gboolean
+ges_track_get_shared_gap_filler (GESTrack * track)
+{
+  g_return_val_if_fail (GES_IS_TRACK (track), FALSE);
+
+  return track->priv->shared_gap_filler;
+}
+
+static void
+_update_release_window (GESTrack * track)
+{
+  g_object_set (track->priv->composition, "release-window",
+      track->priv->release_lazy_elements ? track->priv->lazy_elements_window
+      : GST_CLOCK_TIME_NONE, "request-window",
+      track->priv->lazy_elements_window, NULL);
+}
+
+/**
+ * ges_track_set_lazy_elements_window:
+ * @track: a #GESTrack
+ * @window: the release window, %GST_CLOCK_TIME_NONE to create the elements
+ * as soon as they are added
+ *
+ * Sets the #GESTrack:lazy-elements-window of @track.
+ */
+void
+ges_track_set_lazy_elements_window (GESTrack * track, GstClockTime window)
+{
+  g_return_if_fail (GES_IS_TRACK (track));
+
+  if (window == track->priv->lazy_elements_window)
+    return;
+
+  GST_DEBUG_OBJECT (track, "Setting lazy elements window to %"
+      GST_TIME_FORMAT, GST_TIME_ARGS (window));
+  track->priv->lazy_elements_window = window;
+  _update_release_window (track);
+
+  g_object_notify_by_pspec (G_OBJECT (track),
+      properties[ARG_LAZY_ELEMENTS_WINDOW]);
+}
+
+/**
+ * ges_track_get_lazy_elements_window:
+ * @track: a #GESTrack
+ *
+ * Gets the #GESTrack:lazy-elements-window of @track.
+ *
+ * Returns: The distance from the playback position beyond which the
+ * elements created on demand are released, %GST_CLOCK_TIME_NONE if they
+ * are not created on demand.
+ */
+GstClockTime
+ges_track_get_lazy_elements_window (GESTrack * track)
+{
+  g_return_val_if_fail (GES_IS_TRACK (track), GST_CLOCK_TIME_NONE);
+
+  return track->priv->lazy_elements_window;
+}
+
+/**
+ * ges_track_set_release_lazy_elements:
+ * @track: a #GESTrack
+ * @release: whether the elements created on demand get released
+ *
+ * Sets the #GESTrack:release-lazy-elements of @track.
+ */
+void
+ges_track_set_release_lazy_elements (GESTrack * track, gboolean release)
+{
+  g_return_if_fail (GES_IS_TRACK (track));
+
+  if (!release == !track->priv->release_lazy_elements)
+    return;
+
+  track->priv->release_lazy_elements = release;
+  _update_release_window (track);
+
+  g_object_notify_by_pspec (G_OBJECT (track),
+      properties[ARG_RELEASE_LAZY_ELEMENTS]);
+}
+
+/**
+ * ges_track_get_release_lazy_elements:
+ * @track: a #GESTrack
+ *
+ * Gets the #GESTrack:release-lazy-elements of @track.
+ *
+ * Returns: %TRUE if the elements created on demand get released, %FALSE
+ * otherwise.
+ */
+gboolean
+ges_track_get_release_lazy_elements (GESTrack * track)
+{
+  g_return_val_if_fail (GES_IS_TRACK (track), FALSE);
+
+  return track->priv->release_lazy_elements;
+}
+
 /**
  * ges_track_commit:
  * @track: a #GESTrack
@@ -1123,6 +1976,10 @@ ges_track_commit (GESTrack * track)
 
   track_resort_and_fill_gaps (track);
 
+  /* Whether sources can pass their encoded streams through depends on
+   * what overlaps them */
+  update_passthrough (track);
+
   return ges_nle_object_commit (track->priv->composition, TRUE);
 }
 
@@ -102,6 +102,18 @@ void               ges_track_set_mixing                      (GESTrack *track, g
 GES_API
 gboolean           ges_track_get_mixing                      (GESTrack *track);
 GES_API
+void               ges_track_set_shared_gap_filler           (GESTrack *track, gboolean shared);
+GES_API
+gboolean           ges_track_get_shared_gap_filler           (GESTrack *track);
+GES_API
+void               ges_track_set_lazy_elements_window        (GESTrack *track, GstClockTime window);
+GES_API
+GstClockTime       ges_track_get_lazy_elements_window        (GESTrack *track);
+GES_API
+void               ges_track_set_release_lazy_elements       (GESTrack *track, gboolean release);
+GES_API
+gboolean           ges_track_get_release_lazy_elements       (GESTrack *track);
+GES_API
 void               ges_track_set_restriction_caps            (GESTrack *track, const GstCaps *caps);
 GES_API
 void               ges_track_update_restriction_caps         (GESTrack *track, const GstCaps *caps);
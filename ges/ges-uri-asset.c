@@ -27,20 +27,57 @@
  * the media file to use inside the GStreamer Editing Services. It has APIs that
  * let you get information about the medias. Also, the tags found in the media file are
  * set as Metadatas of the Asser.
+ *
+ * Assets are discovered in parallel by a pool of #GstDiscoverer, the
+ * maximum number of discoverers running at the same time can be set with
+ * #ges_uri_clip_asset_class_set_discoverer_pool_size or through the
+ * `GES_DISCOVERY_POOL_SIZE` environment variable, it defaults to the number
+ * of processors, up to 8.
+ *
+ * The result of the discovery of local files is cached on disk, in the user
+ * cache directory or in the directory set in the
+ * `GES_DISCOVERY_CACHE_DIR` environment variable, so that media files are
+ * not discovered again until they get modified. Setting
+ * `GES_DISCOVERY_CACHE_DIR` to an empty string disables that cache.
  */
 #include <errno.h>
+#include <glib/gstdio.h>
 #include <gst/pbutils/pbutils.h>
 #include "ges.h"
 #include "ges-internal.h"
 #include "ges-track-element-asset.h"
 
 #define DEFAULT_DISCOVERY_TIMEOUT (60 * GST_SECOND)
+#define MAX_DEFAULT_DISCOVERER_POOL_SIZE 8
+
+/* To be bumped whenever the format of the discovery cache entries changes */
+#define DISCOVERY_CACHE_VERSION 1
+#define DISCOVERY_CACHE_ENTRY_TYPE "(usttv)"
 
 static GHashTable *parent_newparent_table = NULL;
 
-static GstDiscoverer *discoverer = NULL;
 static GstDiscoverer *sync_discoverer = NULL;
 
+/* Asynchronous discoverers, each of them discovering one URI at a time. New
+ * ones are created when they are all busy, up to discoverer_pool_size */
+typedef struct
+{
+  GstDiscoverer *discoverer;
+
+  /* The URI being discovered, NULL when idle */
+  gchar *uri;
+} PooledDiscoverer;
+
+G_LOCK_DEFINE_STATIC (discoverer_pool);
+static GPtrArray *discoverer_pool = NULL;
+static guint discoverer_pool_size = 1;
+static GQueue pending_uris = G_QUEUE_INIT;
+/* URIs pending or being discovered, so they are discovered only once */
+static GHashTable *queued_uris = NULL;
+static GstClockTime discovery_timeout = DEFAULT_DISCOVERY_TIMEOUT;
+/* The context the discovered signals are emitted in */
+static GMainContext *discovery_context = NULL;
+
 static void
 initable_iface_init (GInitableIface * initable_iface)
 {
@@ -64,7 +101,9 @@ enum
 static GParamSpec *properties[PROP_LAST];
 
 static void discoverer_discovered_cb (GstDiscoverer * discoverer,
-    GstDiscovererInfo * info, GError * err, gpointer user_data);
+    GstDiscovererInfo * info, GError * err, PooledDiscoverer * pooled);
+static void _set_discovered_info (GESUriClipAsset * self,
+    GstDiscovererInfo * info);
 
 struct _GESUriClipAssetPrivate
 {
@@ -114,22 +153,191 @@ ges_uri_clip_asset_set_property (GObject * object, guint property_id,
   }
 }
 
+/******************************
+ *       Discoverer pool      *
+ ******************************/
+/* Must be called with the discoverer_pool lock */
+static PooledDiscoverer *
+_pooled_discoverer_new (GError ** error)
+{
+  PooledDiscoverer *pooled;
+  GstDiscoverer *discoverer = gst_discoverer_new (discovery_timeout, error);
+
+  if (!discoverer)
+    return NULL;
+
+  pooled = g_slice_new0 (PooledDiscoverer);
+  pooled->discoverer = discoverer;
+  g_signal_connect (discoverer, "discovered",
+      G_CALLBACK (discoverer_discovered_cb), pooled);
+
+  /* We just start the discoverer and let it live */
+  g_main_context_push_thread_default (discovery_context);
+  gst_discoverer_start (discoverer);
+  g_main_context_pop_thread_default (discovery_context);
+
+  g_ptr_array_add (discoverer_pool, pooled);
+
+  return pooled;
+}
+
+static void
+_pooled_discoverer_free (PooledDiscoverer * pooled)
+{
+  g_signal_handlers_disconnect_by_data (pooled->discoverer, pooled);
+  gst_object_unref (pooled->discoverer);
+  g_free (pooled->uri);
+
+  g_slice_free (PooledDiscoverer, pooled);
+}
+
+/* Marks @pooled as idle, returns the URI it was discovering */
+static gchar *
+_pooled_discoverer_release (PooledDiscoverer * pooled)
+{
+  gchar *uri;
+
+  G_LOCK (discoverer_pool);
+  uri = pooled->uri;
+  pooled->uri = NULL;
+  g_hash_table_remove (queued_uris, uri);
+  G_UNLOCK (discoverer_pool);
+
+  return uri;
+}
+
+typedef struct
+{
+  gchar *uri;
+  GError *error;
+} LoadingError;
+
+static gboolean
+_report_loading_error_cb (LoadingError * data)
+{
+  ges_asset_cache_set_loaded (GES_TYPE_URI_CLIP, data->uri, data->error);
+
+  g_free (data->uri);
+  g_error_free (data->error);
+  g_slice_free (LoadingError, data);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Hands the pending URIs over to the idle discoverers, creating new ones if
+ * needed and possible */
+static void
+_discoverer_pool_dispatch (void)
+{
+  guint i;
+  gboolean failed = FALSE;
+  GList *tmp, *assigned = NULL;
+
+  G_LOCK (discoverer_pool);
+  for (i = 0; !g_queue_is_empty (&pending_uris); i++) {
+    PooledDiscoverer *pooled;
+
+    if (i < discoverer_pool->len) {
+      pooled = g_ptr_array_index (discoverer_pool, i);
+      if (pooled->uri)
+        continue;
+    } else if (discoverer_pool->len < discoverer_pool_size) {
+      GError *err = NULL;
+
+      pooled = _pooled_discoverer_new (&err);
+      if (!pooled) {
+        GST_ERROR ("Could not create discoverer: %s", err->message);
+        g_error_free (err);
+        break;
+      }
+    } else {
+      break;
+    }
+
+    pooled->uri = g_queue_pop_head (&pending_uris);
+    assigned = g_list_prepend (assigned, pooled);
+  }
+  G_UNLOCK (discoverer_pool);
+
+  /* Not holding the lock as the discovered signal might be emitted right
+   * away */
+  for (tmp = assigned; tmp; tmp = tmp->next) {
+    PooledDiscoverer *pooled = tmp->data;
+    gchar *uri = g_strdup (pooled->uri);
+
+    GST_DEBUG ("Discovering %s with %" GST_PTR_FORMAT, uri,
+        pooled->discoverer);
+    if (!gst_discoverer_discover_uri_async (pooled->discoverer, uri)) {
+      LoadingError *data = g_slice_new (LoadingError);
+
+      data->uri = uri;
+      data->error = g_error_new (GES_ERROR, GES_ERROR_ASSET_LOADING,
+          "Could not start discovering %s", uri);
+
+      /* Reported from the main loop, like discovery results, as we might be
+       * called from _start_loading */
+      g_free (_pooled_discoverer_release (pooled));
+      g_idle_add ((GSourceFunc) _report_loading_error_cb, data);
+      failed = TRUE;
+    } else {
+      g_free (uri);
+    }
+  }
+  g_list_free (assigned);
+
+  /* Failing discoverers are idle again */
+  if (failed)
+    _discoverer_pool_dispatch ();
+}
+
+GList *
+ges_discoverer_pool_get_discoverers (void)
+{
+  guint i;
+  GList *discoverers = NULL;
+
+  G_LOCK (discoverer_pool);
+  for (i = 0; i < discoverer_pool->len; i++) {
+    PooledDiscoverer *pooled = g_ptr_array_index (discoverer_pool, i);
+
+    discoverers = g_list_prepend (discoverers,
+        gst_object_ref (pooled->discoverer));
+  }
+  G_UNLOCK (discoverer_pool);
+
+  return discoverers;
+}
+
 static GESAssetLoadingReturn
 _start_loading (GESAsset * asset, GError ** error)
 {
-  gboolean ret;
   const gchar *uri;
-  GESUriClipAssetClass *class = GES_URI_CLIP_ASSET_GET_CLASS (asset);
+  GstDiscovererInfo *info;
 
   GST_DEBUG ("Started loading %p", asset);
 
   uri = ges_asset_get_id (asset);
 
-  ret = gst_discoverer_discover_uri_async (class->discoverer, uri);
-  if (ret)
-    return GES_ASSET_LOADING_ASYNC;
+  info = ges_discovery_cache_lookup (uri);
+  if (info) {
+    _set_discovered_info (GES_URI_CLIP_ASSET (asset), info);
+    gst_discoverer_info_unref (info);
+
+    return GES_ASSET_LOADING_OK;
+  }
 
-  return GES_ASSET_LOADING_ERROR;
+  G_LOCK (discoverer_pool);
+  if (!g_hash_table_contains (queued_uris, uri)) {
+    g_hash_table_add (queued_uris, g_strdup (uri));
+    g_queue_push_tail (&pending_uris, g_strdup (uri));
+  } else {
+    GST_DEBUG ("%s is already being discovered", uri);
+  }
+  G_UNLOCK (discoverer_pool);
+
+  _discoverer_pool_dispatch ();
+
+  return GES_ASSET_LOADING_ASYNC;
 }
 
 static gboolean
@@ -188,9 +396,9 @@ _asset_proxied (GESAsset * self, const gchar * new_uri)
 static void
 ges_uri_clip_asset_class_init (GESUriClipAssetClass * klass)
 {
-  GError *err;
+  GError *err = NULL;
   GstClockTime timeout;
-  const gchar *timeout_str;
+  const gchar *timeout_str, *pool_size_str;
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
   g_type_class_add_private (klass, sizeof (GESUriClipAssetPrivate));
 
@@ -223,21 +431,41 @@ ges_uri_clip_asset_class_init (GESUriClipAssetClass * klass)
 
   if (errno)
     timeout = DEFAULT_DISCOVERY_TIMEOUT;
-
-  if (!discoverer) {
-    discoverer = gst_discoverer_new (timeout, &err);
-    if (!discoverer) {
+  discovery_timeout = timeout;
+
+  pool_size_str = g_getenv ("GES_DISCOVERY_POOL_SIZE");
+  if (pool_size_str)
+    discoverer_pool_size = g_ascii_strtoull (pool_size_str, NULL, 10);
+  if (!pool_size_str || !discoverer_pool_size)
+    discoverer_pool_size = MIN (g_get_num_processors (),
+        MAX_DEFAULT_DISCOVERER_POOL_SIZE);
+
+  if (!discoverer_pool) {
+    discovery_context = g_main_context_ref_thread_default ();
+    discoverer_pool =
+        g_ptr_array_new_with_free_func ((GDestroyNotify)
+        _pooled_discoverer_free);
+    queued_uris = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+        NULL);
+
+    /* Other discoverers are created when needed */
+    G_LOCK (discoverer_pool);
+    if (!_pooled_discoverer_new (&err)) {
+      G_UNLOCK (discoverer_pool);
       GST_ERROR ("Could not create discoverer: %s", err->message);
       g_error_free (err);
       return;
     }
+    G_UNLOCK (discoverer_pool);
   }
 
   /* The class structure keeps weak pointers on the discoverers so they
    * can be properly cleaned up in _ges_uri_asset_cleanup(). */
   if (!klass->discoverer) {
-    klass->discoverer = discoverer;
-    g_object_add_weak_pointer (G_OBJECT (discoverer),
+    klass->discoverer =
+        ((PooledDiscoverer *) g_ptr_array_index (discoverer_pool,
+            0))->discoverer;
+    g_object_add_weak_pointer (G_OBJECT (klass->discoverer),
         (gpointer *) & klass->discoverer);
   }
 
@@ -257,11 +485,6 @@ ges_uri_clip_asset_class_init (GESUriClipAssetClass * klass)
         (gpointer *) & klass->sync_discoverer);
   }
 
-  g_signal_connect (klass->discoverer, "discovered",
-      G_CALLBACK (discoverer_discovered_cb), NULL);
-
-  /* We just start the discoverer and let it live */
-  gst_discoverer_start (klass->discoverer);
   if (parent_newparent_table == NULL) {
     parent_newparent_table = g_hash_table_new_full (g_file_hash,
         (GEqualFunc) g_file_equal, gst_object_unref, gst_object_unref);
@@ -405,25 +628,174 @@ _set_meta_foreach (const GstTagList * tags, const gchar * tag,
   }
 }
 
+/******************************
+ *       Discovery cache      *
+ ******************************/
+/* Returns NULL when the cache is disabled */
+static gchar *
+_discovery_cache_get_path (const gchar * uri)
+{
+  gchar *checksum, *filename, *path;
+  const gchar *cache_dir = g_getenv ("GES_DISCOVERY_CACHE_DIR");
+
+  if (cache_dir && !*cache_dir)
+    return NULL;
+
+  checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, uri, -1);
+  filename = g_strdup_printf ("%s.gvariant", checksum);
+  if (cache_dir)
+    path = g_build_filename (cache_dir, filename, NULL);
+  else
+    path = g_build_filename (g_get_user_cache_dir (), "gstreamer-1.0", "ges",
+        "discovery", filename, NULL);
+
+  g_free (filename);
+  g_free (checksum);
+
+  return path;
+}
+
+/* Only local files are cached, as we need to know when they change */
+static gboolean
+_discovery_cache_get_file_stamp (const gchar * uri, guint64 * size,
+    guint64 * mtime)
+{
+  GFile *file;
+  GFileInfo *file_info;
+
+  if (!gst_uri_has_protocol (uri, "file"))
+    return FALSE;
+
+  file = g_file_new_for_uri (uri);
+  file_info = g_file_query_info (file, G_FILE_ATTRIBUTE_STANDARD_SIZE ","
+      G_FILE_ATTRIBUTE_TIME_MODIFIED "," G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC,
+      G_FILE_QUERY_INFO_NONE, NULL, NULL);
+  g_object_unref (file);
+
+  if (!file_info)
+    return FALSE;
+
+  *size = g_file_info_get_attribute_uint64 (file_info,
+      G_FILE_ATTRIBUTE_STANDARD_SIZE);
+  *mtime = g_file_info_get_attribute_uint64 (file_info,
+      G_FILE_ATTRIBUTE_TIME_MODIFIED) * G_USEC_PER_SEC +
+      g_file_info_get_attribute_uint32 (file_info,
+      G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC);
+  g_object_unref (file_info);
+
+  return TRUE;
+}
+
+GstDiscovererInfo *
+ges_discovery_cache_lookup (const gchar * uri)
+{
+  gsize length;
+  guint version;
+  gchar *path, *data;
+  const gchar *cached_uri;
+  GVariant *entry, *info_variant;
+  guint64 size, mtime, cached_size, cached_mtime;
+  GstDiscovererInfo *info = NULL;
+
+  if (!_discovery_cache_get_file_stamp (uri, &size, &mtime))
+    return NULL;
+
+  path = _discovery_cache_get_path (uri);
+  if (!path)
+    return NULL;
+
+  if (!g_file_get_contents (path, &data, &length, NULL)) {
+    g_free (path);
+
+    return NULL;
+  }
+
+  entry = g_variant_ref_sink (g_variant_new_from_data (G_VARIANT_TYPE
+          (DISCOVERY_CACHE_ENTRY_TYPE), data, length, FALSE, g_free, data));
+  g_variant_get (entry, "(u&sttv)", &version, &cached_uri, &cached_size,
+      &cached_mtime, &info_variant);
+
+  if (version == DISCOVERY_CACHE_VERSION && !g_strcmp0 (cached_uri, uri) &&
+      cached_size == size && cached_mtime == mtime) {
+    GST_DEBUG ("Using cached discovery information for %s", uri);
+    info = gst_discoverer_info_from_variant (info_variant);
+  } else {
+    GST_DEBUG ("Discarding outdated cached discovery information for %s", uri);
+    g_unlink (path);
+  }
+
+  g_variant_unref (info_variant);
+  g_variant_unref (entry);
+  g_free (path);
+
+  return info;
+}
+
+void
+ges_discovery_cache_store (GstDiscovererInfo * info)
+{
+  gchar *path, *dir;
+  GError *error = NULL;
+  guint64 size, mtime;
+  GVariant *entry, *info_variant;
+  const gchar *uri = gst_discoverer_info_get_uri (info);
+
+  if (gst_discoverer_info_get_result (info) != GST_DISCOVERER_OK ||
+      !_discovery_cache_get_file_stamp (uri, &size, &mtime))
+    return;
+
+  path = _discovery_cache_get_path (uri);
+  if (!path)
+    return;
+
+  info_variant = g_variant_take_ref (gst_discoverer_info_to_variant (info,
+          GST_DISCOVERER_SERIALIZE_ALL));
+  entry = g_variant_ref_sink (g_variant_new (DISCOVERY_CACHE_ENTRY_TYPE,
+          DISCOVERY_CACHE_VERSION, uri, size, mtime, info_variant));
+
+  dir = g_path_get_dirname (path);
+  if (g_mkdir_with_parents (dir, 0755) ||
+      !g_file_set_contents (path, g_variant_get_data (entry),
+          g_variant_get_size (entry), &error)) {
+    GST_INFO ("Could not cache discovery information for %s: %s", uri,
+        error ? error->message : g_strerror (errno));
+    g_clear_error (&error);
+  }
+
+  g_free (dir);
+  g_free (path);
+  g_variant_unref (entry);
+  g_variant_unref (info_variant);
+}
+
+static void
+_set_discovered_info (GESUriClipAsset * self, GstDiscovererInfo * info)
+{
+  const GstTagList *tags = gst_discoverer_info_get_tags (info);
+
+  if (tags)
+    gst_tag_list_foreach (tags, (GstTagForeachFunc) _set_meta_foreach, self);
+
+  _set_meta_file_size (gst_discoverer_info_get_uri (info), self);
+
+  if (gst_discoverer_info_get_result (info) == GST_DISCOVERER_OK)
+    ges_uri_clip_asset_set_info (self, info);
+}
+
 static void
 discoverer_discovered_cb (GstDiscoverer * discoverer,
-    GstDiscovererInfo * info, GError * err, gpointer user_data)
+    GstDiscovererInfo * info, GError * err, PooledDiscoverer * pooled)
 {
   GError *error = NULL;
-  const GstTagList *tags;
 
   const gchar *uri = gst_discoverer_info_get_uri (info);
   GESUriClipAsset *mfs =
       GES_URI_CLIP_ASSET (ges_asset_cache_lookup (GES_TYPE_URI_CLIP, uri));
 
-  tags = gst_discoverer_info_get_tags (info);
-  if (tags)
-    gst_tag_list_foreach (tags, (GstTagForeachFunc) _set_meta_foreach, mfs);
-
-  _set_meta_file_size (uri, mfs);
+  _set_discovered_info (mfs, info);
 
   if (gst_discoverer_info_get_result (info) == GST_DISCOVERER_OK) {
-    ges_uri_clip_asset_set_info (mfs, info);
+    ges_discovery_cache_store (info);
   } else {
     if (err) {
       error = g_error_copy (err);
@@ -434,10 +806,15 @@ discoverer_discovered_cb (GstDiscoverer * discoverer,
     }
   }
 
+  /* Released before notifying about the loading so that the asset can be
+   * requested again from the callbacks */
+  g_free (_pooled_discoverer_release (pooled));
   ges_asset_cache_set_loaded (GES_TYPE_URI_CLIP, uri, error);
 
   if (error)
     g_error_free (error);
+
+  _discoverer_pool_dispatch ();
 }
 
 /* API implementation */
@@ -584,7 +961,12 @@ ges_uri_clip_asset_request_sync (const gchar * uri, GError ** error)
     g_free (first_file_uri);
     g_free (first_file);
   } else {
-    info = gst_discoverer_discover_uri (discoverer, uri, &lerror);
+    info = ges_discovery_cache_lookup (uri);
+    if (!info) {
+      info = gst_discoverer_discover_uri (discoverer, uri, &lerror);
+      if (info && !lerror)
+        ges_discovery_cache_store (info);
+    }
   }
 
   /* We might get a discoverer info but it might have a non-OK result. We
@@ -627,12 +1009,60 @@ void
 ges_uri_clip_asset_class_set_timeout (GESUriClipAssetClass * klass,
     GstClockTime timeout)
 {
+  guint i;
+
   g_return_if_fail (GES_IS_URI_CLIP_ASSET_CLASS (klass));
 
-  g_object_set (klass->discoverer, "timeout", timeout, NULL);
+  G_LOCK (discoverer_pool);
+  discovery_timeout = timeout;
+  for (i = 0; i < discoverer_pool->len; i++)
+    g_object_set (((PooledDiscoverer *) g_ptr_array_index (discoverer_pool,
+                i))->discoverer, "timeout", timeout, NULL);
+  G_UNLOCK (discoverer_pool);
+
   g_object_set (klass->sync_discoverer, "timeout", timeout, NULL);
 }
 
+/**
+ * ges_uri_clip_asset_class_set_discoverer_pool_size:
+ * @klass: The #GESUriClipAssetClass on which to set the pool size
+ * @size: The maximum number of assets to discover at the same time,
+ * must be greater than 0
+ *
+ * Sets how many #GESUriClipAsset can be loaded asynchronously at the same
+ * time. Lowering it does not interrupt the discoveries already started.
+ */
+void
+ges_uri_clip_asset_class_set_discoverer_pool_size (GESUriClipAssetClass *
+    klass, guint size)
+{
+  g_return_if_fail (GES_IS_URI_CLIP_ASSET_CLASS (klass));
+  g_return_if_fail (size > 0);
+
+  G_LOCK (discoverer_pool);
+  discoverer_pool_size = size;
+
+  /* Drop the idle discoverers we do not need anymore, always keeping the
+   * first one around as it is referenced by the class */
+  while (discoverer_pool->len > size) {
+    guint i;
+
+    for (i = discoverer_pool->len - 1; i > 0; i--) {
+      if (!((PooledDiscoverer *) g_ptr_array_index (discoverer_pool,
+                  i))->uri)
+        break;
+    }
+
+    if (!i)
+      break;
+
+    g_ptr_array_remove_index (discoverer_pool, i);
+  }
+  G_UNLOCK (discoverer_pool);
+
+  _discoverer_pool_dispatch ();
+}
+
 /**
  * ges_uri_clip_asset_get_stream_assets:
  * @self: A #GESUriClipAsset
@@ -769,6 +1199,17 @@ ges_uri_source_asset_get_filesource_asset (GESUriSourceAsset * asset)
 void
 _ges_uri_asset_cleanup (void)
 {
-  g_clear_object (&discoverer);
+  G_LOCK (discoverer_pool);
+  if (discoverer_pool) {
+    g_ptr_array_unref (discoverer_pool);
+    discoverer_pool = NULL;
+    g_hash_table_unref (queued_uris);
+    queued_uris = NULL;
+    g_queue_foreach (&pending_uris, (GFunc) g_free, NULL);
+    g_queue_clear (&pending_uris);
+    g_main_context_unref (discovery_context);
+    discovery_context = NULL;
+  }
+  G_UNLOCK (discoverer_pool);
   g_clear_object (&sync_discoverer);
 }
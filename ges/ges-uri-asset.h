@@ -85,6 +85,9 @@ GES_API
 void ges_uri_clip_asset_class_set_timeout           (GESUriClipAssetClass *klass,
                                                      GstClockTime timeout);
 GES_API
+void ges_uri_clip_asset_class_set_discoverer_pool_size (GESUriClipAssetClass *klass,
+                                                        guint size);
+GES_API
 const GList * ges_uri_clip_asset_get_stream_assets  (GESUriClipAsset *self);
 
 #define GES_TYPE_URI_SOURCE_ASSET ges_uri_source_asset_get_type()
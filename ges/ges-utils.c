@@ -103,6 +103,32 @@ element_end_compare (GESTimelineElement * a, GESTimelineElement * b)
   return 1;
 }
 
+/* Same as g_sequence_sort_changed() but does not touch the sequence if the
+ * item pointed by @iter is still sorted relatively to its neighbours, which
+ * is the common case when moving elements around */
+void
+_ges_sequence_sort_changed (GSequenceIter * iter, GCompareDataFunc cmp_func,
+    gpointer cmp_data)
+{
+  GSequenceIter *next;
+  gpointer data = g_sequence_get (iter);
+
+  if (!g_sequence_iter_is_begin (iter) &&
+      cmp_func (g_sequence_get (g_sequence_iter_prev (iter)), data,
+          cmp_data) > 0)
+    goto resort;
+
+  next = g_sequence_iter_next (iter);
+  if (!g_sequence_iter_is_end (next) &&
+      cmp_func (data, g_sequence_get (next), cmp_data) > 0)
+    goto resort;
+
+  return;
+
+resort:
+  g_sequence_sort_changed (iter, cmp_func, cmp_data);
+}
+
 gboolean
 ges_pspec_equal (gconstpointer key_spec_1, gconstpointer key_spec_2)
 {
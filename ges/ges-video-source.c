@@ -76,6 +76,11 @@
  * </tbody>
  * </tgroup>
  * </informaltable>
+ *
+ * When the stream produced by the source already is progressive and
+ * matches what the track expects, the conversion elements (videoconvert,
+ * deinterlace, videoscale and videorate) are taken out of the chain until
+ * the caps of the stream or the restriction caps of the track change.
  */
 
 #include <gst/pbutils/missing-plugins.h>
@@ -96,6 +101,186 @@ struct _GESVideoSourcePrivate
   GstElement *capsfilter;
 };
 
+/* Elements of the conversion chain of a source, which can be bypassed when
+ * the source stream already matches the caps expected downstream.
+ * Only accessed from pad probes on the queue source pad. */
+typedef struct
+{
+  GstElement *queue;
+  GstElement *videoconvert;
+  GstElement *deinterlace;
+  GstElement *positioner;
+  GstElement *videoscale;
+  GstElement *videorate;
+  GstElement *capsfilter;
+
+  gboolean bypassed;
+} ConversionChain;
+
+/* GstDeinterlaceModes value forcing deinterlacing even on progressive
+ * streams */
+#define DEINTERLACE_MODE_INTERLACED 1
+
+static void
+_conversion_chain_free (ConversionChain * chain)
+{
+  g_slice_free (ConversionChain, chain);
+}
+
+static void
+_link_elements (GstElement * src, GstElement * sink, gboolean link)
+{
+  GstPad *srcpad = gst_element_get_static_pad (src, "src");
+  GstPad *sinkpad = gst_element_get_static_pad (sink, "sink");
+
+  /* Caps are checked by the caller, and we are running from a streaming
+   * thread so avoid querying around */
+  if (link)
+    gst_pad_link_full (srcpad, sinkpad, GST_PAD_LINK_CHECK_NOTHING);
+  else
+    gst_pad_unlink (srcpad, sinkpad);
+
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+}
+
+static void
+_flush_element (GstElement * element)
+{
+  GstPad *sinkpad = gst_element_get_static_pad (element, "sink");
+
+  gst_pad_send_event (sinkpad, gst_event_new_flush_start ());
+  gst_pad_send_event (sinkpad, gst_event_new_flush_stop (TRUE));
+  gst_object_unref (sinkpad);
+}
+
+static gboolean
+_conversion_needed (ConversionChain * chain, GstCaps * caps)
+{
+  gint mode;
+  GstPad *sinkpad;
+  GstCaps *allowed;
+  gboolean needed;
+  const gchar *interlace_mode;
+
+  if (!gst_caps_is_fixed (caps))
+    return TRUE;
+
+  interlace_mode = gst_structure_get_string (gst_caps_get_structure (caps, 0),
+      "interlace-mode");
+  if (interlace_mode && g_strcmp0 (interlace_mode, "progressive"))
+    return TRUE;
+
+  if (chain->deinterlace) {
+    g_object_get (chain->deinterlace, "mode", &mode, NULL);
+    if (mode == DEINTERLACE_MODE_INTERLACED)
+      return TRUE;
+  }
+
+  /* The capsfilter is configured by the positioner from the track
+   * restriction caps, and the query also takes what the mixer accepts into
+   * account */
+  sinkpad = gst_element_get_static_pad (chain->capsfilter, "sink");
+  allowed = gst_pad_query_caps (sinkpad, NULL);
+  needed = !gst_caps_is_subset (caps, allowed);
+  gst_caps_unref (allowed);
+  gst_object_unref (sinkpad);
+
+  return needed;
+}
+
+/* Must be called while nothing flows through the queue source pad, either
+ * from one of its downstream probes or from an idle probe */
+static void
+_set_conversion_bypassed (ConversionChain * chain, gboolean bypassed)
+{
+  GstElement *last_converter =
+      chain->deinterlace ? chain->deinterlace : chain->videoconvert;
+
+  if (chain->bypassed == bypassed)
+    return;
+
+  GST_INFO_OBJECT (chain->queue, "%s conversion elements",
+      bypassed ? "Bypassing" : "Restoring");
+
+  if (bypassed) {
+    _link_elements (chain->queue, chain->videoconvert, FALSE);
+    _link_elements (last_converter, chain->positioner, FALSE);
+    _link_elements (chain->positioner, chain->videoscale, FALSE);
+    _link_elements (chain->videorate, chain->capsfilter, FALSE);
+
+    _link_elements (chain->queue, chain->positioner, TRUE);
+    _link_elements (chain->positioner, chain->capsfilter, TRUE);
+  } else {
+    _link_elements (chain->queue, chain->positioner, FALSE);
+    _link_elements (chain->positioner, chain->capsfilter, FALSE);
+
+    /* Bypassed elements did not see what flowed since, make sure they do
+     * not hold any stale state (like videorate previous buffer) */
+    _flush_element (chain->videoconvert);
+    _flush_element (chain->videoscale);
+
+    _link_elements (chain->queue, chain->videoconvert, TRUE);
+    _link_elements (last_converter, chain->positioner, TRUE);
+    _link_elements (chain->positioner, chain->videoscale, TRUE);
+    _link_elements (chain->videorate, chain->capsfilter, TRUE);
+  }
+
+  chain->bypassed = bypassed;
+}
+
+static GstPadProbeReturn
+_restore_conversion_idle_cb (GstPad * pad, GstPadProbeInfo * info,
+    ConversionChain * chain)
+{
+  GstCaps *caps = gst_pad_get_current_caps (pad);
+
+  if (caps && chain->bypassed && _conversion_needed (chain, caps))
+    _set_conversion_bypassed (chain, FALSE);
+
+  if (caps)
+    gst_caps_unref (caps);
+
+  return GST_PAD_PROBE_REMOVE;
+}
+
+static GstPadProbeReturn
+_queue_src_event_probe_cb (GstPad * pad, GstPadProbeInfo * info,
+    ConversionChain * chain)
+{
+  GstCaps *caps;
+  gboolean needed;
+  GstEvent *event = GST_PAD_PROBE_INFO_EVENT (info);
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_CAPS:
+      gst_event_parse_caps (event, &caps);
+      needed = _conversion_needed (chain, caps);
+
+      /* Nothing to do if the elements are already bypassed only when not
+       * needed */
+      if (needed != chain->bypassed)
+        break;
+
+      _set_conversion_bypassed (chain, !needed);
+
+      /* Relinking marks all sticky events as pending, they will be sent in
+       * order to the new peer with the next serialized data */
+      return GST_PAD_PROBE_DROP;
+    case GST_EVENT_RECONFIGURE:
+      /* The restriction caps or the deinterlace mode might have changed, we
+       * can not relink from here as data might be flowing */
+      if (chain->bypassed)
+        gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_IDLE,
+            (GstPadProbeCallback) _restore_conversion_idle_cb, chain, NULL);
+      break;
+    default:
+      break;
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
 /* TrackElement VMethods */
 
 static gboolean
@@ -182,14 +367,66 @@ ges_video_source_create_element (GESTrackElement * trksrc)
         capsfilter, NULL);
   }
 
+  if (videoconvert && videoscale && videorate) {
+    GstPad *queue_srcpad = gst_element_get_static_pad (queue, "src");
+    ConversionChain *chain = g_slice_new0 (ConversionChain);
+
+    /* All those elements belong to @topbin, and the probe is removed with
+     * the queue pad, no need to keep references */
+    chain->queue = queue;
+    chain->videoconvert = videoconvert;
+    chain->deinterlace = deinterlace;
+    chain->positioner = positioner;
+    chain->videoscale = videoscale;
+    chain->videorate = videorate;
+    chain->capsfilter = capsfilter;
+
+    gst_pad_add_probe (queue_srcpad, GST_PAD_PROBE_TYPE_EVENT_BOTH,
+        (GstPadProbeCallback) _queue_src_event_probe_cb, chain,
+        (GDestroyNotify) _conversion_chain_free);
+    gst_object_unref (queue_srcpad);
+  }
+
+  /* The element can be released and created again when it is created on
+   * demand, do not keep dangling pointers around */
   self->priv->positioner = GST_FRAME_POSITIONNER (positioner);
+  g_object_add_weak_pointer (G_OBJECT (positioner),
+      (gpointer *) & self->priv->positioner);
   self->priv->positioner->scale_in_compositor =
       !GES_VIDEO_SOURCE_GET_CLASS (self)->ABI.abi.disable_scale_in_compositor;
   self->priv->capsfilter = capsfilter;
+  g_object_add_weak_pointer (G_OBJECT (capsfilter),
+      (gpointer *) & self->priv->capsfilter);
 
   return topbin;
 }
 
+static void
+_set_child_property (GESTimelineElement * element, GObject * child,
+    GParamSpec * pspec, GValue * value)
+{
+  GESVideoSource *self = GES_VIDEO_SOURCE (element);
+  GstElementFactory *factory;
+
+  GES_TIMELINE_ELEMENT_CLASS (parent_class)->set_child_property (element,
+      child, pspec, value);
+
+  if (!GST_IS_ELEMENT (child) || !self->priv->capsfilter)
+    return;
+
+  /* Forcing deinterlacing requires the conversion elements to be put back,
+   * let the queue know through a reconfigure event */
+  factory = gst_element_get_factory (GST_ELEMENT (child));
+  if (factory && !g_strcmp0 (GST_OBJECT_NAME (factory), "deinterlace") &&
+      !g_strcmp0 (pspec->name, "mode")) {
+    GstPad *sinkpad = gst_element_get_static_pad (self->priv->capsfilter,
+        "sink");
+
+    gst_pad_push_event (sinkpad, gst_event_new_reconfigure ());
+    gst_object_unref (sinkpad);
+  }
+}
+
 static gboolean
 _lookup_child (GESTimelineElement * object,
     const gchar * prop_name, GObject ** element, GParamSpec ** pspec)
@@ -221,17 +458,40 @@ _lookup_child (GESTimelineElement * object,
   return res;
 }
 
+static void
+ges_video_source_dispose (GObject * object)
+{
+  GESVideoSource *self = GES_VIDEO_SOURCE (object);
+
+  if (self->priv->positioner) {
+    g_object_remove_weak_pointer (G_OBJECT (self->priv->positioner),
+        (gpointer *) & self->priv->positioner);
+    self->priv->positioner = NULL;
+  }
+
+  if (self->priv->capsfilter) {
+    g_object_remove_weak_pointer (G_OBJECT (self->priv->capsfilter),
+        (gpointer *) & self->priv->capsfilter);
+    self->priv->capsfilter = NULL;
+  }
+
+  G_OBJECT_CLASS (parent_class)->dispose (object);
+}
+
 static void
 ges_video_source_class_init (GESVideoSourceClass * klass)
 {
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
   GESTrackElementClass *track_element_class = GES_TRACK_ELEMENT_CLASS (klass);
   GESTimelineElementClass *element_class = GES_TIMELINE_ELEMENT_CLASS (klass);
   GESVideoSourceClass *video_source_class = GES_VIDEO_SOURCE_CLASS (klass);
 
   g_type_class_add_private (klass, sizeof (GESVideoSourcePrivate));
 
+  object_class->dispose = ges_video_source_dispose;
   element_class->set_priority = _set_priority;
   element_class->lookup_child = _lookup_child;
+  element_class->set_child_property = _set_child_property;
 
   track_element_class->nleobject_factorytype = "nlesource";
   track_element_class->create_element = ges_video_source_create_element;
@@ -246,3 +506,11 @@ ges_video_source_init (GESVideoSource * self)
   self->priv->positioner = NULL;
   self->priv->capsfilter = NULL;
 }
+
+/* Called by the track when its preview scale changes */
+void
+ges_video_source_sync_preview_scale (GESVideoSource * self)
+{
+  if (self->priv->positioner)
+    ges_frame_positioner_sync_from_track (self->priv->positioner);
+}
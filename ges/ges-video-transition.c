@@ -406,7 +406,7 @@ ges_video_transition_create_element (GESTrackElement * object)
   ges_video_transition_duration_changed (object,
       ges_timeline_element_get_duration (GES_TIMELINE_ELEMENT (object)));
 
-  g_signal_connect (object, "notify::duration",
+  g_signal_connect (object, "internal-notify::duration",
       G_CALLBACK (duration_changed_cb), NULL);
 
   priv->pending_type = GES_VIDEO_STANDARD_TRANSITION_TYPE_NONE;
@@ -48,20 +48,13 @@ static void
 ges_video_uri_source_track_set_cb (GESVideoUriSource * self,
     GParamSpec * arg G_GNUC_UNUSED, gpointer nothing)
 {
-  GESTrack *track;
-  const GstCaps *caps = NULL;
-
   if (!self->priv->decodebin)
     return;
 
-  track = ges_track_element_get_track (GES_TRACK_ELEMENT (self));
-  if (!track)
+  if (!ges_track_element_get_track (GES_TRACK_ELEMENT (self)))
     return;
 
-  caps = ges_track_get_caps (track);
-
-  GST_INFO_OBJECT (self, "Setting caps to: %" GST_PTR_FORMAT, caps);
-  g_object_set (self->priv->decodebin, "caps", caps, NULL);
+  ges_source_update_decodebin_caps (GES_SOURCE (self), self->priv->decodebin);
 }
 
 /* GESSource VMethod */
@@ -69,21 +62,19 @@ static GstElement *
 ges_video_uri_source_create_source (GESTrackElement * trksrc)
 {
   GESVideoUriSource *self;
-  GESTrack *track;
   GstElement *decodebin;
-  const GstCaps *caps = NULL;
 
   self = (GESVideoUriSource *) trksrc;
 
-  track = ges_track_element_get_track (trksrc);
-  if (track)
-    caps = ges_track_get_caps (track);
-
   decodebin = self->priv->decodebin = gst_element_factory_make ("uridecodebin",
       NULL);
 
-  g_object_set (decodebin, "caps", caps,
-      "expose-all-streams", FALSE, "uri", self->uri, NULL);
+  g_object_set (decodebin, "expose-all-streams", FALSE, "uri", self->uri,
+      NULL);
+  ges_source_update_decodebin_caps (GES_SOURCE (self), decodebin);
+
+  g_object_add_weak_pointer (G_OBJECT (decodebin),
+      (gpointer *) & self->priv->decodebin);
 
   return decodebin;
 }
@@ -168,6 +159,12 @@ ges_video_uri_source_dispose (GObject * object)
   if (uriclip->uri)
     g_free (uriclip->uri);
 
+  if (uriclip->priv->decodebin) {
+    g_object_remove_weak_pointer (G_OBJECT (uriclip->priv->decodebin),
+        (gpointer *) & uriclip->priv->decodebin);
+    uriclip->priv->decodebin = NULL;
+  }
+
   G_OBJECT_CLASS (ges_video_uri_source_parent_class)->dispose (object);
 }
 
@@ -193,6 +190,7 @@ ges_video_uri_source_class_init (GESVideoUriSourceClass * klass)
           NULL, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
 
   source_class->create_source = ges_video_uri_source_create_source;
+  GES_TRACK_ELEMENT_CLASS (klass)->ABI.abi.element_on_demand = TRUE;
 }
 
 static void
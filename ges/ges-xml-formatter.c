@@ -1198,6 +1198,7 @@ _save_layers (GESXmlFormatter * self, GString * str, GESTimeline * timeline)
       GList *tracks;
       gboolean serialize;
       gchar *extractable_id;
+      GESAsset *original_asset;
 
       clip = GES_CLIP (tmpclip->data);
 
@@ -1212,7 +1213,12 @@ _save_layers (GESXmlFormatter * self, GString * str, GESTimeline * timeline)
       properties = _serialize_properties (G_OBJECT (clip),
           "supported-formats", "rate", "in-point", "start", "duration",
           "max-duration", "priority", "vtype", "uri", NULL);
-      extractable_id = ges_extractable_get_id (GES_EXTRACTABLE (clip));
+      /* Clips using a proxy for previewing keep their original asset */
+      original_asset = timeline_get_clip_original_asset (timeline, clip);
+      if (original_asset)
+        extractable_id = g_strdup (ges_asset_get_id (original_asset));
+      else
+        extractable_id = ges_extractable_get_id (GES_EXTRACTABLE (clip));
       append_escaped (str,
           g_markup_printf_escaped ("        <clip id='%i' asset-id='%s'"
               " type-name='%s' layer-priority='%i' track-types='%i' start='%"
@@ -1350,7 +1356,7 @@ _save_timeline (GESXmlFormatter * self, GString * str, GESTimeline * timeline)
   gchar *properties = NULL, *metas = NULL;
 
   properties = _serialize_properties (G_OBJECT (timeline), "update", "name",
-      "async-handling", "message-forward", NULL);
+      "async-handling", "message-forward", "preview-scale", NULL);
 
   ges_meta_container_set_uint64 (GES_META_CONTAINER (timeline), "duration",
       ges_timeline_get_duration (timeline));
@@ -25,6 +25,7 @@
 #include <gst/video/video.h>
 
 #include "gstframepositioner.h"
+#include "ges-internal.h"
 
 /* We  need to define a max number of pixel so we can interpolate them */
 #define MAX_PIXELS 100000
@@ -90,7 +91,9 @@ gst_frame_positioner_update_properties (GstFramePositioner * pos,
       (!track_mixing || !pos->scale_in_compositor)) {
     caps =
         gst_caps_new_simple ("video/x-raw", "width", G_TYPE_INT,
-        pos->track_width, "height", G_TYPE_INT, pos->track_height, NULL);
+        _ges_scale_video_size (pos->track_width, pos->scale), "height",
+        G_TYPE_INT, _ges_scale_video_size (pos->track_height, pos->scale),
+        NULL);
   } else {
     caps = gst_caps_new_empty_simple ("video/x-raw");
   }
@@ -157,6 +160,7 @@ sync_properties_from_track (GstFramePositioner * pos, GESTrack * track)
 
   pos->track_width = width;
   pos->track_height = height;
+  pos->scale = ges_track_get_preview_scale (track);
 
   GST_DEBUG_OBJECT (pos, "syncing framerate from caps : %d/%d", pos->fps_n,
       pos->fps_d);
@@ -172,6 +176,13 @@ _track_restriction_changed_cb (GESTrack * track, GParamSpec * arg G_GNUC_UNUSED,
   sync_properties_from_track (pos, track);
 }
 
+void
+ges_frame_positioner_sync_from_track (GstFramePositioner * pos)
+{
+  if (pos->current_track)
+    sync_properties_from_track (pos, pos->current_track);
+}
+
 static void
 set_track (GstFramePositioner * pos)
 {
@@ -235,6 +246,8 @@ gst_frame_positioner_dispose (GObject * object)
   if (pos->track_source) {
     g_signal_handlers_disconnect_by_func (pos->track_source, _track_changed_cb,
         pos);
+    g_object_weak_unref (G_OBJECT (pos->track_source),
+        (GWeakNotify) _trk_element_weak_notify_cb, pos);
     pos->track_source = NULL;
   }
 
@@ -345,6 +358,7 @@ gst_frame_positioner_init (GstFramePositioner * framepositioner)
   framepositioner->fps_d = -1;
   framepositioner->track_width = 0;
   framepositioner->track_height = 0;
+  framepositioner->scale = 1.0;
   framepositioner->capsfilter = NULL;
   framepositioner->track_source = NULL;
   framepositioner->current_track = NULL;
@@ -518,10 +532,21 @@ gst_frame_positioner_transform_ip (GstBaseTransform * trans, GstBuffer * buf)
 
   GST_OBJECT_LOCK (framepositioner);
   meta->alpha = framepositioner->alpha;
-  meta->posx = framepositioner->posx;
-  meta->posy = framepositioner->posy;
-  meta->width = framepositioner->width;
-  meta->height = framepositioner->height;
+  if (framepositioner->scale != 1.0) {
+    gdouble scale = framepositioner->scale;
+
+    meta->posx = framepositioner->posx * scale;
+    meta->posy = framepositioner->posy * scale;
+    meta->width = _ges_scale_video_size (framepositioner->width > 0 ?
+        framepositioner->width : framepositioner->track_width, scale);
+    meta->height = _ges_scale_video_size (framepositioner->height > 0 ?
+        framepositioner->height : framepositioner->track_height, scale);
+  } else {
+    meta->posx = framepositioner->posx;
+    meta->posy = framepositioner->posy;
+    meta->width = framepositioner->width;
+    meta->height = framepositioner->height;
+  }
   meta->zorder = framepositioner->zorder;
   GST_OBJECT_UNLOCK (framepositioner);
 
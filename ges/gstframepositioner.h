@@ -54,6 +54,9 @@ struct _GstFramePositioner
   gint height;
   gint track_width;
   gint track_height;
+  /* Preview scale of the track, positions and sizes are expressed in full
+   * resolution and scaled when attached to the buffers */
+  gdouble scale;
   gint fps_n;
   gint fps_d;
 
@@ -82,6 +85,7 @@ struct _GstFramePositionerMeta {
 G_GNUC_INTERNAL void ges_frame_positioner_set_source_and_filter (GstFramePositioner *pos,
 						  GESTrackElement *trksrc,
 						  GstElement *capsfilter);
+G_GNUC_INTERNAL void ges_frame_positioner_sync_from_track (GstFramePositioner *pos);
 G_GNUC_INTERNAL GType gst_frame_positioner_get_type (void);
 G_GNUC_INTERNAL GType
 gst_frame_positioner_meta_api_get_type (void);
@@ -52,6 +52,11 @@ enum
 {
   PROP_0,
   PROP_DEACTIVATED_ELEMENTS_STATE,
+  PROP_STACK_PLAN,
+  PROP_PREFETCH_DEPTH,
+  PROP_RELEASE_WINDOW,
+  PROP_REQUEST_WINDOW,
+  PROP_INCREMENTAL_RELINK,
   PROP_LAST,
 };
 
@@ -111,6 +116,38 @@ typedef struct _Action
   gint priority;
 } Action;
 
+typedef struct
+{
+  NleObject *object;
+
+  /* Aggregated values of the subtree rooted at this node:
+   *   bound: biggest stop in the 'starts' index, smallest start in
+   *          the 'stops' index
+   *   min_priority: smallest priority of the active objects,
+   *                 G_MAXUINT32 if none is active */
+  GstClockTime bound;
+  guint32 min_priority;
+} NleIndexNode;
+
+typedef struct
+{
+  GstClockTime start;
+  GstClockTime stop;
+
+  /* The stack to use in [start, stop[, NULL if the region has been
+   * invalidated */
+  GNode *stack;
+} NleStackRegion;
+
+/* An implicit balanced binary tree laid out on an array sorted
+ * the same way as one of the objects_start/objects_stop lists,
+ * the subtree covering [lo, hi[ being rooted at (lo + hi) / 2 */
+typedef struct
+{
+  NleIndexNode *nodes;
+  guint len;
+} NleIndexTree;
+
 struct _NleCompositionPrivate
 {
   gboolean dispose_has_run;
@@ -128,6 +165,19 @@ struct _NleCompositionPrivate
   GList *objects_stop;
   GHashTable *objects_hash;
 
+  /* Interval indexes mirroring objects_start and objects_stop so that
+   * stacks can be looked up without walking the whole lists. They are
+   * rebuilt lazily, next time they are used after the content or
+   * ordering of the lists changed */
+  NleIndexTree starts_index;
+  NleIndexTree stops_index;
+  gboolean index_dirty;
+
+  /* Sorted array of NleStackRegion covering the composition, only
+   * maintained when use_stack_plan is set */
+  gboolean use_stack_plan;
+  GArray *stack_plan;
+
   /* List of NleObject to be inserted or removed from the composition on the
    * next commit */
   GHashTable *pending_io;
@@ -189,6 +239,25 @@ struct _NleCompositionPrivate
 
   GstElement *current_bin;
 
+  /* Bin in which the sources of the upcoming stacks get prepared, and the
+   * number of upcoming stacks to prepare */
+  GstElement *prefetch_bin;
+  guint prefetch_depth;
+
+  /* Sources whose element was created on demand when they got used, the
+   * distance from the current stack beyond which their element is released
+   * and the one after it within which it is requested ahead of time */
+  GHashTable *on_demand_sources;
+  GstClockTime release_window;
+  GstClockTime request_window;
+
+  /* Set with the actions lock when the last update_pipeline() is waiting
+   * for the elements of some of its sources, along with its arguments */
+  gboolean waiting_for_elements;
+  GstClockTime pending_update_time;
+  gint32 pending_update_seqnum;
+  NleUpdateStackReason pending_update_reason;
+
   gboolean seeking_itself;
   gint real_eos_seqnum;
   gint next_eos_seqnum;
@@ -200,6 +269,17 @@ struct _NleCompositionPrivate
 
   gboolean tearing_down_stack;
 
+  /* Whether the subtrees shared by two successive stacks keep running when
+   * switching from one to the other */
+  gboolean incremental_relink;
+
+  /* Objects of the current stack that keep running in the stack being set
+   * up, mapped to whether they come from prefetch_bin, and the roots of the
+   * subtrees they form. Only set while relinking the new stack
+   * incrementally */
+  GHashTable *kept_objects;
+  GList *kept_roots;
+
   NleUpdateStackReason updating_reason;
 };
 
@@ -258,6 +338,17 @@ static gboolean _nle_composition_remove_object (NleComposition * comp,
     NleObject * object);
 static void _deactivate_stack (NleComposition * comp,
     gboolean flush_downstream);
+static gboolean are_same_stacks (GNode * stack1, GNode * stack2);
+static void _prefetch_upcoming_stacks (NleComposition * comp);
+static void _release_on_demand_elements (NleComposition * comp);
+static void _request_upcoming_elements (NleComposition * comp);
+static gboolean _request_source_element (NleComposition * comp,
+    NleObject * object);
+static void _source_element_added_cb (GstBin * source, GstElement * element,
+    NleComposition * comp);
+static void _elements_ready_func (NleComposition * comp, gpointer udata);
+static void _release_prefetched_stack_objects (NleComposition * comp,
+    GNode * stack);
 static gboolean _set_real_eos_seqnum_from_seek (NleComposition * comp,
     GstEvent * event);
 static void _emit_commited_signal_func (NleComposition * comp, gpointer udata);
@@ -267,6 +358,13 @@ _add_action (NleComposition * comp, GCallback func, gpointer data,
     gint priority);
 static gboolean
 _is_ready_to_restart_task (NleComposition * comp, GstEvent * event);
+static void _index_tree_clear (NleIndexTree * tree);
+static void _stack_region_clear (NleStackRegion * region);
+static void _stack_plan_invalidate_range (NleComposition * comp,
+    GstClockTime start, GstClockTime stop);
+static void _stack_plan_invalidate_object (NleComposition * comp,
+    NleObject * object);
+static void _update_stack_plan (NleComposition * comp);
 
 
 /* COMP_REAL_START: actual position to start current playback at. */
@@ -628,8 +726,14 @@ _commit_values (NleComposition * comp)
   NleCompositionPrivate *priv = comp->priv;
 
   for (tmp = priv->objects_start; tmp; tmp = tmp->next) {
-    if (nle_object_commit (tmp->data, TRUE))
+    NleObject *object = tmp->data;
+    GstClockTime start = object->start, stop = object->stop;
+
+    if (nle_object_commit (object, TRUE)) {
+      _stack_plan_invalidate_range (comp, start, stop);
+      _stack_plan_invalidate_object (comp, object);
       commited = TRUE;
+    }
   }
 
   GST_DEBUG_OBJECT (comp, "Linking up commit vmethod");
@@ -657,6 +761,7 @@ _commit_all_values (NleComposition * comp)
       (priv->objects_start, (GCompareFunc) objects_start_compare);
   priv->objects_stop = g_list_sort
       (priv->objects_stop, (GCompareFunc) objects_stop_compare);
+  priv->index_dirty = TRUE;
 
   return TRUE;
 }
@@ -671,6 +776,7 @@ _initialize_stack_func (NleComposition * comp, UpdateCompositionData * ucompo)
 
   _commit_all_values (comp);
   update_start_stop_duration (comp);
+  _update_stack_plan (comp);
   comp->priv->next_base_time = 0;
   /* set ghostpad target */
   if (!(update_pipeline (comp, COMP_REAL_START (comp),
@@ -957,6 +1063,62 @@ nle_composition_handle_message (GstBin * bin, GstMessage * message)
   GST_BIN_CLASS (parent_class)->handle_message (bin, message);
 }
 
+static void
+nle_composition_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  NleComposition *comp = (NleComposition *) object;
+
+  switch (prop_id) {
+    case PROP_STACK_PLAN:
+      comp->priv->use_stack_plan = g_value_get_boolean (value);
+      break;
+    case PROP_PREFETCH_DEPTH:
+      comp->priv->prefetch_depth = g_value_get_uint (value);
+      break;
+    case PROP_RELEASE_WINDOW:
+      comp->priv->release_window = g_value_get_uint64 (value);
+      break;
+    case PROP_REQUEST_WINDOW:
+      comp->priv->request_window = g_value_get_uint64 (value);
+      break;
+    case PROP_INCREMENTAL_RELINK:
+      comp->priv->incremental_relink = g_value_get_boolean (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+nle_composition_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  NleComposition *comp = (NleComposition *) object;
+
+  switch (prop_id) {
+    case PROP_STACK_PLAN:
+      g_value_set_boolean (value, comp->priv->use_stack_plan);
+      break;
+    case PROP_PREFETCH_DEPTH:
+      g_value_set_uint (value, comp->priv->prefetch_depth);
+      break;
+    case PROP_RELEASE_WINDOW:
+      g_value_set_uint64 (value, comp->priv->release_window);
+      break;
+    case PROP_REQUEST_WINDOW:
+      g_value_set_uint64 (value, comp->priv->request_window);
+      break;
+    case PROP_INCREMENTAL_RELINK:
+      g_value_set_boolean (value, comp->priv->incremental_relink);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
 static void
 nle_composition_class_init (NleCompositionClass * klass)
 {
@@ -980,6 +1142,8 @@ nle_composition_class_init (NleCompositionClass * klass)
 
   gobject_class->dispose = GST_DEBUG_FUNCPTR (nle_composition_dispose);
   gobject_class->finalize = GST_DEBUG_FUNCPTR (nle_composition_finalize);
+  gobject_class->set_property = nle_composition_set_property;
+  gobject_class->get_property = nle_composition_get_property;
 
   gstelement_class->change_state = nle_composition_change_state;
 
@@ -1001,6 +1165,76 @@ nle_composition_class_init (NleCompositionClass * klass)
   nleobject_properties[NLEOBJECT_PROP_DURATION] =
       g_object_class_find_property (gobject_class, "duration");
 
+  /**
+   * NleComposition:stack-plan:
+   *
+   * Whether to precompute, on commit, the stacks used in each region of the
+   * composition during forward playback. Switching stacks at region
+   * boundaries and seeking then do not require to look up the objects of the
+   * new stack anymore. Only the regions touched by the modified objects are
+   * recomputed on commit.
+   */
+  g_object_class_install_property (gobject_class, PROP_STACK_PLAN,
+      g_param_spec_boolean ("stack-plan", "Stack plan",
+          "Precompute the stacks of the composition on commit", FALSE,
+          G_PARAM_READWRITE));
+
+  /**
+   * NleComposition:prefetch-depth:
+   *
+   * Number of upcoming stacks whose sources are prepared while the current
+   * stack plays in forward playback. Those sources are brought to PAUSED and
+   * seeked to the position they will start playing from, so that switching
+   * to their stack does not require setting them up anymore. 0 disables
+   * prefetching.
+   */
+  g_object_class_install_property (gobject_class, PROP_PREFETCH_DEPTH,
+      g_param_spec_uint ("prefetch-depth", "Prefetch depth",
+          "Number of upcoming stacks to prepare ahead of time", 0, G_MAXUINT,
+          0, G_PARAM_READWRITE));
+
+  /**
+   * NleComposition:release-window:
+   *
+   * Distance from the stack being played beyond which the sources whose
+   * element got created on demand, see #NleSource::need-element, have it
+   * released. %GST_CLOCK_TIME_NONE means that those elements are never
+   * released.
+   */
+  g_object_class_install_property (gobject_class, PROP_RELEASE_WINDOW,
+      g_param_spec_uint64 ("release-window", "Release window",
+          "Distance from the current stack beyond which the elements created"
+          " on demand are released", 0, G_MAXUINT64, GST_CLOCK_TIME_NONE,
+          G_PARAM_READWRITE));
+
+  /**
+   * NleComposition:request-window:
+   *
+   * Distance after the stack being played within which the sources whose
+   * element is created on demand get it requested ahead of time, see
+   * #NleSource::need-element, so that it is usually ready by the time their
+   * stack is used. %GST_CLOCK_TIME_NONE means that the elements are only
+   * requested when their stack is about to be used, the composition then
+   * waits for them to be added before setting it up.
+   */
+  g_object_class_install_property (gobject_class, PROP_REQUEST_WINDOW,
+      g_param_spec_uint64 ("request-window", "Request window",
+          "Distance after the current stack within which the elements created"
+          " on demand are requested", 0, G_MAXUINT64, GST_CLOCK_TIME_NONE,
+          G_PARAM_READWRITE));
+
+  /**
+   * NleComposition:incremental-relink:
+   *
+   * Whether, when switching stacks, the subtrees running with the exact same
+   * layout in both stacks are kept running and only get seeked for the new
+   * stack, instead of tearing down the whole current stack.
+   */
+  g_object_class_install_property (gobject_class, PROP_INCREMENTAL_RELINK,
+      g_param_spec_boolean ("incremental-relink", "Incremental relink",
+          "Keep the subtrees shared by successive stacks running", FALSE,
+          G_PARAM_READWRITE));
+
   _signals[COMMITED_SIGNAL] =
       g_signal_new ("commited", G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_FIRST,
       0, NULL, NULL, g_cclosure_marshal_generic, G_TYPE_NONE, 1,
@@ -1029,6 +1263,7 @@ nle_composition_class_init (NleCompositionClass * klass)
   GST_DEBUG_REGISTER_FUNCPTR (_commit_func);
   GST_DEBUG_REGISTER_FUNCPTR (_emit_commited_signal_func);
   GST_DEBUG_REGISTER_FUNCPTR (_initialize_stack_func);
+  GST_DEBUG_REGISTER_FUNCPTR (_elements_ready_func);
 
   /* Just be useless, so the compiler does not warn us
    * about our uselessness */
@@ -1056,17 +1291,32 @@ nle_composition_init (NleComposition * comp)
 
   priv->objects_hash = g_hash_table_new (g_direct_hash, g_direct_equal);
 
+  priv->stack_plan = g_array_new (FALSE, FALSE, sizeof (NleStackRegion));
+  g_array_set_clear_func (priv->stack_plan,
+      (GDestroyNotify) _stack_region_clear);
+
   g_mutex_init (&priv->actions_lock);
   g_cond_init (&priv->actions_cond);
 
   priv->pending_io = g_hash_table_new_full (g_direct_hash, g_direct_equal,
       gst_object_unref, NULL);
 
+  priv->on_demand_sources = g_hash_table_new (NULL, NULL);
+  priv->release_window = GST_CLOCK_TIME_NONE;
+  priv->request_window = GST_CLOCK_TIME_NONE;
+
   comp->priv = priv;
 
   priv->current_bin = gst_bin_new ("current-bin");
   gst_bin_add (GST_BIN (comp), priv->current_bin);
 
+  /* Prefetched sources are not linked to anything, they should not make
+   * the composition change state asynchronously */
+  priv->prefetch_bin = gst_bin_new ("prefetch-bin");
+  g_object_set (priv->prefetch_bin, "async-handling", TRUE, NULL);
+  gst_element_set_locked_state (priv->prefetch_bin, TRUE);
+  gst_bin_add (GST_BIN (comp), priv->prefetch_bin);
+
   nle_composition_reset (comp);
 
   priv->nle_event_pad_func = GST_PAD_EVENTFUNC (NLE_OBJECT_SRC (comp));
@@ -1139,6 +1389,10 @@ nle_composition_finalize (GObject * object)
   }
 
   g_hash_table_destroy (priv->objects_hash);
+  g_hash_table_destroy (priv->on_demand_sources);
+  _index_tree_clear (&priv->starts_index);
+  _index_tree_clear (&priv->stops_index);
+  g_array_unref (priv->stack_plan);
 
   gst_segment_free (priv->segment);
   gst_segment_free (priv->seek_segment);
@@ -1162,11 +1416,80 @@ signal_duration_change (NleComposition * comp)
       gst_message_new_duration_changed (GST_OBJECT_CAST (comp)));
 }
 
+/* Data key under which the id of the probe blocking the output of an object
+ * kept from one stack to the next, or prefetched, is stored on its source
+ * pad */
+#define KEPT_OBJECT_PROBE "nle-kept-object-probe"
+
+static void
+_unblock_kept_object (NleObject * object)
+{
+  GstPad *srcpad = NLE_OBJECT_SRC (object);
+  gulong probe_id =
+      GPOINTER_TO_SIZE (g_object_steal_data (G_OBJECT (srcpad),
+          KEPT_OBJECT_PROBE));
+
+  if (probe_id)
+    gst_pad_remove_probe (srcpad, probe_id);
+}
+
+/* Drops everything an object kept from the previous stack outputs until the
+ * segment resulting from the seek for the new stack, so that no data from
+ * its previous position can reach its new parent. Flushes go through. */
+static GstPadProbeReturn
+_drop_until_stack_segment_cb (GstPad * pad, GstPadProbeInfo * info,
+    gpointer seqnum)
+{
+  GstEvent *event;
+
+  if (!GST_IS_EVENT (info->data))
+    return GST_PAD_PROBE_DROP;
+
+  event = GST_PAD_PROBE_INFO_EVENT (info);
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_SEGMENT:
+      if (gst_event_get_seqnum (event) != GPOINTER_TO_UINT (seqnum))
+        return GST_PAD_PROBE_DROP;
+
+      GST_DEBUG_OBJECT (pad, "Got new stack segment, unblocking");
+      /* If we can't steal it, the probe is being removed from the
+       * composition thread */
+      if (g_object_steal_data (G_OBJECT (pad), KEPT_OBJECT_PROBE))
+        return GST_PAD_PROBE_REMOVE;
+
+      return GST_PAD_PROBE_OK;
+    case GST_EVENT_EOS:
+    case GST_EVENT_GAP:
+    case GST_EVENT_SEGMENT_DONE:
+      return GST_PAD_PROBE_DROP;
+    default:
+      /* Let sticky events such as caps through, they are still valid */
+      return GST_PAD_PROBE_OK;
+  }
+}
+
+static void
+_block_kept_object (NleObject * object, guint32 seqnum)
+{
+  gulong probe_id;
+  GstPad *srcpad = NLE_OBJECT_SRC (object);
+
+  _unblock_kept_object (object);
+
+  probe_id = gst_pad_add_probe (srcpad, GST_PAD_PROBE_TYPE_DATA_DOWNSTREAM,
+      _drop_until_stack_segment_cb, GUINT_TO_POINTER (seqnum), NULL);
+  g_object_set_data (G_OBJECT (srcpad), KEPT_OBJECT_PROBE,
+      GSIZE_TO_POINTER (probe_id));
+}
+
 static gboolean
 _remove_child (GValue * item, GValue * ret G_GNUC_UNUSED, GstBin * bin)
 {
   GstElement *child = g_value_get_object (item);
 
+  if (NLE_IS_OBJECT (child))
+    _unblock_kept_object (NLE_OBJECT (child));
+
   if (NLE_IS_OPERATION (child))
     nle_operation_hard_cleanup (NLE_OPERATION (child));
 
@@ -1192,6 +1515,89 @@ _empty_bin (GstBin * bin)
   gst_iterator_free (children);
 }
 
+static gboolean
+_remove_unkept_child (GValue * item, GValue * ret, NleComposition * comp)
+{
+  GstElement *child = g_value_get_object (item);
+
+  if (g_hash_table_contains (comp->priv->kept_objects, child))
+    return TRUE;
+
+  gst_element_set_state (child, GST_STATE_READY);
+
+  return _remove_child (item, ret, GST_BIN_CAST (comp->priv->current_bin));
+}
+
+/* Sets the children of current_bin that are not kept in the new stack to
+ * READY and removes them, leaving the kept ones running */
+static void
+_remove_unkept_children (NleComposition * comp)
+{
+  GstIterator *children;
+
+  children = gst_bin_iterate_elements (GST_BIN_CAST (comp->priv->current_bin));
+
+  while (G_UNLIKELY (gst_iterator_fold (children,
+              (GstIteratorFoldFunction) _remove_unkept_child, NULL,
+              comp) == GST_ITERATOR_RESYNC)) {
+    gst_iterator_resync (children);
+  }
+
+  gst_iterator_free (children);
+}
+
+typedef struct
+{
+  NleComposition *comp;
+  GHashTable *wanted;
+  GstClockTime start;
+  GstClockTime stop;
+} NlePrefetchData;
+
+static void
+_release_prefetched_object (NleComposition * comp, NleObject * object)
+{
+  GST_DEBUG_OBJECT (comp, "Releasing prefetched %s", GST_OBJECT_NAME (object));
+
+  /* Going to READY first wakes up the streaming thread blocked in the
+   * probe, with nothing downstream it would otherwise error out */
+  gst_element_set_state (GST_ELEMENT (object), GST_STATE_READY);
+  _unblock_kept_object (object);
+  gst_bin_remove (GST_BIN_CAST (comp->priv->prefetch_bin),
+      GST_ELEMENT (object));
+}
+
+static gboolean
+_release_unwanted_prefetched_object (GValue * item, GValue * ret G_GNUC_UNUSED,
+    NlePrefetchData * data)
+{
+  NleObject *object = g_value_get_object (item);
+
+  if (!data->wanted || !g_hash_table_contains (data->wanted, object))
+    _release_prefetched_object (data->comp, object);
+
+  return TRUE;
+}
+
+/* Releases the prefetched objects which are not in @wanted, all of them if
+ * @wanted is %NULL */
+static void
+_release_prefetched_objects (NleComposition * comp, GHashTable * wanted)
+{
+  GstIterator *children;
+  NlePrefetchData data = { comp, wanted, };
+
+  children = gst_bin_iterate_elements (GST_BIN_CAST (comp->priv->prefetch_bin));
+
+  while (G_UNLIKELY (gst_iterator_fold (children,
+              (GstIteratorFoldFunction) _release_unwanted_prefetched_object,
+              NULL, &data) == GST_ITERATOR_RESYNC)) {
+    gst_iterator_resync (children);
+  }
+
+  gst_iterator_free (children);
+}
+
 static void
 nle_composition_reset (NleComposition * comp)
 {
@@ -1220,7 +1626,12 @@ nle_composition_reset (NleComposition * comp)
   priv->next_eos_seqnum = 0;
   priv->flush_seqnum = 0;
 
+  ACTIONS_LOCK (comp);
+  priv->waiting_for_elements = FALSE;
+  ACTIONS_UNLOCK (comp);
+
   _empty_bin (GST_BIN_CAST (priv->current_bin));
+  _release_prefetched_objects (comp, NULL);
 
   GST_DEBUG_OBJECT (comp, "Composition now resetted");
 }
@@ -1820,14 +2231,188 @@ nle_composition_ghost_pad_set_target (NleComposition * comp, GstPad * target)
   }
 }
 
+/*
+ * Stack lookup index
+ *
+ * Each node of the index trees caches aggregated values for its subtree so
+ * that whole subtrees can be skipped when looking up the objects playing at
+ * a given time or the next boundary set by an object of higher priority.
+ * Those lookups are O(log n + k) instead of walking the full sorted lists.
+ */
+static inline void
+_index_node_merge (NleIndexNode * node, NleIndexNode * child,
+    gboolean by_start)
+{
+  if (by_start)
+    node->bound = MAX (node->bound, child->bound);
+  else
+    node->bound = MIN (node->bound, child->bound);
+
+  node->min_priority = MIN (node->min_priority, child->min_priority);
+}
+
+/* Returns the position of the root of the [lo, hi[ subtree */
+static guint
+_index_tree_build (NleIndexTree * tree, guint lo, guint hi, gboolean by_start)
+{
+  guint mid = lo + (hi - lo) / 2;
+  NleIndexNode *node = &tree->nodes[mid];
+  NleObject *object = node->object;
+
+  node->bound = by_start ? object->stop : object->start;
+  node->min_priority =
+      NLE_OBJECT_ACTIVE (object) ? object->priority : G_MAXUINT32;
+
+  if (lo < mid)
+    _index_node_merge (node,
+        &tree->nodes[_index_tree_build (tree, lo, mid, by_start)], by_start);
+
+  if (mid + 1 < hi)
+    _index_node_merge (node,
+        &tree->nodes[_index_tree_build (tree, mid + 1, hi, by_start)],
+        by_start);
+
+  return mid;
+}
+
+static void
+_index_tree_rebuild (NleIndexTree * tree, GList * objects, gboolean by_start)
+{
+  guint i = 0;
+  GList *tmp;
+
+  tree->len = g_list_length (objects);
+  tree->nodes = g_renew (NleIndexNode, tree->nodes, tree->len);
+  for (tmp = objects; tmp; tmp = tmp->next)
+    tree->nodes[i++].object = tmp->data;
+
+  if (tree->len)
+    _index_tree_build (tree, 0, tree->len, by_start);
+}
+
+static void
+_index_tree_clear (NleIndexTree * tree)
+{
+  g_free (tree->nodes);
+  tree->nodes = NULL;
+  tree->len = 0;
+}
+
+/* WITH OBJECTS LOCK TAKEN */
+static void
+_ensure_stack_index (NleComposition * comp)
+{
+  NleCompositionPrivate *priv = comp->priv;
+
+  if (!priv->index_dirty)
+    return;
+
+  GST_DEBUG_OBJECT (comp, "Rebuilding stack index");
+  _index_tree_rebuild (&priv->starts_index, priv->objects_start, TRUE);
+  _index_tree_rebuild (&priv->stops_index, priv->objects_stop, FALSE);
+  priv->index_dirty = FALSE;
+}
+
+/*
+ * _index_tree_partition:
+ *
+ * Returns: The number of leading objects starting before or at @timestamp
+ * in the 'starts' index, or stopping after or at @timestamp in the 'stops'
+ * index.
+ */
+static guint
+_index_tree_partition (NleIndexTree * tree, GstClockTime timestamp,
+    gboolean by_start)
+{
+  guint lo = 0, hi = tree->len;
+
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+    NleObject *object = tree->nodes[mid].object;
+
+    if (by_start ? object->start <= timestamp : object->stop >= timestamp)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return lo;
+}
+
+/*
+ * _index_tree_stab:
+ * @limit: Number of leading nodes to consider, as returned by
+ * _index_tree_partition()
+ *
+ * Prepends to @res the objects of the [lo, hi[ subtree covering @timestamp,
+ * so that they end up in reverse index order.
+ */
+static void
+_index_tree_stab (NleIndexTree * tree, guint lo, guint hi, guint limit,
+    GstClockTime timestamp, gboolean by_start, GList ** res)
+{
+  guint mid;
+  NleIndexNode *node;
+
+  if (lo >= hi || lo >= limit)
+    return;
+
+  mid = lo + (hi - lo) / 2;
+  node = &tree->nodes[mid];
+  if (by_start ? node->bound <= timestamp : node->bound >= timestamp)
+    return;
+
+  _index_tree_stab (tree, lo, mid, limit, timestamp, by_start, res);
+
+  if (mid < limit && (by_start ? node->object->stop > timestamp :
+          node->object->start < timestamp))
+    *res = g_list_prepend (*res, node->object);
+
+  _index_tree_stab (tree, mid + 1, hi, limit, timestamp, by_start, res);
+}
+
+/*
+ * _index_tree_find_first:
+ * @from: First position to consider
+ *
+ * Returns: The position of the first active object of the [lo, hi[ subtree
+ * at or after @from with a priority smaller than @priority, -1 if none.
+ */
+static gint
+_index_tree_find_first (NleIndexTree * tree, guint lo, guint hi, guint from,
+    guint32 priority)
+{
+  gint res;
+  guint mid;
+  NleObject *object;
+
+  if (lo >= hi || hi <= from)
+    return -1;
+
+  mid = lo + (hi - lo) / 2;
+  if (tree->nodes[mid].min_priority >= priority)
+    return -1;
+
+  res = _index_tree_find_first (tree, lo, mid, from, priority);
+  if (res >= 0)
+    return res;
+
+  object = tree->nodes[mid].object;
+  if (mid >= from && NLE_OBJECT_ACTIVE (object) && object->priority < priority)
+    return mid;
+
+  return _index_tree_find_first (tree, mid + 1, hi, from, priority);
+}
+
 static void
 refine_start_stop_in_region_above_priority (NleComposition * composition,
     GstClockTime timestamp, GstClockTime start,
     GstClockTime stop,
     GstClockTime * rstart, GstClockTime * rstop, guint32 priority)
 {
-  GList *tmp;
+  gint pos;
   NleObject *object;
+  NleIndexTree *index;
   GstClockTime nstart = start, nstop = stop;
 
   GST_DEBUG_OBJECT (composition,
@@ -1835,54 +2420,34 @@ refine_start_stop_in_region_above_priority (NleComposition * composition,
       GST_TIME_FORMAT " priority:%u", GST_TIME_ARGS (timestamp),
       GST_TIME_ARGS (start), GST_TIME_ARGS (stop), priority);
 
-  for (tmp = composition->priv->objects_start; tmp; tmp = tmp->next) {
-    object = (NleObject *) tmp->data;
-
-    GST_LOG_OBJECT (object, "START %" GST_TIME_FORMAT "--%" GST_TIME_FORMAT,
-        GST_TIME_ARGS (object->start), GST_TIME_ARGS (object->stop));
-
-    if ((object->priority >= priority) || (!NLE_OBJECT_ACTIVE (object)))
-      continue;
-
-    if (object->start <= timestamp)
-      continue;
-
-    if (object->start >= nstop)
-      continue;
+  _ensure_stack_index (composition);
 
+  /* First object of higher priority starting after timestamp */
+  index = &composition->priv->starts_index;
+  pos = _index_tree_find_first (index, 0, index->len,
+      _index_tree_partition (index, timestamp, TRUE), priority);
+  if (pos >= 0 && index->nodes[pos].object->start < nstop) {
+    object = index->nodes[pos].object;
     nstop = object->start;
 
     GST_DEBUG_OBJECT (composition,
         "START Found %s [prio:%u] at %" GST_TIME_FORMAT,
         GST_OBJECT_NAME (object), object->priority,
         GST_TIME_ARGS (object->start));
-
-    break;
   }
 
-  for (tmp = composition->priv->objects_stop; tmp; tmp = tmp->next) {
-    object = (NleObject *) tmp->data;
-
-    GST_LOG_OBJECT (object, "STOP %" GST_TIME_FORMAT "--%" GST_TIME_FORMAT,
-        GST_TIME_ARGS (object->start), GST_TIME_ARGS (object->stop));
-
-    if ((object->priority >= priority) || (!NLE_OBJECT_ACTIVE (object)))
-      continue;
-
-    if (object->stop >= timestamp)
-      continue;
-
-    if (object->stop <= nstart)
-      continue;
-
+  /* Last object of higher priority stopping before timestamp */
+  index = &composition->priv->stops_index;
+  pos = _index_tree_find_first (index, 0, index->len,
+      _index_tree_partition (index, timestamp, FALSE), priority);
+  if (pos >= 0 && index->nodes[pos].object->stop > nstart) {
+    object = index->nodes[pos].object;
     nstart = object->stop;
 
     GST_DEBUG_OBJECT (composition,
         "STOP Found %s [prio:%u] at %" GST_TIME_FORMAT,
         GST_OBJECT_NAME (object), object->priority,
         GST_TIME_ARGS (object->start));
-
-    break;
   }
 
   if (*rstart)
@@ -1981,6 +2546,7 @@ beach:
  * @timestamp: The #GstClockTime to look at
  * @priority: The priority level to start looking from
  * @activeonly: Only look for active elements if TRUE
+ * @reverse: Whether to look for the stack used in reverse playback
  * @start: The biggest start time of the objects in the stack
  * @stop: The smallest stop time of the objects in the stack
  * @highprio: The highest priority in the stack
@@ -1993,17 +2559,18 @@ beach:
  */
 static GNode *
 get_stack_list (NleComposition * comp, GstClockTime timestamp,
-    guint32 priority, gboolean activeonly, GstClockTime * start,
-    GstClockTime * stop, guint * highprio)
+    guint32 priority, gboolean activeonly, gboolean reverse,
+    GstClockTime * start, GstClockTime * stop, guint * highprio)
 {
   GList *tmp;
+  guint limit;
   GList *stack = NULL;
   GNode *ret = NULL;
+  NleIndexTree *index;
   GstClockTime nstart = GST_CLOCK_TIME_NONE;
   GstClockTime nstop = GST_CLOCK_TIME_NONE;
   GstClockTime first_out_of_stack = GST_CLOCK_TIME_NONE;
   guint32 highest = 0;
-  gboolean reverse = (comp->priv->segment->rate < 0.0);
 
   GST_DEBUG_OBJECT (comp,
       "timestamp:%" GST_TIME_FORMAT ", priority:%u, activeonly:%d",
@@ -2012,62 +2579,48 @@ get_stack_list (NleComposition * comp, GstClockTime timestamp,
   GST_LOG ("objects_start:%p objects_stop:%p", comp->priv->objects_start,
       comp->priv->objects_stop);
 
-  if (reverse) {
-    for (tmp = comp->priv->objects_stop; tmp; tmp = g_list_next (tmp)) {
-      NleObject *object = (NleObject *) tmp->data;
+  _ensure_stack_index (comp);
 
-      GST_LOG_OBJECT (object,
-          "start: %" GST_TIME_FORMAT ", stop:%" GST_TIME_FORMAT " , duration:%"
-          GST_TIME_FORMAT ", priority:%u, active:%d",
-          GST_TIME_ARGS (object->start), GST_TIME_ARGS (object->stop),
-          GST_TIME_ARGS (object->duration), object->priority, object->active);
-
-      if (object->stop >= timestamp) {
-        if ((object->start < timestamp) &&
-            (object->priority >= priority) &&
-            ((!activeonly) || (NLE_OBJECT_ACTIVE (object)))) {
-          GST_LOG_OBJECT (comp, "adding %s: sorted to the stack",
-              GST_OBJECT_NAME (object));
-          stack = g_list_insert_sorted (stack, object,
-              (GCompareFunc) priority_comp);
-          if (NLE_IS_OPERATION (object))
-            nle_operation_update_base_time (NLE_OPERATION (object), timestamp);
-        }
-      } else {
-        GST_LOG_OBJECT (comp, "too far, stopping iteration");
-        first_out_of_stack = object->stop;
-        break;
-      }
-    }
-  } else {
-    for (tmp = comp->priv->objects_start; tmp; tmp = g_list_next (tmp)) {
-      NleObject *object = (NleObject *) tmp->data;
+  /* In reverse playback, look for the objects stopping at or after
+   * timestamp and starting before it, the other way around otherwise */
+  index = reverse ? &comp->priv->stops_index : &comp->priv->starts_index;
+  limit = _index_tree_partition (index, timestamp, !reverse);
+  _index_tree_stab (index, 0, index->len, limit, timestamp, !reverse, &stack);
 
-      GST_LOG_OBJECT (object,
-          "start: %" GST_TIME_FORMAT " , stop:%" GST_TIME_FORMAT " , duration:%"
-          GST_TIME_FORMAT ", priority:%u", GST_TIME_ARGS (object->start),
-          GST_TIME_ARGS (object->stop), GST_TIME_ARGS (object->duration),
-          object->priority);
-
-      if (object->start <= timestamp) {
-        if ((object->stop > timestamp) &&
-            (object->priority >= priority) &&
-            ((!activeonly) || (NLE_OBJECT_ACTIVE (object)))) {
-          GST_LOG_OBJECT (comp, "adding %s: sorted to the stack",
-              GST_OBJECT_NAME (object));
-          stack = g_list_insert_sorted (stack, object,
-              (GCompareFunc) priority_comp);
-          if (NLE_IS_OPERATION (object))
-            nle_operation_update_base_time (NLE_OPERATION (object), timestamp);
-        }
-      } else {
-        GST_LOG_OBJECT (comp, "too far, stopping iteration");
-        first_out_of_stack = object->start;
-        break;
-      }
+  if (limit < index->len) {
+    NleObject *object = index->nodes[limit].object;
+
+    first_out_of_stack = reverse ? object->stop : object->start;
+  }
+
+  tmp = stack;
+  while (tmp) {
+    GList *next = tmp->next;
+    NleObject *object = (NleObject *) tmp->data;
+
+    GST_LOG_OBJECT (object,
+        "start: %" GST_TIME_FORMAT ", stop:%" GST_TIME_FORMAT " , duration:%"
+        GST_TIME_FORMAT ", priority:%u, active:%d",
+        GST_TIME_ARGS (object->start), GST_TIME_ARGS (object->stop),
+        GST_TIME_ARGS (object->duration), object->priority, object->active);
+
+    if ((object->priority >= priority) &&
+        ((!activeonly) || (NLE_OBJECT_ACTIVE (object)))) {
+      GST_LOG_OBJECT (comp, "adding %s to the stack", GST_OBJECT_NAME (object));
+      if (NLE_IS_OPERATION (object))
+        nle_operation_update_base_time (NLE_OPERATION (object), timestamp);
+    } else {
+      stack = g_list_delete_link (stack, tmp);
     }
+
+    tmp = next;
   }
 
+  /* The stack is in reverse index order, the sort being stable, objects
+   * with the same priority are ordered the same way as if they had been
+   * inserted sorted one after the other */
+  stack = g_list_sort (stack, (GCompareFunc) priority_comp);
+
   /* Insert the expandables */
   if (G_LIKELY (timestamp < NLE_OBJECT_STOP (comp)))
     for (tmp = comp->priv->expandables; tmp; tmp = tmp->next) {
@@ -2104,6 +2657,220 @@ get_stack_list (NleComposition * comp, GstClockTime timestamp,
   return ret;
 }
 
+/*
+ * get_stack_at:
+ * @comp: The #NleComposition
+ * @timestamp: The #GstClockTime to look at
+ * @reverse: Whether to look for the stack used in reverse playback
+ * @start: The greatest start time of returned stack
+ * @stop: The min stop time of returned stack
+ *
+ * Returns: The stack for the given #NleComposition and @timestamp, taking
+ * into account the objects of higher priority blocking it.
+ *
+ * WITH OBJECTS LOCK TAKEN
+ */
+static GNode *
+get_stack_at (NleComposition * comp, GstClockTime timestamp, gboolean reverse,
+    GstClockTime * start, GstClockTime * stop)
+{
+  GNode *stack;
+  guint highprio;
+
+  stack = get_stack_list (comp, timestamp, 0, TRUE, reverse, start, stop,
+      &highprio);
+
+  if (stack) {
+    guint32 top_priority = NLE_OBJECT_PRIORITY (stack->data);
+
+    /* Figure out if there's anything blocking us with smaller priority */
+    refine_start_stop_in_region_above_priority (comp, timestamp, *start,
+        *stop, start, stop, (highprio == 0) ? top_priority : highprio);
+  }
+
+  return stack;
+}
+
+/*
+ * Stack plan
+ *
+ * In forward playback, the composition is a succession of [start, stop[
+ * regions during which the stack does not change. When the 'stack-plan'
+ * property is set, those regions are computed once after each commit so that
+ * switching stacks is only a matter of looking up the region in which the
+ * new position is. Commiting only recomputes the regions touched by the
+ * objects that have been added, removed or modified.
+ */
+static void
+_stack_region_clear (NleStackRegion * region)
+{
+  if (region->stack) {
+    g_node_destroy (region->stack);
+    region->stack = NULL;
+  }
+}
+
+/* Returns the index of the first region stopping at or after @timestamp */
+static guint
+_stack_plan_search (GArray * plan, GstClockTime timestamp)
+{
+  guint lo = 0, hi = plan->len;
+
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+
+    if (g_array_index (plan, NleStackRegion, mid).stop < timestamp)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return lo;
+}
+
+/* WITH OBJECTS LOCK TAKEN */
+static void
+_stack_plan_invalidate_range (NleComposition * comp, GstClockTime start,
+    GstClockTime stop)
+{
+  guint i;
+  GArray *plan = comp->priv->stack_plan;
+
+  /* The region right before (or after) a touched range might have been
+   * bounded by the object that changed, so invalidate it too */
+  for (i = _stack_plan_search (plan, start); i < plan->len; i++) {
+    NleStackRegion *region = &g_array_index (plan, NleStackRegion, i);
+
+    if (region->start > stop)
+      break;
+
+    _stack_region_clear (region);
+  }
+}
+
+/* WITH OBJECTS LOCK TAKEN */
+static void
+_stack_plan_invalidate_object (NleComposition * comp, NleObject * object)
+{
+  if (NLE_OBJECT_IS_EXPANDABLE (object)) {
+    /* Expandables are part of every stack */
+    g_array_set_size (comp->priv->stack_plan, 0);
+
+    return;
+  }
+
+  _stack_plan_invalidate_range (comp, object->start, object->stop);
+}
+
+/*
+ * _update_stack_plan:
+ *
+ * Recomputes the regions of the stack plan that have been invalidated since
+ * last update, must be called once the composition start/stop have been
+ * updated.
+ *
+ * WITH OBJECTS LOCK TAKEN
+ */
+static void
+_update_stack_plan (NleComposition * comp)
+{
+  guint i = 0;
+  GArray *plan;
+  NleCompositionPrivate *priv = comp->priv;
+  GstClockTime timestamp = NLE_OBJECT_START (comp);
+  guint n_computed = 0;
+
+  if (!priv->use_stack_plan) {
+    g_array_set_size (priv->stack_plan, 0);
+
+    return;
+  }
+
+  plan = g_array_sized_new (FALSE, FALSE, sizeof (NleStackRegion),
+      priv->stack_plan->len);
+  g_array_set_clear_func (plan, (GDestroyNotify) _stack_region_clear);
+
+  while (timestamp < NLE_OBJECT_STOP (comp)) {
+    NleStackRegion region = { timestamp, GST_CLOCK_TIME_NONE, NULL };
+    NleStackRegion *valid = NULL;
+
+    /* Find the next region still valid */
+    for (; i < priv->stack_plan->len; i++) {
+      NleStackRegion *tmp = &g_array_index (priv->stack_plan,
+          NleStackRegion, i);
+
+      if (tmp->stack && tmp->stop > timestamp) {
+        valid = tmp;
+        break;
+      }
+    }
+
+    if (valid && valid->start <= timestamp) {
+      /* Still valid, steal its stack */
+      region.stop = valid->stop;
+      region.stack = valid->stack;
+      valid->stack = NULL;
+      i++;
+    } else {
+      GstClockTime start = G_MAXUINT64;
+
+      region.stop = G_MAXUINT64;
+      region.stack = get_stack_at (comp, timestamp, FALSE, &start,
+          &region.stop);
+      if (!region.stack || region.stop <= timestamp) {
+        GST_INFO_OBJECT (comp, "No stack at %" GST_TIME_FORMAT
+            ", not planning any further", GST_TIME_ARGS (timestamp));
+        _stack_region_clear (&region);
+        break;
+      }
+
+      /* Make sure not to overlap the following valid region */
+      if (valid)
+        region.stop = MIN (region.stop, valid->start);
+      n_computed++;
+    }
+
+    g_array_append_val (plan, region);
+    timestamp = region.stop;
+  }
+
+  GST_DEBUG_OBJECT (comp, "Stack plan now has %u regions, %u recomputed",
+      plan->len, n_computed);
+
+  g_array_unref (priv->stack_plan);
+  priv->stack_plan = plan;
+}
+
+/*
+ * _stack_plan_lookup:
+ *
+ * Returns: The region of the stack plan containing @timestamp, %NULL if
+ * the plan can not be used.
+ *
+ * WITH OBJECTS LOCK TAKEN
+ */
+static NleStackRegion *
+_stack_plan_lookup (NleComposition * comp, GstClockTime timestamp)
+{
+  guint i;
+  NleStackRegion *region;
+  NleCompositionPrivate *priv = comp->priv;
+
+  if (!priv->use_stack_plan || priv->segment->rate < 0.0)
+    return NULL;
+
+  /* Regions are [start, stop[ */
+  i = _stack_plan_search (priv->stack_plan, timestamp + 1);
+  if (i >= priv->stack_plan->len)
+    return NULL;
+
+  region = &g_array_index (priv->stack_plan, NleStackRegion, i);
+  if (!region->stack || region->start > timestamp)
+    return NULL;
+
+  return region;
+}
+
 /*
  * get_clean_toplevel_stack:
  * @comp: The #NleComposition
@@ -2120,9 +2887,9 @@ get_clean_toplevel_stack (NleComposition * comp, GstClockTime * timestamp,
     GstClockTime * start_time, GstClockTime * stop_time)
 {
   GNode *stack = NULL;
+  NleStackRegion *region;
   GstClockTime start = G_MAXUINT64;
   GstClockTime stop = G_MAXUINT64;
-  guint highprio;
   gboolean reverse = (comp->priv->segment->rate < 0.0);
 
   GST_DEBUG_OBJECT (comp, "timestamp:%" GST_TIME_FORMAT,
@@ -2130,7 +2897,20 @@ get_clean_toplevel_stack (NleComposition * comp, GstClockTime * timestamp,
   GST_DEBUG ("start:%" GST_TIME_FORMAT ", stop:%" GST_TIME_FORMAT,
       GST_TIME_ARGS (start), GST_TIME_ARGS (stop));
 
-  stack = get_stack_list (comp, *timestamp, 0, TRUE, &start, &stop, &highprio);
+  region = _stack_plan_lookup (comp, *timestamp);
+  if (region) {
+    GST_DEBUG_OBJECT (comp, "Using planned stack [%" GST_TIME_FORMAT " - %"
+        GST_TIME_FORMAT "]", GST_TIME_ARGS (region->start),
+        GST_TIME_ARGS (region->stop));
+
+    stack = g_node_copy (region->stack);
+    start = region->start;
+    stop = region->stop;
+    g_node_traverse (stack, G_IN_ORDER, G_TRAVERSE_ALL, -1,
+        (GNodeTraverseFunc) update_base_time, timestamp);
+  } else {
+    stack = get_stack_at (comp, *timestamp, reverse, &start, &stop);
+  }
 
   if (!stack &&
       ((reverse && (*timestamp > COMP_REAL_START (comp))) ||
@@ -2148,14 +2928,6 @@ get_clean_toplevel_stack (NleComposition * comp, GstClockTime * timestamp,
   GST_DEBUG ("start:%" GST_TIME_FORMAT ", stop:%" GST_TIME_FORMAT,
       GST_TIME_ARGS (start), GST_TIME_ARGS (stop));
 
-  if (stack) {
-    guint32 top_priority = NLE_OBJECT_PRIORITY (stack->data);
-
-    /* Figure out if there's anything blocking us with smaller priority */
-    refine_start_stop_in_region_above_priority (comp, *timestamp, start,
-        stop, &start, &stop, (highprio == 0) ? top_priority : highprio);
-  }
-
   if (*stop_time) {
     if (stack)
       *stop_time = stop;
@@ -2179,6 +2951,353 @@ get_clean_toplevel_stack (NleComposition * comp, GstClockTime * timestamp,
   return stack;
 }
 
+static gboolean
+_release_prefetched_stack_object (GNode * node, NleComposition * comp)
+{
+  if (GST_OBJECT_PARENT (node->data) ==
+      GST_OBJECT_CAST (comp->priv->prefetch_bin))
+    _release_prefetched_object (comp, NLE_OBJECT (node->data));
+
+  return FALSE;
+}
+
+/* Releases the prefetched objects of @stack so that it can be set up from
+ * scratch */
+static void
+_release_prefetched_stack_objects (NleComposition * comp, GNode * stack)
+{
+  if (stack)
+    g_node_traverse (stack, G_PRE_ORDER, G_TRAVERSE_LEAVES, -1,
+        (GNodeTraverseFunc) _release_prefetched_stack_object, comp);
+}
+
+static GstPadProbeReturn
+_prefetched_blocked_cb (GstPad * pad, GstPadProbeInfo * info G_GNUC_UNUSED,
+    gpointer udata G_GNUC_UNUSED)
+{
+  GST_LOG_OBJECT (pad, "Prefetched and ready");
+
+  return GST_PAD_PROBE_OK;
+}
+
+static gboolean
+_prefetch_source (GNode * node, NlePrefetchData * data)
+{
+  gulong probe_id;
+  GstEvent *seek, *translated_seek;
+  NleObject *object = (NleObject *) node->data;
+  NleCompositionPrivate *priv = data->comp->priv;
+
+  if (!NLE_IS_SOURCE (object))
+    return FALSE;
+
+  g_hash_table_add (data->wanted, object);
+
+  /* Already running in the current stack or already prefetched */
+  if (GST_OBJECT_PARENT (object))
+    return FALSE;
+
+  /* Prefetched by a later update once its element is there */
+  if (_request_source_element (data->comp, object))
+    return FALSE;
+
+  GST_DEBUG_OBJECT (data->comp, "Prefetching %s for [%" GST_TIME_FORMAT " - %"
+      GST_TIME_FORMAT "]", GST_OBJECT_NAME (object),
+      GST_TIME_ARGS (data->start), GST_TIME_ARGS (data->stop));
+
+  gst_bin_add (GST_BIN_CAST (priv->prefetch_bin), GST_ELEMENT (object));
+
+  /* Hold the data until the object gets used in its stack, its srcpad is
+   * not linked to anything until then */
+  probe_id = gst_pad_add_probe (NLE_OBJECT_SRC (object),
+      GST_PAD_PROBE_TYPE_BLOCK | GST_PAD_PROBE_TYPE_BUFFER |
+      GST_PAD_PROBE_TYPE_BUFFER_LIST, _prefetched_blocked_cb, NULL, NULL);
+  g_object_set_data (G_OBJECT (NLE_OBJECT_SRC (object)), KEPT_OBJECT_PROBE,
+      GSIZE_TO_POINTER (probe_id));
+
+  seek = gst_event_new_seek (1.0, GST_FORMAT_TIME,
+      GST_SEEK_FLAG_ACCURATE | GST_SEEK_FLAG_FLUSH,
+      GST_SEEK_TYPE_SET, data->start, GST_SEEK_TYPE_SET, data->stop);
+  translated_seek = nle_object_translate_incoming_seek (object, seek);
+  gst_event_unref (seek);
+
+  /* Used when preparing the source */
+  gst_element_send_event (GST_ELEMENT (object), translated_seek);
+  gst_element_set_state (GST_ELEMENT (object), GST_STATE_PAUSED);
+
+  return FALSE;
+}
+
+/*
+ * Prefetching
+ *
+ * In forward playback, when 'prefetch-depth' is set, the sources of the
+ * stacks following the current one are brought to PAUSED in prefetch_bin,
+ * seeked to where their stack starts. Their output is blocked until they are
+ * moved to current_bin when their stack gets set up, which then only has to
+ * seek them again, see _find_kept_subtrees(). The prefetched sources which
+ * are not part of the upcoming stacks anymore are released.
+ *
+ * WITH OBJECTS LOCK TAKEN
+ */
+static void
+_prefetch_upcoming_stacks (NleComposition * comp)
+{
+  guint depth;
+  GNode *stack;
+  NlePrefetchData data = { comp, };
+  NleCompositionPrivate *priv = comp->priv;
+  GstClockTime boundary = priv->current_stack_stop;
+
+  if (!priv->prefetch_depth || !priv->current || priv->segment->rate < 0.0 ||
+      GST_STATE_TARGET (comp) < GST_STATE_PAUSED) {
+    _release_prefetched_objects (comp, NULL);
+
+    return;
+  }
+
+  if (GST_STATE (priv->prefetch_bin) < GST_STATE_PAUSED)
+    gst_element_set_state (priv->prefetch_bin, GST_STATE_PAUSED);
+
+  data.wanted = g_hash_table_new (NULL, NULL);
+  for (depth = 0; depth < priv->prefetch_depth; depth++) {
+    GstClockTime start = G_MAXUINT64;
+    GstClockTime stop = G_MAXUINT64;
+
+    if (!GST_CLOCK_TIME_IS_VALID (boundary) ||
+        boundary >= NLE_OBJECT_STOP (comp) ||
+        (GST_CLOCK_TIME_IS_VALID (priv->segment->stop) &&
+            boundary >= priv->segment->stop))
+      break;
+
+    stack = get_stack_at (comp, boundary, FALSE, &start, &stop);
+    if (!stack)
+      break;
+
+    data.start = boundary;
+    data.stop = stop;
+    g_node_traverse (stack, G_PRE_ORDER, G_TRAVERSE_LEAVES, -1,
+        (GNodeTraverseFunc) _prefetch_source, &data);
+    g_node_destroy (stack);
+
+    if (!GST_CLOCK_TIME_IS_VALID (stop) || stop <= boundary)
+      break;
+
+    boundary = stop;
+  }
+
+  /* Looking up the upcoming stacks updated the base time of the operations
+   * they share with the current one */
+  g_node_traverse (priv->current, G_IN_ORDER, G_TRAVERSE_ALL, -1,
+      (GNodeTraverseFunc) update_base_time, &priv->current_stack_start);
+
+  _release_prefetched_objects (comp, data.wanted);
+  g_hash_table_unref (data.wanted);
+}
+
+/*
+ * Requests the element of @object if it is a source whose element is
+ * created on demand and that does not have one yet.
+ *
+ * Returns: %TRUE if @object is still waiting for its element.
+ *
+ * WITH OBJECTS LOCK TAKEN
+ */
+static gboolean
+_request_source_element (NleComposition * comp, NleObject * object)
+{
+  if (!NLE_IS_SOURCE (object) ||
+      !nle_source_has_element_on_demand (NLE_SOURCE (object)))
+    return FALSE;
+
+  /* So that it gets released if it is not used after all */
+  g_hash_table_add (comp->priv->on_demand_sources, object);
+
+  return nle_source_request_element (NLE_SOURCE (object));
+}
+
+typedef struct
+{
+  NleComposition *comp;
+  gboolean missing;
+} NleRequestData;
+
+static gboolean
+_request_missing_element (GNode * node, NleRequestData * data)
+{
+  if (_request_source_element (data->comp, node->data))
+    data->missing = TRUE;
+
+  return FALSE;
+}
+
+/*
+ * Requests the elements of the sources of @stack that are created on demand
+ * and do not exist yet. Those are built asynchronously, from another thread,
+ * the streaming thread never waits for them.
+ *
+ * Returns: %TRUE if some are still missing, in which case the update is run
+ * again once they get added, see _source_element_added_cb().
+ *
+ * WITH OBJECTS LOCK TAKEN
+ */
+static gboolean
+_wait_for_missing_elements (NleComposition * comp, GNode * stack)
+{
+  NleRequestData data = { comp, FALSE };
+  NleCompositionPrivate *priv = comp->priv;
+
+  if (!stack)
+    return FALSE;
+
+  /* Set first so that an element added while requesting the others is not
+   * missed */
+  ACTIONS_LOCK (comp);
+  priv->waiting_for_elements = TRUE;
+  ACTIONS_UNLOCK (comp);
+
+  g_node_traverse (stack, G_PRE_ORDER, G_TRAVERSE_LEAVES, -1,
+      (GNodeTraverseFunc) _request_missing_element, &data);
+
+  if (!data.missing) {
+    ACTIONS_LOCK (comp);
+    priv->waiting_for_elements = FALSE;
+    ACTIONS_UNLOCK (comp);
+  }
+
+  return data.missing;
+}
+
+static void
+_elements_ready_func (NleComposition * comp, gpointer udata)
+{
+  gboolean waiting;
+  NleCompositionPrivate *priv = comp->priv;
+
+  ACTIONS_LOCK (comp);
+  waiting = priv->waiting_for_elements;
+  ACTIONS_UNLOCK (comp);
+
+  /* Another update already took care of it */
+  if (!waiting)
+    return;
+
+  GST_INFO_OBJECT (comp, "Element added, updating the pipeline again");
+  update_pipeline (comp, priv->pending_update_time,
+      priv->pending_update_seqnum, priv->pending_update_reason);
+
+  /* _commit_func() left it to us */
+  if (!priv->waiting_for_elements && !priv->current &&
+      priv->pending_update_reason == COMP_UPDATE_STACK_ON_COMMIT)
+    g_signal_emit (comp, _signals[COMMITED_SIGNAL], 0, TRUE);
+}
+
+/* Called from the thread adding the element */
+static void
+_source_element_added_cb (GstBin * source G_GNUC_UNUSED,
+    GstElement * element G_GNUC_UNUSED, NleComposition * comp)
+{
+  ACTIONS_LOCK (comp);
+  if (comp->priv->waiting_for_elements)
+    _add_action_locked (comp, G_CALLBACK (_elements_ready_func), comp,
+        G_PRIORITY_DEFAULT);
+  ACTIONS_UNLOCK (comp);
+}
+
+/*
+ * Requests the elements of the sources starting within 'request-window'
+ * after the current stack in forward playback, so that the next stacks
+ * usually do not have to wait for them.
+ *
+ * WITH OBJECTS LOCK TAKEN
+ */
+static void
+_request_upcoming_elements (NleComposition * comp)
+{
+  guint i, first, last;
+  GstClockTime horizon;
+  NleCompositionPrivate *priv = comp->priv;
+  GstClockTime stop = priv->current_stack_stop;
+
+  if (!GST_CLOCK_TIME_IS_VALID (priv->request_window) ||
+      !GST_CLOCK_TIME_IS_VALID (stop) || priv->segment->rate < 0.0)
+    return;
+
+  if (priv->request_window >= G_MAXUINT64 - stop)
+    horizon = G_MAXUINT64;
+  else
+    horizon = stop + priv->request_window;
+
+  _ensure_stack_index (comp);
+  first = stop ? _index_tree_partition (&priv->starts_index, stop - 1,
+      TRUE) : 0;
+  last = _index_tree_partition (&priv->starts_index, horizon, TRUE);
+
+  for (i = first; i < last; i++) {
+    NleObject *object = priv->starts_index.nodes[i].object;
+
+    if (NLE_OBJECT_ACTIVE (object))
+      _request_source_element (comp, object);
+  }
+}
+
+static gboolean
+_track_on_demand_source (GNode * node, NleComposition * comp)
+{
+  if (NLE_IS_SOURCE (node->data) &&
+      nle_source_has_element_on_demand (NLE_SOURCE (node->data)))
+    g_hash_table_add (comp->priv->on_demand_sources, node->data);
+
+  return FALSE;
+}
+
+/*
+ * Releases the elements that were created on demand for the sources which
+ * are not used anymore and are further than 'release-window' from the
+ * current stack, so that only the sources around the playback position hold
+ * an element.
+ *
+ * WITH OBJECTS LOCK TAKEN
+ */
+static void
+_release_on_demand_elements (NleComposition * comp)
+{
+  GHashTableIter iter;
+  NleObject *object;
+  GstClockTime distance;
+  NleCompositionPrivate *priv = comp->priv;
+
+  if (priv->current)
+    g_node_traverse (priv->current, G_PRE_ORDER, G_TRAVERSE_LEAVES, -1,
+        (GNodeTraverseFunc) _track_on_demand_source, comp);
+
+  if (!GST_CLOCK_TIME_IS_VALID (priv->release_window) ||
+      !GST_CLOCK_TIME_IS_VALID (priv->current_stack_start))
+    return;
+
+  g_hash_table_iter_init (&iter, priv->on_demand_sources);
+  while (g_hash_table_iter_next (&iter, (gpointer *) & object, NULL)) {
+    /* Still used in the current stack or prefetched, or its element is
+     * still being built */
+    if (GST_OBJECT_PARENT (object) || !NLE_SOURCE (object)->element)
+      continue;
+
+    if (object->stop < priv->current_stack_start)
+      distance = priv->current_stack_start - object->stop;
+    else if (GST_CLOCK_TIME_IS_VALID (priv->current_stack_stop) &&
+        object->start > priv->current_stack_stop)
+      distance = object->start - priv->current_stack_stop;
+    else
+      distance = 0;
+
+    if (distance <= priv->release_window)
+      continue;
+
+    nle_source_release_element (NLE_SOURCE (object));
+    g_hash_table_iter_remove (&iter);
+  }
+}
+
 static GstPadProbeReturn
 _drop_all_cb (GstPad * pad G_GNUC_UNUSED,
     GstPadProbeInfo * info, NleComposition * comp)
@@ -2220,20 +3339,30 @@ _set_current_bin_to_ready (NleComposition * comp, gboolean flush_downstream)
 
   }
 
-  gst_element_set_locked_state (priv->current_bin, TRUE);
-  gst_element_set_state (priv->current_bin, GST_STATE_READY);
+  if (priv->kept_objects) {
+    /* Relinking incrementally, only tear down what is not reused */
+    _remove_unkept_children (comp);
+  } else {
+    gst_element_set_locked_state (priv->current_bin, TRUE);
+    gst_element_set_state (priv->current_bin, GST_STATE_READY);
+  }
 
   if (ptarget) {
     if (flush_downstream) {
+      gboolean active = gst_pad_is_active (ptarget);
+
       flush_event = gst_event_new_flush_stop (TRUE);
       gst_event_set_seqnum (flush_event, priv->flush_seqnum);
 
       /* Force ad activation so that the event can actually travel.
        * Not doing that would lead to the event being discarded.
+       * The target is still active if its object is kept in the new stack.
        */
-      gst_pad_set_active (ptarget, TRUE);
+      if (!active)
+        gst_pad_set_active (ptarget, TRUE);
       gst_pad_push_event (ptarget, flush_event);
-      gst_pad_set_active (ptarget, FALSE);
+      if (!active)
+        gst_pad_set_active (ptarget, FALSE);
     }
 
     gst_pad_remove_probe (ptarget, probe_id);
@@ -2334,6 +3463,7 @@ _commit_func (NleComposition * comp, UpdateCompositionData * ucompo)
     GST_DEBUG_OBJECT (comp, "Not initialized yet, just updating values");
 
     update_start_stop_duration (comp);
+    _update_stack_plan (comp);
 
     g_signal_emit (comp, _signals[COMMITED_SIGNAL], 0, TRUE);
 
@@ -2342,6 +3472,7 @@ _commit_func (NleComposition * comp, UpdateCompositionData * ucompo)
 
     /* And update the pipeline at current position if needed */
     update_start_stop_duration (comp);
+    _update_stack_plan (comp);
 
     reverse = (priv->segment->rate < 0.0);
     if (!reverse) {
@@ -2357,7 +3488,9 @@ _commit_func (NleComposition * comp, UpdateCompositionData * ucompo)
     }
     update_pipeline (comp, curpos, ucompo->seqnum, COMP_UPDATE_STACK_ON_COMMIT);
 
-    if (!priv->current) {
+    /* When waiting for elements, COMMITED is emitted once the stack using
+     * them is ready, or by _elements_ready_func() */
+    if (!priv->current && !priv->waiting_for_elements) {
       GST_INFO_OBJECT (comp, "No new stack set, we can go and keep acting on"
           " our children");
 
@@ -2460,12 +3593,14 @@ nle_composition_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_PAUSED_TO_READY:
       comp->priv->tearing_down_stack = FALSE;
       nle_composition_reset (comp);
+      gst_element_set_state (comp->priv->prefetch_bin, GST_STATE_READY);
 
       /* In READY we are still able to process actions. */
       _start_task (comp);
       break;
     case GST_STATE_CHANGE_READY_TO_NULL:
       gst_element_set_state (comp->priv->current_bin, GST_STATE_NULL);
+      gst_element_set_state (comp->priv->prefetch_bin, GST_STATE_NULL);
       comp->priv->tearing_down_stack = FALSE;
       break;
     default:
@@ -2671,6 +3806,22 @@ _relink_children_recursively (NleComposition * comp,
   /* Make sure we have enough sinkpads */
 }
 
+static gboolean
+_update_recursive_media_duration_factor (GNode * node,
+    gpointer udata G_GNUC_UNUSED)
+{
+  GNode *node_it;
+  NleObject *newobj = (NleObject *) node->data;
+
+  newobj->recursive_media_duration_factor = 1.0f;
+  for (node_it = node; node_it != NULL; node_it = node_it->parent) {
+    NleObject *object = (NleObject *) node_it->data;
+    newobj->recursive_media_duration_factor *= object->media_duration_factor;
+  }
+
+  return FALSE;
+}
+
 /*
  * recursive depth-first relink stack function on new stack
  *
@@ -2686,33 +3837,55 @@ _relink_single_node (NleComposition * comp, GNode * node,
 {
   NleObject *newobj;
   NleObject *newparent;
-  GNode *node_it;
   GstPad *srcpad = NULL, *sinkpad = NULL;
   GstEvent *translated_seek;
+  gboolean kept;
+  NleCompositionPrivate *priv = comp->priv;
 
   if (G_UNLIKELY (!node))
     return;
 
   newparent = G_NODE_IS_ROOT (node) ? NULL : (NleObject *) node->parent->data;
   newobj = (NleObject *) node->data;
+  kept = priv->kept_objects
+      && g_hash_table_contains (priv->kept_objects, newobj);
 
-  GST_DEBUG_OBJECT (comp, "newobj:%s",
-      GST_ELEMENT_NAME ((GstElement *) newobj));
-
-  newobj->recursive_media_duration_factor = 1.0f;
-  for (node_it = node; node_it != NULL; node_it = node_it->parent) {
-    NleObject *object = (NleObject *) node_it->data;
-    newobj->recursive_media_duration_factor *= object->media_duration_factor;
-  }
+  GST_DEBUG_OBJECT (comp, "newobj:%s%s",
+      GST_ELEMENT_NAME ((GstElement *) newobj),
+      kept ? " (kept from previous stack)" : "");
 
   srcpad = NLE_OBJECT_SRC (newobj);
 
-  gst_bin_add (GST_BIN (comp->priv->current_bin), GST_ELEMENT (newobj));
-  gst_element_sync_state_with_parent (GST_ELEMENT_CAST (newobj));
+  if (kept) {
+    GstPad *peer;
+
+    /* The whole subtree is still running, its ancestors might have
+     * changed though */
+    g_node_traverse (node, G_PRE_ORDER, G_TRAVERSE_ALL, -1,
+        _update_recursive_media_duration_factor, NULL);
 
-  translated_seek = nle_object_translate_incoming_seek (newobj, toplevel_seek);
+    if ((peer = gst_pad_get_peer (srcpad))) {
+      gst_pad_unlink (srcpad, peer);
+      gst_object_unref (peer);
+    }
+  } else {
+    _update_recursive_media_duration_factor (node, NULL);
+
+    gst_bin_add (GST_BIN (priv->current_bin), GST_ELEMENT (newobj));
+
+    /* When relinking incrementally current_bin keeps running, new objects
+     * are only started once the whole stack is linked, see
+     * _start_new_objects() */
+    if (priv->kept_objects)
+      gst_element_set_state (GST_ELEMENT_CAST (newobj), GST_STATE_READY);
+    else
+      gst_element_sync_state_with_parent (GST_ELEMENT_CAST (newobj));
 
-  gst_element_send_event (GST_ELEMENT (newobj), translated_seek);
+    translated_seek =
+        nle_object_translate_incoming_seek (newobj, toplevel_seek);
+
+    gst_element_send_event (GST_ELEMENT (newobj), translated_seek);
+  }
 
   /* link to parent if needed.  */
   if (newparent) {
@@ -2726,7 +3899,7 @@ _relink_single_node (NleComposition * comp, GNode * node,
   }
 
   /* Handle children */
-  if (NLE_IS_OPERATION (newobj))
+  if (!kept && NLE_IS_OPERATION (newobj))
     _relink_children_recursively (comp, newobj, node, toplevel_seek);
 
   GST_LOG_OBJECT (comp, "done with object %s",
@@ -2776,6 +3949,211 @@ _deactivate_stack (NleComposition * comp, gboolean flush_downstream)
  */
 }
 
+static gboolean
+_map_stack_node (GNode * node, GHashTable * nodes)
+{
+  g_hash_table_insert (nodes, node->data, node);
+
+  return FALSE;
+}
+
+static gboolean
+_add_kept_object (GNode * node, GHashTable * kept_objects)
+{
+  g_hash_table_insert (kept_objects, node->data, GINT_TO_POINTER (FALSE));
+
+  return FALSE;
+}
+
+static void
+_find_kept_subtrees (NleComposition * comp, GNode * node,
+    GHashTable * current_nodes)
+{
+  GNode *child;
+  NleCompositionPrivate *priv = comp->priv;
+  GNode *current = g_hash_table_lookup (current_nodes, node->data);
+
+  if (G_NODE_IS_LEAF (node) && GST_OBJECT_PARENT (node->data) ==
+      GST_OBJECT_CAST (priv->prefetch_bin)) {
+    GST_DEBUG_OBJECT (comp, "Using prefetched %s",
+        GST_ELEMENT_NAME (node->data));
+
+    g_hash_table_insert (priv->kept_objects, node->data,
+        GINT_TO_POINTER (TRUE));
+    priv->kept_roots = g_list_prepend (priv->kept_roots, node->data);
+
+    return;
+  }
+
+  if (priv->incremental_relink && current && GST_OBJECT_PARENT (node->data) ==
+      GST_OBJECT_CAST (priv->current_bin) && are_same_stacks (current, node)) {
+    GST_DEBUG_OBJECT (comp, "Keeping %s and its %d children running",
+        GST_ELEMENT_NAME (node->data), g_node_n_nodes (node,
+            G_TRAVERSE_ALL) - 1);
+
+    g_node_traverse (node, G_PRE_ORDER, G_TRAVERSE_ALL, -1,
+        (GNodeTraverseFunc) _add_kept_object, priv->kept_objects);
+    priv->kept_roots = g_list_prepend (priv->kept_roots, node->data);
+
+    return;
+  }
+
+  for (child = node->children; child; child = child->next)
+    _find_kept_subtrees (comp, child, current_nodes);
+}
+
+static void
+_clear_kept_objects (NleComposition * comp)
+{
+  NleCompositionPrivate *priv = comp->priv;
+
+  g_clear_pointer (&priv->kept_objects, g_hash_table_unref);
+  g_list_free (priv->kept_roots);
+  priv->kept_roots = NULL;
+}
+
+/*
+ * Looks for the subtrees of @stack that are currently running with the exact
+ * same layout, if incremental-relink is set, and for its prefetched sources,
+ * and sets kept_objects/kept_roots accordingly.
+ *
+ * Returns: %TRUE if @stack can be relinked incrementally around those
+ * subtrees, %FALSE if the current stack has to be fully deactivated.
+ */
+static gboolean
+_find_reusable_subtrees (NleComposition * comp, GNode * stack)
+{
+  GHashTable *current_nodes;
+  NleCompositionPrivate *priv = comp->priv;
+
+  if (!priv->current || !stack)
+    return FALSE;
+
+  /* Only the prefetched sources can be reused */
+  if (!priv->incremental_relink &&
+      !GST_BIN_NUMCHILDREN (priv->prefetch_bin))
+    return FALSE;
+
+  if (gst_element_is_locked_state (priv->current_bin) ||
+      GST_STATE (priv->current_bin) < GST_STATE_PAUSED)
+    return FALSE;
+
+  current_nodes = g_hash_table_new (NULL, NULL);
+  g_node_traverse (priv->current, G_PRE_ORDER, G_TRAVERSE_ALL, -1,
+      (GNodeTraverseFunc) _map_stack_node, current_nodes);
+
+  priv->kept_objects = g_hash_table_new (NULL, NULL);
+  _find_kept_subtrees (comp, stack, current_nodes);
+  g_hash_table_unref (current_nodes);
+
+  if (!priv->kept_roots) {
+    _clear_kept_objects (comp);
+
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/*
+ * Tears down the objects of the current stack that are not kept in the new
+ * one, the kept subtrees are blocked until they get seeked for the new stack.
+ *
+ * WITH OBJECTS LOCK TAKEN
+ */
+static void
+_deactivate_unkept_objects (NleComposition * comp, gboolean flush_downstream,
+    guint32 seqnum)
+{
+  GList *tmp;
+  GstPad *ptarget;
+  NleCompositionPrivate *priv = comp->priv;
+
+  GST_INFO_OBJECT (comp, "Deactivating current stack keeping %u objects "
+      "running (flushing downstream: %d)",
+      g_hash_table_size (priv->kept_objects), flush_downstream);
+
+  /* Prefetched objects are already blocked */
+  for (tmp = priv->kept_roots; tmp; tmp = tmp->next) {
+    if (!g_hash_table_lookup (priv->kept_objects, tmp->data))
+      _block_kept_object (NLE_OBJECT (tmp->data), seqnum);
+  }
+
+  ptarget = gst_ghost_pad_get_target (GST_GHOST_PAD (NLE_OBJECT_SRC (comp)));
+  _set_current_bin_to_ready (comp, flush_downstream);
+
+  for (tmp = priv->kept_roots; tmp; tmp = tmp->next) {
+    GstElement *object = tmp->data;
+
+    if (!g_hash_table_lookup (priv->kept_objects, object))
+      continue;
+
+    gst_object_ref (object);
+    gst_bin_remove (GST_BIN_CAST (priv->prefetch_bin), object);
+    gst_bin_add (GST_BIN_CAST (priv->current_bin), object);
+    gst_object_unref (object);
+  }
+
+  if (ptarget) {
+    if (priv->ghosteventprobe) {
+      GST_INFO_OBJECT (comp, "Removing old ghost pad probe");
+
+      gst_pad_remove_probe (ptarget, priv->ghosteventprobe);
+      priv->ghosteventprobe = 0;
+    }
+
+    /* The old toplevel object might be kept and linked to a new parent */
+    nle_object_ghost_pad_set_target (NLE_OBJECT (comp),
+        NLE_OBJECT_SRC (comp), NULL);
+    gst_object_unref (ptarget);
+  }
+
+  GST_INFO_OBJECT (comp, "Stack partially deactivated");
+}
+
+/*
+ * Brings the objects added to the new stack to the state of current_bin,
+ * parents first, and seeks the kept subtrees now that their new parents
+ * are ready to receive data.
+ *
+ * WITH OBJECTS LOCK TAKEN
+ */
+static void
+_start_new_objects (NleComposition * comp, GNode * node,
+    GstEvent * toplevel_seek)
+{
+  GNode *child;
+  NleObject *object = (NleObject *) node->data;
+
+  if (g_hash_table_contains (comp->priv->kept_objects, object)) {
+    gboolean prefetched =
+        GPOINTER_TO_INT (g_hash_table_lookup (comp->priv->kept_objects,
+            object));
+
+    GST_INFO_OBJECT (comp, "Seeking %s %s", GST_ELEMENT_NAME (object),
+        prefetched ? "prefetched" : "kept from previous stack");
+
+    if (prefetched)
+      gst_element_sync_state_with_parent (GST_ELEMENT_CAST (object));
+
+    /* The flush resulting from the seek discards what prefetched objects
+     * have been blocking, they can be unblocked right away */
+    if (!gst_pad_send_event (NLE_OBJECT_SRC (object),
+            gst_event_ref (toplevel_seek))) {
+      GST_WARNING_OBJECT (comp, "Could not seek %s", GST_ELEMENT_NAME (object));
+      _unblock_kept_object (object);
+    } else if (prefetched) {
+      _unblock_kept_object (object);
+    }
+
+    return;
+  }
+
+  gst_element_sync_state_with_parent (GST_ELEMENT_CAST (object));
+  for (child = node->children; child; child = child->next)
+    _start_new_objects (comp, child, toplevel_seek);
+}
+
 static void
 _relink_new_stack (NleComposition * comp, GNode * stack,
     GstEvent * toplevel_seek)
@@ -2931,7 +4309,9 @@ _set_real_eos_seqnum_from_seek (NleComposition * comp, GstEvent * event)
  * @update_reason: Reason why we are updating the pipeline
  *
  * Updates the internal pipeline and properties. If @currenttime is
- * GST_CLOCK_TIME_NONE, it will not modify the current pipeline
+ * GST_CLOCK_TIME_NONE, it will not modify the current pipeline. If the
+ * elements of some sources of the new stack are still being built, the
+ * update is run again once they are added, see _elements_ready_func()
  *
  * Returns: FALSE if there was an error updating the pipeline.
  *
@@ -2944,13 +4324,16 @@ update_pipeline (NleComposition * comp, GstClockTime currenttime, gint32 seqnum,
 
   GstEvent *toplevel_seek;
 
+  gboolean res;
   GNode *stack = NULL;
+  GstEvent *resume_seek = NULL;
   gboolean samestack = FALSE;
   gboolean updatestoponly = FALSE;
   GstState state = GST_STATE (comp);
   NleCompositionPrivate *priv = comp->priv;
   GstClockTime new_stop = GST_CLOCK_TIME_NONE;
   GstClockTime new_start = GST_CLOCK_TIME_NONE;
+  GstClockTime requested_time;
   GstClockTime duration = NLE_OBJECT (comp)->duration - 1;
 
   GstState nextstate = (GST_STATE_NEXT (comp) == GST_STATE_VOID_PENDING) ?
@@ -2982,7 +4365,19 @@ update_pipeline (NleComposition * comp, GstClockTime currenttime, gint32 seqnum,
       gst_element_state_get_name (state));
 
   /* Get new stack and compare it to current one */
+  requested_time = currenttime;
   stack = get_clean_toplevel_stack (comp, &currenttime, &new_start, &new_stop);
+
+  if (_wait_for_missing_elements (comp, stack)) {
+    GST_INFO_OBJECT (comp, "Waiting for the elements of the new stack");
+    priv->pending_update_time = requested_time;
+    priv->pending_update_seqnum = seqnum;
+    priv->pending_update_reason = update_reason;
+    g_node_destroy (stack);
+
+    return TRUE;
+  }
+
   samestack = are_same_stacks (priv->current, stack);
 
   /* set new current_stack_start/stop (the current zone over which the new stack
@@ -3025,9 +4420,17 @@ update_pipeline (NleComposition * comp, GstClockTime currenttime, gint32 seqnum,
 
   _remove_update_actions (comp);
 
-  /* If stacks are different, unlink/relink objects */
+  /* If stacks are different, unlink/relink objects, keeping the subtrees
+   * shared by both stacks running when possible */
   if (!samestack) {
-    _deactivate_stack (comp, _have_to_flush_downstream (update_reason));
+    if (_find_reusable_subtrees (comp, stack)) {
+      resume_seek = gst_event_ref (toplevel_seek);
+      _deactivate_unkept_objects (comp,
+          _have_to_flush_downstream (update_reason), seqnum);
+    } else {
+      _deactivate_stack (comp, _have_to_flush_downstream (update_reason));
+      _release_prefetched_stack_objects (comp, stack);
+    }
     _relink_new_stack (comp, stack, toplevel_seek);
   }
 
@@ -3035,6 +4438,8 @@ update_pipeline (NleComposition * comp, GstClockTime currenttime, gint32 seqnum,
   GST_INFO_OBJECT (comp, "Setting current stack [%" GST_TIME_FORMAT " - %"
       GST_TIME_FORMAT "]", GST_TIME_ARGS (priv->current_stack_start),
       GST_TIME_ARGS (priv->current_stack_stop));
+  if (priv->current)
+    g_node_destroy (priv->current);
   priv->current = stack;
 
   if (priv->current) {
@@ -3051,6 +4456,10 @@ update_pipeline (NleComposition * comp, GstClockTime currenttime, gint32 seqnum,
       GST_INFO_OBJECT (comp,
           "No task set, it must have been stopped, returning");
       GST_OBJECT_UNLOCK (comp);
+      if (resume_seek) {
+        gst_event_unref (resume_seek);
+        _clear_kept_objects (comp);
+      }
       return FALSE;
     }
 
@@ -3059,11 +4468,23 @@ update_pipeline (NleComposition * comp, GstClockTime currenttime, gint32 seqnum,
   }
 
   /* Activate stack */
-  if (!samestack)
-    return _activate_new_stack (comp);
+  if (resume_seek) {
+    res = _activate_new_stack (comp);
+
+    _start_new_objects (comp, priv->current, resume_seek);
+    gst_event_unref (resume_seek);
+    _clear_kept_objects (comp);
+  } else if (!samestack)
+    res = _activate_new_stack (comp);
   else
-    return _seek_current_stack (comp, toplevel_seek,
+    res = _seek_current_stack (comp, toplevel_seek,
         _have_to_flush_downstream (update_reason));
+
+  _prefetch_upcoming_stacks (comp);
+  _request_upcoming_elements (comp);
+  _release_on_demand_elements (comp);
+
+  return res;
 }
 
 static gboolean
@@ -3072,7 +4493,8 @@ nle_composition_add_object (GstBin * bin, GstElement * element)
   NleObject *object;
   NleComposition *comp = (NleComposition *) bin;
 
-  if (element == comp->priv->current_bin) {
+  if (element == comp->priv->current_bin ||
+      element == comp->priv->prefetch_bin) {
     GST_INFO_OBJECT (comp, "Adding internal bin");
     return GST_BIN_CLASS (parent_class)->add_element (bin, element);
   }
@@ -3132,6 +4554,11 @@ _nle_composition_add_object (NleComposition * comp, NleObject * object)
 
   /* ...and add it to the hash table */
   g_hash_table_add (priv->objects_hash, object);
+  _stack_plan_invalidate_object (comp, object);
+
+  if (NLE_IS_SOURCE (object))
+    g_signal_connect (object, "element-added",
+        G_CALLBACK (_source_element_added_cb), comp);
 
   /* Set the caps of the composition on the NleObject it handles */
   if (G_UNLIKELY (!gst_caps_is_any (((NleObject *) comp)->caps)))
@@ -3158,6 +4585,7 @@ _nle_composition_add_object (NleComposition * comp, NleObject * object)
 
   priv->objects_stop = g_list_insert_sorted
       (priv->objects_stop, object, (GCompareFunc) objects_stop_compare);
+  priv->index_dirty = TRUE;
 
   /* Now the object is ready to be commited and then used */
 
@@ -3177,7 +4605,8 @@ nle_composition_remove_object (GstBin * bin, GstElement * element)
   NleObject *object;
   NleComposition *comp = (NleComposition *) bin;
 
-  if (element == comp->priv->current_bin) {
+  if (element == comp->priv->current_bin ||
+      element == comp->priv->prefetch_bin) {
     GST_INFO_OBJECT (comp, "Removing internal bin");
     return GST_BIN_CLASS (parent_class)->remove_element (bin, element);
   }
@@ -3204,9 +4633,17 @@ _nle_composition_remove_object (NleComposition * comp, NleObject * object)
     return FALSE;
   }
 
+  if (GST_OBJECT_PARENT (object) == GST_OBJECT_CAST (priv->prefetch_bin))
+    _release_prefetched_object (comp, object);
+  g_hash_table_remove (priv->on_demand_sources, object);
+  g_signal_handlers_disconnect_by_func (object, _source_element_added_cb,
+      comp);
+
   gst_element_set_locked_state (GST_ELEMENT (object), FALSE);
   gst_element_set_state (GST_ELEMENT (object), GST_STATE_NULL);
 
+  _stack_plan_invalidate_object (comp, object);
+
   /* handle default source */
   if (NLE_OBJECT_IS_EXPANDABLE (object)) {
     /* Find it in the list */
@@ -3215,6 +4652,7 @@ _nle_composition_remove_object (NleComposition * comp, NleObject * object)
     /* remove it from the objects list and resort the lists */
     priv->objects_start = g_list_remove (priv->objects_start, object);
     priv->objects_stop = g_list_remove (priv->objects_stop, object);
+    priv->index_dirty = TRUE;
     GST_LOG_OBJECT (object, "Removed from the objects start/stop list");
   }
 
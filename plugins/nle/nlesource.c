@@ -62,8 +62,20 @@ struct _NleSourcePrivate
 
   GstEvent *seek_event;
   gulong probeid;
+
+  /* need-element was emitted and no element was added since */
+  gboolean element_requested;
 };
 
+enum
+{
+  NEED_ELEMENT_SIGNAL,
+  RELEASE_ELEMENT_SIGNAL,
+  LAST_SIGNAL
+};
+
+static guint _signals[LAST_SIGNAL] = { 0 };
+
 static gboolean nle_source_prepare (NleObject * object);
 static gboolean nle_source_send_event (GstElement * element, GstEvent * event);
 static gboolean nle_source_add_element (GstBin * bin, GstElement * element);
@@ -109,6 +121,43 @@ nle_source_class_init (NleSourceClass * klass)
   gst_element_class_add_static_pad_template (gstelement_class,
       &nle_source_src_template);
 
+  /**
+   * NleSource::need-element:
+   * @source: a #NleSource
+   *
+   * Emitted when @source is about to be used in a stack, or is getting
+   * close to the stack being played, while it does not have any element to
+   * control. Handlers are expected to add that element to @source with
+   * gst_bin_add(), which makes it possible to only create it when it is
+   * actually needed.
+   *
+   * It is emitted from the streaming thread of the composition, which must
+   * not be blocked: handlers can add the element later on from any thread,
+   * the composition waits for it before using @source.
+   */
+  _signals[NEED_ELEMENT_SIGNAL] =
+      g_signal_new ("need-element", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST, 0, NULL, NULL, g_cclosure_marshal_generic,
+      G_TYPE_NONE, 0);
+
+  /**
+   * NleSource::release-element:
+   * @source: a #NleSource
+   *
+   * Emitted by the composition when the element of @source was provided
+   * through #NleSource::need-element and @source is far enough from the
+   * stack being played for that element to be dropped. Handlers are
+   * expected to remove it from @source with gst_bin_remove() before
+   * returning, it will be requested again the next time @source is used.
+   * @source is not used by the composition while the signal is emitted.
+   *
+   * This is an action signal, applications can emit it to have the
+   * element dropped while @source is not used by the composition.
+   */
+  _signals[RELEASE_ELEMENT_SIGNAL] =
+      g_signal_new ("release-element", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION, 0, NULL, NULL, g_cclosure_marshal_generic,
+      G_TYPE_NONE, 0);
 }
 
 
@@ -356,6 +405,10 @@ nle_source_add_element (GstBin * bin, GstElement * element)
   pret = GST_BIN_CLASS (parent_class)->add_element (bin, element);
 
   if (pret) {
+    GST_OBJECT_LOCK (source);
+    source->priv->element_requested = FALSE;
+    GST_OBJECT_UNLOCK (source);
+
     nle_source_control_element_func (source, element);
   }
   return pret;
@@ -365,7 +418,6 @@ static gboolean
 nle_source_remove_element (GstBin * bin, GstElement * element)
 {
   NleSource *source = (NleSource *) bin;
-  NleObject *nleobject = (NleObject *) element;
   NleSourcePrivate *priv = source->priv;
   gboolean pret;
 
@@ -379,8 +431,21 @@ nle_source_remove_element (GstBin * bin, GstElement * element)
   }
 
   if (pret) {
-    nle_object_ghost_pad_set_target (NLE_OBJECT (source), nleobject->srcpad,
-        NULL);
+    GST_OBJECT_LOCK (source);
+    if (priv->probeid) {
+      gst_pad_remove_probe (priv->ghostedpad, priv->probeid);
+      priv->probeid = 0;
+      priv->areblocked = FALSE;
+    }
+    GST_OBJECT_UNLOCK (source);
+
+    nle_object_ghost_pad_set_target (NLE_OBJECT (source),
+        NLE_OBJECT_SRC (source), NULL);
+    priv->ghostedpad = NULL;
+    if (priv->staticpad) {
+      gst_object_unref (priv->staticpad);
+      priv->staticpad = NULL;
+    }
 
     /* remove signal handlers */
     if (priv->padremovedid) {
@@ -469,6 +534,7 @@ nle_source_prepare (NleObject * object)
       (GstElement *) gst_element_get_parent ((GstElement *) object);
 
   if (!source->element) {
+    nle_source_request_element (source);
     GST_WARNING_OBJECT (source,
         "NleSource doesn't have an element to control !");
     if (parent)
@@ -506,3 +572,46 @@ nle_source_prepare (NleObject * object)
 
   return TRUE;
 }
+
+/* Whether the element of @source is provided on demand through
+ * #NleSource::need-element */
+gboolean
+nle_source_has_element_on_demand (NleSource * source)
+{
+  return g_signal_has_handler_pending (source,
+      _signals[NEED_ELEMENT_SIGNAL], 0, FALSE);
+}
+
+/* Emits #NleSource::need-element if @source has no element and it was
+ * not requested yet. Returns whether @source is still waiting for its
+ * element. */
+gboolean
+nle_source_request_element (NleSource * source)
+{
+  gboolean requested;
+
+  if (source->element)
+    return FALSE;
+
+  GST_OBJECT_LOCK (source);
+  requested = source->priv->element_requested;
+  source->priv->element_requested = TRUE;
+  GST_OBJECT_UNLOCK (source);
+
+  if (!requested) {
+    GST_DEBUG_OBJECT (source, "No element to control yet, requesting one");
+    g_signal_emit (source, _signals[NEED_ELEMENT_SIGNAL], 0);
+  }
+
+  return source->element == NULL;
+}
+
+void
+nle_source_release_element (NleSource * source)
+{
+  if (!source->element)
+    return;
+
+  GST_DEBUG_OBJECT (source, "Releasing %" GST_PTR_FORMAT, source->element);
+  g_signal_emit (source, _signals[RELEASE_ELEMENT_SIGNAL], 0);
+}
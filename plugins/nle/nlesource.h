@@ -62,5 +62,9 @@ struct _NleSourceClass
 
 GType nle_source_get_type (void) G_GNUC_INTERNAL;
 
+gboolean nle_source_has_element_on_demand (NleSource * source) G_GNUC_INTERNAL;
+gboolean nle_source_request_element (NleSource * source) G_GNUC_INTERNAL;
+void nle_source_release_element (NleSource * source) G_GNUC_INTERNAL;
+
 G_END_DECLS
 #endif /* __NLE_SOURCE_H__ */
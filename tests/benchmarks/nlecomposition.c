@@ -0,0 +1,115 @@
+/* Gstreamer Editing Services
+ *
+ * Copyright (C) <2018> Thibault Saunier <tsaunier@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Measures how long it takes a nlecomposition to switch stacks when seeking
+ * around, the composition being filled with an increasing number of
+ * objects. Each stack switch has to look up the objects playing at the seek
+ * position, which should not be proportional to the number of objects. */
+
+#include <ges/ges.h>
+
+#define NUM_SEEKS 200
+#define OBJECT_DURATION (GST_SECOND / 10)
+
+static GstElement *
+new_audio_source (guint64 start, guint priority)
+{
+  GstElement *source = gst_element_factory_make ("nlesource", NULL);
+
+  g_assert (source);
+  g_object_set (source, "start", start, "duration", OBJECT_DURATION,
+      "inpoint", (guint64) 0, "priority", priority, NULL);
+  gst_bin_add (GST_BIN (source),
+      gst_element_factory_make ("audiotestsrc", NULL));
+
+  return source;
+}
+
+static GstClockTime
+run_seeks (guint num_objects)
+{
+  guint i;
+  GstBus *bus;
+  GstClockTime start, end;
+  GstElement *pipeline, *comp, *sink;
+
+  pipeline = gst_pipeline_new (NULL);
+  comp = gst_element_factory_make ("nlecomposition", NULL);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", FALSE, NULL);
+
+  gst_bin_add_many (GST_BIN (pipeline), comp, sink, NULL);
+  gst_element_link (comp, sink);
+
+  /* Two tracks of back to back objects, the second one being shifted by
+   * half an object so that there is a stack change every half object */
+  for (i = 0; i < num_objects; i++)
+    gst_bin_add (GST_BIN (comp),
+        new_audio_source ((i / 2) * OBJECT_DURATION +
+            (i % 2) * OBJECT_DURATION / 2, 1 + (i % 2)));
+
+  /* The composition commits its objects when initializing its first stack */
+  gst_element_set_state (pipeline, GST_STATE_PAUSED);
+  gst_element_get_state (pipeline, NULL, NULL, GST_CLOCK_TIME_NONE);
+
+  bus = gst_element_get_bus (pipeline);
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_SEEKS; i++) {
+    GstMessage *msg;
+    GstClockTime position = g_random_int_range (0, num_objects / 2) *
+        OBJECT_DURATION + OBJECT_DURATION / 4;
+
+    gst_element_seek_simple (pipeline, GST_FORMAT_TIME,
+        GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE, position);
+    msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+        GST_MESSAGE_ASYNC_DONE | GST_MESSAGE_ERROR);
+    if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR)
+      g_error ("Got error while seeking: %" GST_PTR_FORMAT, msg);
+    gst_message_unref (msg);
+  }
+  end = gst_util_get_timestamp ();
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+
+  return end - start;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint i;
+  guint num_objects[] = { 100, 1000, 5000, 10000 };
+
+  gst_init (&argc, &argv);
+  ges_init ();
+
+  for (i = 0; i < G_N_ELEMENTS (num_objects); i++) {
+    GstClockTime elapsed = run_seeks (num_objects[i]);
+
+    g_print ("%" GST_TIME_FORMAT " - %d seeks in a composition with %d"
+        " objects (%" GST_TIME_FORMAT " per seek)\n",
+        GST_TIME_ARGS (elapsed), NUM_SEEKS, num_objects[i],
+        GST_TIME_ARGS (elapsed / NUM_SEEKS));
+  }
+
+  return 0;
+}
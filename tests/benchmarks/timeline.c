@@ -22,11 +22,73 @@
 
 
 #define NUM_OBJECTS 1000
+#define NUM_QUERIES 10000
+
+/* Fills a layer with @num_clips back to back clips and measures how long
+ * it takes to look up the clips around random positions. With
+ * @with_long_clip, a clip spanning the whole layer, like a music bed, is
+ * added as well: the lookups are then bounded by its duration and visit
+ * every clip starting before the interval */
+static void
+query_clips_in_interval (GESAsset * asset, guint num_clips,
+    gboolean with_long_clip)
+{
+  guint i, nfound = 0;
+  GESLayer *layer;
+  GList *clips = NULL;
+  GstClockTime start, end;
+
+  layer = gst_object_ref_sink (ges_layer_new ());
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < num_clips; i++) {
+    GESTimelineElement *clip =
+        GES_TIMELINE_ELEMENT (ges_asset_extract (asset, NULL));
+
+    ges_timeline_element_set_start (clip, i * 1000);
+    ges_timeline_element_set_duration (clip, 1000);
+    clips = g_list_prepend (clips, clip);
+  }
+  ges_layer_add_clips (layer, clips);
+  g_list_free (clips);
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - adding %d clips to a layer\n",
+      GST_TIME_ARGS (end - start), num_clips);
+
+  if (with_long_clip)
+    ges_layer_add_asset (layer, asset, 0, 0, num_clips * 1000,
+        GES_TRACK_TYPE_UNKNOWN);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_QUERIES; i++) {
+    GstClockTime position = g_random_int_range (0, num_clips) * 1000 + 500;
+    GList *clips =
+        ges_layer_get_clips_in_interval (layer, position, position + 2000);
+
+    nfound += g_list_length (clips);
+    g_list_free_full (clips, gst_object_unref);
+  }
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - %d interval queries in a layer with %d"
+      " clips%s (%d clips found)\n", GST_TIME_ARGS (end - start), NUM_QUERIES,
+      num_clips, with_long_clip ? " and a long one" : "", nfound);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_QUERIES; i++)
+    ges_layer_get_duration (layer);
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - %d duration queries in a layer with %d"
+      " clips%s\n", GST_TIME_ARGS (end - start), NUM_QUERIES, num_clips,
+      with_long_clip ? " and a long one" : "");
+
+  gst_object_unref (layer);
+}
 
 gint
 main (gint argc, gchar * argv[])
 {
   guint i;
+  guint num_layer_clips[] = { 1000, 10000, 100000 };
   GESAsset *asset;
   GESTimeline *timeline;
   GESLayer *layer;
@@ -93,5 +155,13 @@ main (gint argc, gchar * argv[])
   g_print ("%" GST_TIME_FORMAT " - freeing the timeline\n",
       GST_TIME_ARGS (end - start));
 
+  for (i = 0; i < G_N_ELEMENTS (num_layer_clips); i++)
+    query_clips_in_interval (asset, num_layer_clips[i], FALSE);
+
+  for (i = 0; i < G_N_ELEMENTS (num_layer_clips); i++)
+    query_clips_in_interval (asset, num_layer_clips[i], TRUE);
+
+  gst_object_unref (asset);
+
   return 0;
 }
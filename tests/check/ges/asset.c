@@ -23,6 +23,7 @@
 #include "../../../ges/ges-internal.h"
 #include <ges/ges.h>
 #include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
 
 static GMainLoop *mainloop;
 
@@ -197,6 +198,186 @@ GST_START_TEST (test_proxy_asset)
 
 GST_END_TEST;
 
+GST_START_TEST (test_discovery_cache)
+{
+  GFile *media, *copy;
+  GESUriClipAsset *asset;
+  GstDiscovererInfo *info;
+  gchar *cache_dir, *copy_path, *copy_uri, *media_uri;
+  gchar *previous_cache_dir = g_strdup (g_getenv ("GES_DISCOVERY_CACHE_DIR"));
+
+  fail_unless (ges_init ());
+
+  cache_dir = g_dir_make_tmp ("ges-discovery-cache-XXXXXX", NULL);
+  fail_unless (cache_dir != NULL);
+  g_setenv ("GES_DISCOVERY_CACHE_DIR", cache_dir, TRUE);
+
+  /* Work on a copy of the media file as we are going to modify it */
+  media_uri = ges_test_get_audio_video_uri ();
+  media = g_file_new_for_uri (media_uri);
+  copy_path = g_build_filename (cache_dir, "audio_video.ogg", NULL);
+  copy = g_file_new_for_path (copy_path);
+  fail_unless (g_file_copy (media, copy, G_FILE_COPY_NONE, NULL, NULL, NULL,
+          NULL));
+  copy_uri = g_file_get_uri (copy);
+
+  fail_unless (ges_discovery_cache_lookup (copy_uri) == NULL);
+  asset = ges_uri_clip_asset_request_sync (copy_uri, NULL);
+  fail_unless (asset != NULL);
+
+  info = ges_discovery_cache_lookup (copy_uri);
+  fail_unless (info != NULL);
+  assert_equals_string (gst_discoverer_info_get_uri (info), copy_uri);
+  assert_equals_uint64 (gst_discoverer_info_get_duration (info),
+      ges_uri_clip_asset_get_duration (asset));
+  gst_discoverer_info_unref (info);
+
+  /* Modifying the file invalidates its cached information */
+  fail_unless (g_file_set_attribute_uint64 (copy,
+          G_FILE_ATTRIBUTE_TIME_MODIFIED, 1, G_FILE_QUERY_INFO_NONE, NULL,
+          NULL));
+  fail_unless (ges_discovery_cache_lookup (copy_uri) == NULL);
+
+  /* An empty cache directory disables the cache */
+  info = gst_discoverer_info_copy (ges_uri_clip_asset_get_info (asset));
+  g_setenv ("GES_DISCOVERY_CACHE_DIR", "", TRUE);
+  ges_discovery_cache_store (info);
+  fail_unless (ges_discovery_cache_lookup (copy_uri) == NULL);
+  g_setenv ("GES_DISCOVERY_CACHE_DIR", cache_dir, TRUE);
+  fail_unless (ges_discovery_cache_lookup (copy_uri) == NULL);
+  gst_discoverer_info_unref (info);
+
+  gst_object_unref (asset);
+  g_file_delete (copy, NULL, NULL);
+  g_rmdir (cache_dir);
+  if (previous_cache_dir)
+    g_setenv ("GES_DISCOVERY_CACHE_DIR", previous_cache_dir, TRUE);
+  else
+    g_unsetenv ("GES_DISCOVERY_CACHE_DIR");
+  g_free (previous_cache_dir);
+
+  g_object_unref (media);
+  g_object_unref (copy);
+  g_free (media_uri);
+  g_free (copy_path);
+  g_free (copy_uri);
+  g_free (cache_dir);
+}
+
+GST_END_TEST;
+
+static void
+asset_loaded_cb (GObject * source, GAsyncResult * res, gint * remaining)
+{
+  GError *error = NULL;
+  GESAsset *asset = ges_asset_request_finish (res, &error);
+
+  fail_unless (asset != NULL);
+  fail_unless (error == NULL);
+  gst_object_unref (asset);
+
+  *remaining -= 1;
+  if (*remaining == 0)
+    g_main_loop_quit (mainloop);
+}
+
+static void
+discovered_cb (GstDiscoverer * discoverer, GstDiscovererInfo * info,
+    GError * err, GHashTable * discovered)
+{
+  const gchar *uri = gst_discoverer_info_get_uri (info);
+
+  g_hash_table_insert (discovered, g_strdup (uri),
+      GUINT_TO_POINTER (GPOINTER_TO_UINT (g_hash_table_lookup (discovered,
+                  uri)) + 1));
+}
+
+GST_START_TEST (test_parallel_discovery)
+{
+  guint i;
+  GDir *dir;
+  GList *tmp, *discoverers;
+  gchar *uris[3];
+  gint remaining = 0;
+  const gchar *filename;
+  gchar *cache_dir;
+  GHashTable *discovered;
+  GESUriClipAssetClass *klass;
+  gchar *previous_cache_dir = g_strdup (g_getenv ("GES_DISCOVERY_CACHE_DIR"));
+
+  fail_unless (ges_init ());
+
+  /* Make sure the files actually get discovered */
+  cache_dir = g_dir_make_tmp ("ges-discovery-cache-XXXXXX", NULL);
+  fail_unless (cache_dir != NULL);
+  g_setenv ("GES_DISCOVERY_CACHE_DIR", cache_dir, TRUE);
+
+  klass = g_type_class_ref (GES_TYPE_URI_CLIP_ASSET);
+  ges_uri_clip_asset_class_set_discoverer_pool_size (klass, 2);
+
+  uris[0] = ges_test_get_audio_only_uri ();
+  uris[1] = ges_test_get_audio_video_uri ();
+  uris[2] = ges_test_get_image_uri ();
+
+  /* Every URI is requested twice while it is being discovered */
+  mainloop = g_main_loop_new (NULL, FALSE);
+  for (i = 0; i < 2 * G_N_ELEMENTS (uris); i++) {
+    remaining++;
+    ges_asset_request_async (GES_TYPE_URI_CLIP, uris[i % G_N_ELEMENTS (uris)],
+        NULL, (GAsyncReadyCallback) asset_loaded_cb, &remaining);
+  }
+
+  /* The pool grew to its maximum size to discover the URIs in parallel */
+  discoverers = ges_discoverer_pool_get_discoverers ();
+  assert_equals_int (g_list_length (discoverers), 2);
+  discovered = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  for (tmp = discoverers; tmp; tmp = tmp->next)
+    g_signal_connect (tmp->data, "discovered", G_CALLBACK (discovered_cb),
+        discovered);
+
+  g_main_loop_run (mainloop);
+  assert_equals_int (remaining, 0);
+
+  /* Each URI got discovered exactly once */
+  assert_equals_int (g_hash_table_size (discovered), G_N_ELEMENTS (uris));
+  for (i = 0; i < G_N_ELEMENTS (uris); i++) {
+    GESAsset *asset = ges_asset_cache_lookup (GES_TYPE_URI_CLIP, uris[i]);
+
+    assert_equals_int (GPOINTER_TO_UINT (g_hash_table_lookup (discovered,
+                uris[i])), 1);
+    fail_unless (asset != NULL);
+    fail_unless (ges_uri_clip_asset_get_info (GES_URI_CLIP_ASSET (asset)));
+    g_free (uris[i]);
+  }
+
+  for (tmp = discoverers; tmp; tmp = tmp->next)
+    g_signal_handlers_disconnect_by_func (tmp->data, discovered_cb,
+        discovered);
+  g_list_free_full (discoverers, gst_object_unref);
+  g_hash_table_unref (discovered);
+
+  dir = g_dir_open (cache_dir, 0, NULL);
+  while ((filename = g_dir_read_name (dir))) {
+    gchar *path = g_build_filename (cache_dir, filename, NULL);
+
+    g_unlink (path);
+    g_free (path);
+  }
+  g_dir_close (dir);
+  g_rmdir (cache_dir);
+  if (previous_cache_dir)
+    g_setenv ("GES_DISCOVERY_CACHE_DIR", previous_cache_dir, TRUE);
+  else
+    g_unsetenv ("GES_DISCOVERY_CACHE_DIR");
+  g_free (previous_cache_dir);
+
+  g_main_loop_unref (mainloop);
+  g_type_class_unref (klass);
+  g_free (cache_dir);
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -216,6 +397,8 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_transition_change_asset);
   tcase_add_test (tc_chain, test_uri_clip_change_asset);
   tcase_add_test (tc_chain, test_proxy_asset);
+  tcase_add_test (tc_chain, test_discovery_cache);
+  tcase_add_test (tc_chain, test_parallel_discovery);
 
   return s;
 }
@@ -199,6 +199,86 @@ GST_START_TEST (test_test_source_in_layer)
 
 GST_END_TEST;
 
+static GstElement *
+get_positioner_upstream_element (GESTrackElement * source)
+{
+  GstPad *sinkpad, *peer;
+  GstElement *positioner, *upstream;
+
+  positioner =
+      gst_bin_get_by_name (GST_BIN (ges_track_element_get_nleobject (source)),
+      "frame_tagger");
+  fail_unless (positioner != NULL);
+
+  sinkpad = gst_element_get_static_pad (positioner, "sink");
+  peer = gst_pad_get_peer (sinkpad);
+  fail_unless (peer != NULL);
+  upstream = gst_pad_get_parent_element (peer);
+
+  gst_object_unref (peer);
+  gst_object_unref (sinkpad);
+  gst_object_unref (positioner);
+
+  return upstream;
+}
+
+GST_START_TEST (test_video_source_conversion_bypass)
+{
+  GESAsset *asset;
+  GESTrack *track;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+  GESLayer *layer, *layer1;
+  GESClip *clip, *clip1;
+  GstElement *upstream;
+  GESTrackElement *source, *source1;
+  GstCaps *caps = gst_caps_from_string ("video/x-raw,framerate=30/1");
+
+  timeline = ges_timeline_new ();
+  track = GES_TRACK (ges_video_track_new ());
+  ges_track_set_restriction_caps (track, caps);
+  gst_caps_unref (caps);
+  fail_unless (ges_timeline_add_track (timeline, track));
+  layer = ges_timeline_append_layer (timeline);
+  layer1 = ges_timeline_append_layer (timeline);
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  clip = ges_layer_add_asset (layer, asset, 0, 0, GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  clip1 = ges_layer_add_asset (layer1, asset, 0, 0, GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  gst_object_unref (asset);
+  source = GES_CONTAINER_CHILDREN (clip)->data;
+  source1 = GES_CONTAINER_CHILDREN (clip1)->data;
+
+  /* Forcing deinterlacing requires the whole conversion chain */
+  ges_timeline_element_set_child_properties (GES_TIMELINE_ELEMENT (source1),
+      "deinterlace-mode", 1, NULL);
+
+  pipeline = ges_test_create_pipeline (timeline);
+  fail_if (gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PAUSED)
+      == GST_STATE_CHANGE_FAILURE);
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), NULL, NULL,
+          5 * GST_SECOND) == GST_STATE_CHANGE_SUCCESS);
+
+  /* The test source produces progressive frames at the track framerate,
+   * the positioner is fed straight from the queue */
+  upstream = get_positioner_upstream_element (source);
+  assert_equals_string (GST_OBJECT_NAME (gst_element_get_factory (upstream)),
+      "queue");
+  gst_object_unref (upstream);
+
+  upstream = get_positioner_upstream_element (source1);
+  assert_equals_string (GST_OBJECT_NAME (gst_element_get_factory (upstream)),
+      "deinterlace");
+  gst_object_unref (upstream);
+
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
 #if 0
 static gint
 find_composition_func (const GValue * velement)
@@ -405,6 +485,7 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_test_source_basic);
   tcase_add_test (tc_chain, test_test_source_properties);
   tcase_add_test (tc_chain, test_test_source_in_layer);
+  tcase_add_test (tc_chain, test_video_source_conversion_bypass);
 
 #if 0
   tcase_add_test (tc_chain, test_gap_filling_basic);
@@ -21,6 +21,7 @@
 
 #include "test-utils.h"
 
+#include <glib/gstdio.h>
 #include <ges/ges.h>
 #include <gst/check/gstcheck.h>
 
@@ -691,6 +692,219 @@ GST_START_TEST (test_ges_pipeline_change_state)
 
 GST_END_TEST;
 
+GST_START_TEST (test_ges_pipeline_unused_track)
+{
+  GList *tmp;
+  GstState state;
+  GESAsset *asset;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+
+  layer = ges_layer_new ();
+  timeline = ges_timeline_new_audio_video ();
+  fail_unless (ges_timeline_add_layer (timeline, layer));
+
+  pipeline = ges_test_create_pipeline (timeline);
+  fail_unless (ges_pipeline_set_mode (pipeline,
+          GES_PIPELINE_MODE_PREVIEW_AUDIO));
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  ges_layer_add_asset (layer, asset, 0, 0, 10, GES_TRACK_TYPE_UNKNOWN);
+  gst_object_unref (asset);
+
+  ges_timeline_commit (timeline);
+  ASSERT_SET_STATE (GST_ELEMENT (pipeline), GST_STATE_PAUSED,
+      GST_STATE_CHANGE_ASYNC);
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), &state, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+  fail_unless (state == GST_STATE_PAUSED);
+
+  /* Nothing consumes the video track, it must not be running */
+  for (tmp = timeline->tracks; tmp; tmp = tmp->next) {
+    gst_element_get_state (tmp->data, &state, NULL, 0);
+
+    if (GES_IS_VIDEO_TRACK (tmp->data))
+      assert_equals_int (state, GST_STATE_READY);
+    else
+      assert_equals_int (state, GST_STATE_PAUSED);
+  }
+
+  ASSERT_SET_STATE (GST_ELEMENT (pipeline), GST_STATE_NULL,
+      GST_STATE_CHANGE_SUCCESS);
+  for (tmp = timeline->tracks; tmp; tmp = tmp->next)
+    fail_if (gst_element_is_locked_state (tmp->data));
+
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
+static GstEncodingProfile *
+create_ogg_profile (const gchar * name, gboolean with_video,
+    const gchar * video_restriction)
+{
+  GstCaps *caps, *restriction = NULL;
+  GstEncodingContainerProfile *profile;
+
+  caps = gst_caps_from_string ("application/ogg");
+  profile = gst_encoding_container_profile_new (name, NULL, caps, NULL);
+  gst_caps_unref (caps);
+
+  caps = gst_caps_from_string ("audio/x-vorbis");
+  gst_encoding_container_profile_add_profile (profile,
+      (GstEncodingProfile *) gst_encoding_audio_profile_new (caps, NULL, NULL,
+          0));
+  gst_caps_unref (caps);
+
+  if (with_video) {
+    caps = gst_caps_from_string ("video/x-theora");
+    if (video_restriction)
+      restriction = gst_caps_from_string (video_restriction);
+    gst_encoding_container_profile_add_profile (profile,
+        (GstEncodingProfile *) gst_encoding_video_profile_new (caps, NULL,
+            restriction, 0));
+    gst_caps_unref (caps);
+    if (restriction)
+      gst_caps_unref (restriction);
+  }
+
+  return GST_ENCODING_PROFILE (profile);
+}
+
+/* Checks that the tracks are linked once to each of the encodebins of
+ * @pipeline, and only if their profile has a stream for them */
+static void
+check_encodebins_inputs (GESPipeline * pipeline)
+{
+  GValue item = G_VALUE_INIT;
+  guint n_encodebins = 0;
+  GstIterator *it = gst_bin_iterate_elements (GST_BIN (pipeline));
+
+  while (gst_iterator_next (it, &item) == GST_ITERATOR_OK) {
+    GstPad *pad;
+    GstIterator *pads;
+    GValue pad_item = G_VALUE_INIT;
+    guint n_audio = 0, n_video = 0;
+    GstEncodingProfile *profile;
+    GstElement *element = g_value_get_object (&item);
+    GstElementFactory *factory = gst_element_get_factory (element);
+
+    if (!factory || g_strcmp0 (GST_OBJECT_NAME (factory), "encodebin")) {
+      g_value_reset (&item);
+      continue;
+    }
+
+    n_encodebins++;
+    pads = gst_element_iterate_sink_pads (element);
+    while (gst_iterator_next (pads, &pad_item) == GST_ITERATOR_OK) {
+      pad = g_value_get_object (&pad_item);
+
+      if (gst_pad_is_linked (pad)) {
+        if (g_str_has_prefix (GST_OBJECT_NAME (pad), "audio"))
+          n_audio++;
+        else if (g_str_has_prefix (GST_OBJECT_NAME (pad), "video"))
+          n_video++;
+      }
+      g_value_reset (&pad_item);
+    }
+    g_value_unset (&pad_item);
+    gst_iterator_free (pads);
+
+    g_object_get (element, "profile", &profile, NULL);
+    fail_unless (profile != NULL);
+    assert_equals_int (n_audio, 1);
+    if (!g_strcmp0 (gst_encoding_profile_get_name (profile), "audio-only"))
+      assert_equals_int (n_video, 0);
+    else
+      assert_equals_int (n_video, 1);
+    gst_encoding_profile_unref (profile);
+
+    g_value_reset (&item);
+  }
+  g_value_unset (&item);
+  gst_iterator_free (it);
+
+  assert_equals_int (n_encodebins, 3);
+}
+
+static void
+check_rendered_file (const gchar * uri)
+{
+  GStatBuf stat_buf;
+  gchar *location = gst_uri_get_location (uri);
+
+  fail_unless (g_stat (location, &stat_buf) == 0, "%s was not rendered", uri);
+  fail_unless (stat_buf.st_size > 0, "%s is empty", uri);
+  g_unlink (location);
+  g_free (location);
+}
+
+GST_START_TEST (test_ges_pipeline_render_targets)
+{
+  guint i;
+  GstBus *bus;
+  GESAsset *asset;
+  GESLayer *layer;
+  GstMessage *msg;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+  GstEncodingProfile *profile;
+  gchar *uris[3];
+
+  uris[0] = ges_test_get_tmp_uri ("render-target-main.ogg");
+  uris[1] = ges_test_get_tmp_uri ("render-target-audio-only.ogg");
+  uris[2] = ges_test_get_tmp_uri ("render-target-small.ogg");
+
+  layer = ges_layer_new ();
+  timeline = ges_timeline_new_audio_video ();
+  fail_unless (ges_timeline_add_layer (timeline, layer));
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  fail_unless (ges_layer_add_asset (layer, asset, 0, 0, GST_SECOND / 2,
+          GES_TRACK_TYPE_UNKNOWN));
+  gst_object_unref (asset);
+  ges_timeline_commit (timeline);
+
+  pipeline = ges_test_create_pipeline (timeline);
+  profile = create_ogg_profile ("main", TRUE, NULL);
+  fail_unless (ges_pipeline_set_render_settings (pipeline, uris[0], profile));
+  gst_encoding_profile_unref (profile);
+  profile = create_ogg_profile ("audio-only", FALSE, NULL);
+  fail_unless (ges_pipeline_add_render_target (pipeline, uris[1], profile));
+  gst_encoding_profile_unref (profile);
+  profile = create_ogg_profile ("small", TRUE,
+      "video/x-raw,width=160,height=120");
+  fail_unless (ges_pipeline_add_render_target (pipeline, uris[2], profile));
+  gst_encoding_profile_unref (profile);
+  fail_unless (ges_pipeline_set_mode (pipeline, GES_PIPELINE_MODE_RENDER));
+
+  bus = gst_element_get_bus (GST_ELEMENT (pipeline));
+  ASSERT_SET_STATE (GST_ELEMENT (pipeline), GST_STATE_PLAYING,
+      GST_STATE_CHANGE_ASYNC);
+  msg = gst_bus_timed_pop_filtered (bus, 10 * GST_SECOND,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (msg != NULL);
+  if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR)
+    fail_error_message (msg);
+  gst_message_unref (msg);
+
+  check_encodebins_inputs (pipeline);
+
+  ASSERT_SET_STATE (GST_ELEMENT (pipeline), GST_STATE_NULL,
+      GST_STATE_CHANGE_SUCCESS);
+
+  for (i = 0; i < G_N_ELEMENTS (uris); i++) {
+    check_rendered_file (uris[i]);
+    g_free (uris[i]);
+  }
+
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_ges_timeline_element_name)
 {
   GESClip *clip, *clip1, *clip2, *clip3, *clip4, *clip5;
@@ -773,6 +987,8 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_ges_timeline_remove_track);
   tcase_add_test (tc_chain, test_ges_timeline_multiple_tracks);
   tcase_add_test (tc_chain, test_ges_pipeline_change_state);
+  tcase_add_test (tc_chain, test_ges_pipeline_unused_track);
+  tcase_add_test (tc_chain, test_ges_pipeline_render_targets);
   tcase_add_test (tc_chain, test_ges_timeline_element_name);
 
   return s;
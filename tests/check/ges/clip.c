@@ -270,6 +270,107 @@ GST_START_TEST (test_split_direct_absolute_bindings)
 GST_END_TEST;
 
 
+static void
+check_keyframes (GstTimedValueControlSource * source, guint n_values,
+    const GstClockTime * timestamps, const gdouble * values)
+{
+  guint i;
+  GList *tmp, *keyframes = gst_timed_value_control_source_get_all (source);
+
+  assert_equals_int (g_list_length (keyframes), n_values);
+  for (i = 0, tmp = keyframes; tmp; tmp = tmp->next, i++) {
+    GstTimedValue *value = tmp->data;
+
+    assert_equals_uint64 (value->timestamp, timestamps[i]);
+    assert_equals_float (value->value, values[i]);
+  }
+  g_list_free (keyframes);
+}
+
+GST_START_TEST (test_trim_bindings)
+{
+  GESTimeline *timeline;
+  GESLayer *layer;
+  GESAsset *asset;
+  GESClip *clip;
+  GstControlSource *source;
+  GESTrackElement *element;
+
+  fail_unless ((timeline = ges_timeline_new ()));
+  fail_unless ((layer = ges_layer_new ()));
+  fail_unless (ges_timeline_add_track (timeline,
+          GES_TRACK (ges_video_track_new ())));
+  fail_unless (ges_timeline_add_layer (timeline, layer));
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  clip = ges_layer_add_asset (layer, asset, 0, 10 * GST_SECOND, 10 * GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  assert_equals_int (g_list_length (GES_CONTAINER_CHILDREN (clip)), 1);
+
+  source = gst_interpolation_control_source_new ();
+  g_object_set (source, "mode", GST_INTERPOLATION_MODE_LINEAR, NULL);
+  element = GES_CONTAINER_CHILDREN (clip)->data;
+  fail_unless (ges_track_element_set_control_source (element,
+          source, "alpha", "direct"));
+
+  gst_timed_value_control_source_set (GST_TIMED_VALUE_CONTROL_SOURCE (source),
+      10 * GST_SECOND, 0.0);
+  gst_timed_value_control_source_set (GST_TIMED_VALUE_CONTROL_SOURCE (source),
+      12 * GST_SECOND, 1.0);
+  gst_timed_value_control_source_set (GST_TIMED_VALUE_CONTROL_SOURCE (source),
+      20 * GST_SECOND, 0.0);
+
+  /* Keyframes out of the clip are replaced by one at its end */
+  fail_unless (ges_timeline_element_set_duration (GES_TIMELINE_ELEMENT (clip),
+          GST_SECOND));
+  {
+    GstClockTime timestamps[] = { 10 * GST_SECOND, 11 * GST_SECOND };
+    gdouble values[] = { 0.0, 0.5 };
+
+    check_keyframes (GST_TIMED_VALUE_CONTROL_SOURCE (source), 2, timestamps,
+        values);
+  }
+
+  /* And come back when it grows again */
+  fail_unless (ges_timeline_element_set_duration (GES_TIMELINE_ELEMENT (clip),
+          10 * GST_SECOND));
+  {
+    GstClockTime timestamps[] =
+        { 10 * GST_SECOND, 12 * GST_SECOND, 20 * GST_SECOND };
+    gdouble values[] = { 0.0, 1.0, 0.0 };
+
+    check_keyframes (GST_TIMED_VALUE_CONTROL_SOURCE (source), 3, timestamps,
+        values);
+  }
+
+  fail_unless (ges_timeline_element_set_inpoint (GES_TIMELINE_ELEMENT (clip),
+          11 * GST_SECOND));
+  {
+    GstClockTime timestamps[] =
+        { 11 * GST_SECOND, 12 * GST_SECOND, 20 * GST_SECOND };
+    gdouble values[] = { 0.5, 1.0, 0.0 };
+
+    check_keyframes (GST_TIMED_VALUE_CONTROL_SOURCE (source), 3, timestamps,
+        values);
+  }
+
+  fail_unless (ges_timeline_element_set_inpoint (GES_TIMELINE_ELEMENT (clip),
+          10 * GST_SECOND));
+  {
+    GstClockTime timestamps[] =
+        { 10 * GST_SECOND, 12 * GST_SECOND, 20 * GST_SECOND };
+    gdouble values[] = { 0.0, 1.0, 0.0 };
+
+    check_keyframes (GST_TIMED_VALUE_CONTROL_SOURCE (source), 3, timestamps,
+        values);
+  }
+
+  gst_object_unref (timeline);
+  gst_object_unref (asset);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_split_object)
 {
   GESTimeline *timeline;
@@ -695,6 +796,7 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_split_object);
   tcase_add_test (tc_chain, test_split_direct_bindings);
   tcase_add_test (tc_chain, test_split_direct_absolute_bindings);
+  tcase_add_test (tc_chain, test_trim_bindings);
   tcase_add_test (tc_chain, test_clip_group_ungroup);
   tcase_add_test (tc_chain, test_clip_refcount_remove_child);
   tcase_add_test (tc_chain, test_clip_find_track_element);
@@ -1815,6 +1815,306 @@ GST_START_TEST (test_layer_get_clips_in_interval)
   fail_unless (current->data == GES_TIMELINE_ELEMENT (clip2));
   g_list_free_full (objects, gst_object_unref);
 
+  /* Moving and trimming clips is taken into account */
+  g_object_set (clip3, "start", 70, "duration", 30, NULL);
+  g_object_set (clip2, "duration", 40, NULL);
+
+  objects = ges_layer_get_clips_in_interval (layer, 0, 10);
+  assert_equals_int (g_list_length (objects), 0);
+
+  current = objects = ges_layer_get_clips_in_interval (layer, 85, 95);
+  assert_equals_int (g_list_length (objects), 2);
+  fail_unless (current->data == GES_TIMELINE_ELEMENT (clip2));
+  current = current->next;
+  fail_unless (current->data == GES_TIMELINE_ELEMENT (clip3));
+  g_list_free_full (objects, gst_object_unref);
+
+  /* A long clip spans every later interval */
+  g_object_set (clip, "duration", 1000, NULL);
+  assert_equals_uint64 (ges_layer_get_duration (layer), 1010);
+
+  current = objects = ges_layer_get_clips_in_interval (layer, 85, 95);
+  assert_equals_int (g_list_length (objects), 3);
+  fail_unless (current->data == GES_TIMELINE_ELEMENT (clip));
+  current = current->next;
+  fail_unless (current->data == GES_TIMELINE_ELEMENT (clip2));
+  current = current->next;
+  fail_unless (current->data == GES_TIMELINE_ELEMENT (clip3));
+  g_list_free_full (objects, gst_object_unref);
+
+  current = objects = ges_layer_get_clips_in_interval (layer, 500, 600);
+  assert_equals_int (g_list_length (objects), 1);
+  fail_unless (current->data == GES_TIMELINE_ELEMENT (clip));
+  g_list_free_full (objects, gst_object_unref);
+
+  g_object_set (clip, "duration", 30, NULL);
+  assert_equals_uint64 (ges_layer_get_duration (layer), 100);
+}
+
+GST_END_TEST;
+
+static guint
+count_layer_clips (GESLayer * layer)
+{
+  GList *clips = ges_layer_get_clips (layer);
+  guint nclips = g_list_length (clips);
+
+  g_list_free_full (clips, gst_object_unref);
+
+  return nclips;
+}
+
+GST_START_TEST (test_layer_add_clips_batch)
+{
+  guint i;
+  GESAsset *asset;
+  GESLayer *layer;
+  GList *clips = NULL;
+  GESTimeline *timeline;
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  ges_layer_set_auto_transition (layer, TRUE);
+
+  /* Transitions are only created when the batch ends */
+  ges_timeline_begin_batch (timeline);
+  fail_unless (ges_layer_add_asset (layer, asset, 0, 0, 1000,
+          GES_TRACK_TYPE_UNKNOWN));
+  fail_unless (ges_layer_add_asset (layer, asset, 500, 0, 1000,
+          GES_TRACK_TYPE_UNKNOWN));
+  assert_equals_int (count_layer_clips (layer), 2);
+  ges_timeline_end_batch (timeline);
+
+  /* One transition per track */
+  assert_equals_int (count_layer_clips (layer), 4);
+
+  for (i = 0; i < 2; i++) {
+    GESClip *clip = GES_CLIP (ges_asset_extract (asset, NULL));
+
+    ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip),
+        2000 + i * 500);
+    ges_timeline_element_set_duration (GES_TIMELINE_ELEMENT (clip), 1000);
+    clips = g_list_append (clips, clip);
+  }
+
+  fail_unless (ges_layer_add_clips (layer, clips));
+  g_list_free (clips);
+  assert_equals_int (count_layer_clips (layer), 8);
+
+  gst_object_unref (timeline);
+  gst_object_unref (asset);
+}
+
+GST_END_TEST;
+
+static void
+count_notifies_cb (GObject * object, GParamSpec * pspec, guint * count)
+{
+  (*count)++;
+}
+
+GST_START_TEST (test_timeline_batch_notifications)
+{
+  GList *clips, *clips_in_interval, *tmp;
+  GESAsset *asset;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GESClip *c1, *c2;
+  GESTimelineElement *transition = NULL;
+  guint n_duration_notifies = 0, n_start_notifies = 0;
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  ges_layer_set_auto_transition (layer, TRUE);
+
+  c1 = ges_layer_add_asset (layer, asset, 0, 0, 1000, GES_TRACK_TYPE_UNKNOWN);
+  c2 = ges_layer_add_asset (layer, asset, 500, 0, 1000,
+      GES_TRACK_TYPE_UNKNOWN);
+  assert_equals_int (count_layer_clips (layer), 4);
+
+  clips = ges_layer_get_clips (layer);
+  for (tmp = clips; tmp; tmp = tmp->next) {
+    if (GES_IS_TRANSITION_CLIP (tmp->data)) {
+      transition = tmp->data;
+      break;
+    }
+  }
+  fail_unless (transition != NULL);
+  assert_equals_uint64 (_START (transition), 500);
+  assert_equals_uint64 (_DURATION (transition), 500);
+
+  g_signal_connect (timeline, "notify::duration",
+      G_CALLBACK (count_notifies_cb), &n_duration_notifies);
+  g_signal_connect (c2, "notify::start", G_CALLBACK (count_notifies_cb),
+      &n_start_notifies);
+
+  ges_timeline_begin_batch (timeline);
+  fail_unless (ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (c2),
+          600));
+  fail_unless (ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (c2),
+          700));
+
+  /* Nothing is notified nor moved along until the batch ends */
+  assert_equals_uint64 (ges_timeline_get_duration (timeline), 1700);
+  assert_equals_int (n_duration_notifies, 0);
+  assert_equals_int (n_start_notifies, 0);
+  assert_equals_uint64 (_START (transition), 500);
+
+  /* But the layer already knows where the clip is */
+  clips_in_interval = ges_layer_get_clips_in_interval (layer, 1500, 1600);
+  assert_equals_int (g_list_length (clips_in_interval), 1);
+  fail_unless (clips_in_interval->data == c2);
+  g_list_free_full (clips_in_interval, gst_object_unref);
+  ges_timeline_end_batch (timeline);
+
+  assert_equals_int (n_duration_notifies, 1);
+  assert_equals_int (n_start_notifies, 1);
+  assert_equals_uint64 (_START (transition), 700);
+  assert_equals_uint64 (_DURATION (transition), 300);
+  assert_equals_int (count_layer_clips (layer), 4);
+  assert_equals_uint64 (_START (c1), 0);
+
+  g_list_free_full (clips, gst_object_unref);
+  gst_object_unref (timeline);
+  gst_object_unref (asset);
+}
+
+GST_END_TEST;
+
+/* Number of transitions of @layer with the given timing, or all of them if
+ * @start is GST_CLOCK_TIME_NONE */
+static guint
+count_transitions (GESLayer * layer, GstClockTime start, GstClockTime duration)
+{
+  GList *tmp, *clips = ges_layer_get_clips (layer);
+  guint ntransitions = 0;
+
+  for (tmp = clips; tmp; tmp = tmp->next) {
+    if (!GES_IS_TRANSITION_CLIP (tmp->data))
+      continue;
+
+    if (!GST_CLOCK_TIME_IS_VALID (start) || (_START (tmp->data) == start &&
+            _DURATION (tmp->data) == duration))
+      ntransitions++;
+  }
+  g_list_free_full (clips, gst_object_unref);
+
+  return ntransitions;
+}
+
+GST_START_TEST (test_auto_transition_dirty_range)
+{
+  GESAsset *asset;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GESClip *a, *e;
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  ges_layer_set_auto_transition (layer, TRUE);
+
+  /* Two overlaps far from each other, one transition per track each */
+  a = ges_layer_add_asset (layer, asset, 0, 0, 1000, GES_TRACK_TYPE_UNKNOWN);
+  fail_unless (ges_layer_add_asset (layer, asset, 500, 0, 1000,
+          GES_TRACK_TYPE_UNKNOWN));
+  fail_unless (ges_layer_add_asset (layer, asset, 10000, 0, 1000,
+          GES_TRACK_TYPE_UNKNOWN));
+  fail_unless (ges_layer_add_asset (layer, asset, 10500, 0, 1000,
+          GES_TRACK_TYPE_UNKNOWN));
+  e = ges_layer_add_asset (layer, asset, 5000, 0, 1000,
+      GES_TRACK_TYPE_UNKNOWN);
+  ges_timeline_commit (timeline);
+  assert_equals_int (count_transitions (layer, 500, 500), 2);
+  assert_equals_int (count_transitions (layer, 10500, 500), 2);
+  assert_equals_int (count_transitions (layer, GST_CLOCK_TIME_NONE, 0), 4);
+
+  /* Editing between the overlaps leaves their transitions alone */
+  fail_unless (ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (e),
+          6000));
+  ges_timeline_commit (timeline);
+  assert_equals_int (count_transitions (layer, 500, 500), 2);
+  assert_equals_int (count_transitions (layer, 10500, 500), 2);
+  assert_equals_int (count_transitions (layer, GST_CLOCK_TIME_NONE, 0), 4);
+
+  /* Moving into the second overlap creates transitions only there */
+  fail_unless (ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (e),
+          11000));
+  ges_timeline_commit (timeline);
+  assert_equals_int (count_transitions (layer, 500, 500), 2);
+  assert_equals_int (count_transitions (layer, 10500, 500), 2);
+  assert_equals_int (count_transitions (layer, 11000, 500), 2);
+  assert_equals_int (count_transitions (layer, GST_CLOCK_TIME_NONE, 0), 6);
+
+  /* Both the old and the new position of a moved clip are dirty */
+  fail_unless (ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (e),
+          5000));
+  fail_unless (ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (a),
+          20000));
+  ges_timeline_commit (timeline);
+  assert_equals_int (count_transitions (layer, 10500, 500), 2);
+  assert_equals_int (count_transitions (layer, GST_CLOCK_TIME_NONE, 0), 2);
+
+  gst_object_unref (timeline);
+  gst_object_unref (asset);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_auto_transition_across_layers)
+{
+  GESAsset *asset;
+  GESTimeline *timeline;
+  GESLayer *layer, *layer1;
+  GESClip *clip, *audio_clip;
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  layer1 = ges_timeline_append_layer (timeline);
+  ges_layer_set_auto_transition (layer, TRUE);
+  ges_layer_set_auto_transition (layer1, TRUE);
+
+  /* Overlapping sources of different layers do not get transitions */
+  fail_unless (ges_layer_add_asset (layer, asset, 0, 0, 1000,
+          GES_TRACK_TYPE_UNKNOWN));
+  clip = ges_layer_add_asset (layer1, asset, 500, 0, 1000,
+      GES_TRACK_TYPE_UNKNOWN);
+  ges_timeline_commit (timeline);
+  assert_equals_int (count_transitions (layer, GST_CLOCK_TIME_NONE, 0), 0);
+  assert_equals_int (count_transitions (layer1, GST_CLOCK_TIME_NONE, 0), 0);
+
+  /* Its endpoints follow the clip to its new layer */
+  fail_unless (ges_clip_move_to_layer (clip, layer));
+  ges_timeline_commit (timeline);
+  assert_equals_int (count_transitions (layer, 500, 500), 2);
+  assert_equals_int (count_transitions (layer, GST_CLOCK_TIME_NONE, 0), 2);
+  assert_equals_int (count_transitions (layer1, GST_CLOCK_TIME_NONE, 0), 0);
+
+  fail_unless (ges_clip_move_to_layer (clip, layer1));
+  ges_timeline_commit (timeline);
+  assert_equals_int (count_transitions (layer, GST_CLOCK_TIME_NONE, 0), 0);
+  assert_equals_int (count_transitions (layer1, GST_CLOCK_TIME_NONE, 0), 0);
+
+  /* An audio only source only gets a transition in the audio track, and
+   * only once */
+  audio_clip = ges_layer_add_asset (layer1, asset, 700, 0, 1000,
+      GES_TRACK_TYPE_AUDIO);
+  ges_timeline_commit (timeline);
+  assert_equals_int (count_transitions (layer1, 700, 800), 1);
+  assert_equals_int (count_transitions (layer1, GST_CLOCK_TIME_NONE, 0), 1);
+  assert_equals_int (count_transitions (layer, GST_CLOCK_TIME_NONE, 0), 0);
+
+  fail_unless (ges_clip_move_to_layer (audio_clip, layer));
+  ges_timeline_commit (timeline);
+  assert_equals_int (count_transitions (layer, 700, 300), 1);
+  assert_equals_int (count_transitions (layer, GST_CLOCK_TIME_NONE, 0), 1);
+  assert_equals_int (count_transitions (layer1, GST_CLOCK_TIME_NONE, 0), 0);
+
+  gst_object_unref (timeline);
+  gst_object_unref (asset);
 }
 
 GST_END_TEST;
@@ -1853,6 +2153,10 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_layer_meta_register);
   tcase_add_test (tc_chain, test_layer_meta_foreach);
   tcase_add_test (tc_chain, test_layer_get_clips_in_interval);
+  tcase_add_test (tc_chain, test_layer_add_clips_batch);
+  tcase_add_test (tc_chain, test_timeline_batch_notifications);
+  tcase_add_test (tc_chain, test_auto_transition_dirty_range);
+  tcase_add_test (tc_chain, test_auto_transition_across_layers);
 
   return s;
 }
@@ -19,8 +19,10 @@
  */
 
 #include "test-utils.h"
+#include "../../../ges/ges-internal.h"
 #include <ges/ges.h>
 #include <gst/check/gstcheck.h>
+#include <string.h>
 
 #define DEEP_CHECK(element, start, inpoint, duration)                          \
 {                                                                              \
@@ -1301,6 +1303,123 @@ check_frame_positioner_size (GESClip * clip, gint width, gint height)
   return (width == real_width && height == real_height);
 }
 
+GST_START_TEST (test_snapping_points)
+{
+  GESAsset *asset;
+  GESTimeline *timeline;
+  GESLayer *layer;
+  GESClip *c, *c1;
+
+  timeline = ges_timeline_new_audio_video ();
+  g_object_set (timeline, "snapping-distance", (guint64) 3, NULL);
+  layer = ges_timeline_append_layer (timeline);
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+
+  c = ges_layer_add_asset (layer, asset, 0, 0, 10, GES_TRACK_TYPE_UNKNOWN);
+  c1 = ges_layer_add_asset (layer, asset, 100, 0, 10, GES_TRACK_TYPE_UNKNOWN);
+  CHECK_OBJECT_PROPS (c, 0, 0, 10);
+  CHECK_OBJECT_PROPS (c1, 100, 0, 10);
+
+  ges_timeline_add_snapping_point (timeline, 42);
+
+  /* Start snaps to the snapping point */
+  fail_unless (ges_container_edit (GES_CONTAINER (c), NULL, -1,
+          GES_EDIT_MODE_NORMAL, GES_EDGE_NONE, 40));
+  DEEP_CHECK (c, 42, 0, 10);
+
+  /* End snaps to the snapping point */
+  fail_unless (ges_container_edit (GES_CONTAINER (c), NULL, -1,
+          GES_EDIT_MODE_NORMAL, GES_EDGE_NONE, 30));
+  DEEP_CHECK (c, 32, 0, 10);
+
+  /* The edges of sources win over snapping points at the same distance */
+  ges_timeline_add_snapping_point (timeline, 98);
+  fail_unless (ges_container_edit (GES_CONTAINER (c), NULL, -1,
+          GES_EDIT_MODE_NORMAL, GES_EDGE_NONE, 89));
+  DEEP_CHECK (c, 90, 0, 10);
+
+  fail_unless (ges_timeline_remove_snapping_point (timeline, 42));
+  fail_unless (ges_timeline_remove_snapping_point (timeline, 98));
+  fail_if (ges_timeline_remove_snapping_point (timeline, 42));
+
+  fail_unless (ges_container_edit (GES_CONTAINER (c), NULL, -1,
+          GES_EDIT_MODE_NORMAL, GES_EDGE_NONE, 40));
+  DEEP_CHECK (c, 40, 0, 10);
+
+  gst_object_unref (timeline);
+  gst_object_unref (asset);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_repeated_ripples)
+{
+  GESAsset *asset;
+  GESTimeline *timeline;
+  GESLayer *layer, *layer1;
+  GESClip *c, *c1, *c2;
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  layer1 = ges_timeline_append_layer (timeline);
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+
+  /*          10------20         30------40
+   * L        |   c   |          |  c1   |
+   *      5--------15
+   * L1   |   c2   |
+   */
+  c = ges_layer_add_asset (layer, asset, 10, 0, 10, GES_TRACK_TYPE_UNKNOWN);
+  c1 = ges_layer_add_asset (layer, asset, 30, 0, 10, GES_TRACK_TYPE_UNKNOWN);
+  c2 = ges_layer_add_asset (layer1, asset, 5, 0, 10, GES_TRACK_TYPE_UNKNOWN);
+
+  /* The same context is used for the successive ripples */
+  fail_unless (ges_container_edit (GES_CONTAINER (c), NULL, -1,
+          GES_EDIT_MODE_RIPPLE, GES_EDGE_NONE, 12));
+  DEEP_CHECK (c, 12, 0, 10);
+  DEEP_CHECK (c1, 32, 0, 10);
+  DEEP_CHECK (c2, 5, 0, 10);
+  fail_unless (ges_container_edit (GES_CONTAINER (c), NULL, -1,
+          GES_EDIT_MODE_RIPPLE, GES_EDGE_NONE, 20));
+  DEEP_CHECK (c, 20, 0, 10);
+  DEEP_CHECK (c1, 40, 0, 10);
+  DEEP_CHECK (c2, 5, 0, 10);
+
+  /* c now starts before c2, so c2 has to be rippled too next time */
+  fail_unless (ges_container_edit (GES_CONTAINER (c), NULL, -1,
+          GES_EDIT_MODE_RIPPLE, GES_EDGE_NONE, 2));
+  DEEP_CHECK (c, 2, 0, 10);
+  DEEP_CHECK (c1, 22, 0, 10);
+  DEEP_CHECK (c2, 5, 0, 10);
+  fail_unless (ges_container_edit (GES_CONTAINER (c), NULL, -1,
+          GES_EDIT_MODE_RIPPLE, GES_EDGE_NONE, 12));
+  DEEP_CHECK (c, 12, 0, 10);
+  DEEP_CHECK (c1, 32, 0, 10);
+  DEEP_CHECK (c2, 15, 0, 10);
+
+  /* Same thing rippling the end */
+  fail_unless (ges_container_edit (GES_CONTAINER (c2), NULL, -1,
+          GES_EDIT_MODE_RIPPLE, GES_EDGE_END, 30));
+  DEEP_CHECK (c2, 15, 0, 15);
+  DEEP_CHECK (c1, 37, 0, 10);
+  DEEP_CHECK (c, 12, 0, 10);
+  fail_unless (ges_container_edit (GES_CONTAINER (c2), NULL, -1,
+          GES_EDIT_MODE_RIPPLE, GES_EDGE_END, 20));
+  DEEP_CHECK (c2, 15, 0, 5);
+  DEEP_CHECK (c1, 27, 0, 10);
+  DEEP_CHECK (c, 12, 0, 10);
+  fail_unless (ges_container_edit (GES_CONTAINER (c2), NULL, -1,
+          GES_EDIT_MODE_RIPPLE, GES_EDGE_END, 22));
+  DEEP_CHECK (c2, 15, 0, 7);
+  DEEP_CHECK (c1, 29, 0, 10);
+  DEEP_CHECK (c, 12, 0, 10);
+
+  gst_object_unref (timeline);
+  gst_object_unref (asset);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_scaling)
 {
   GESTimeline *timeline;
@@ -1495,6 +1614,286 @@ GST_START_TEST (test_scaling)
 
 GST_END_TEST;
 
+typedef struct
+{
+  guint n_shifts;
+  guint64 position;
+  gint64 offset;
+} RangeShift;
+
+static void
+_range_shifted_cb (GESTimeline * timeline, guint64 position, gint64 offset,
+    RangeShift * shift)
+{
+  shift->n_shifts++;
+  shift->position = position;
+  shift->offset = offset;
+}
+
+static void
+_count_notifies_cb (GObject * object, GParamSpec * pspec, guint * count)
+{
+  (*count)++;
+}
+
+GST_START_TEST (test_ripple_over_unmoved)
+{
+  RangeShift shift = { 0, };
+  guint n_start_notifies = 0;
+  GList *layers;
+  GESAsset *asset;
+  GESTimeline *timeline;
+  GESLayer *layer, *layer1;
+  GESClip *clip, *clip1, *clip2, *unmoved, *unmoved1;
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  layer1 = ges_timeline_append_layer (timeline);
+
+  /* Only the elements of the first layer get rippled, going over the ones
+   * of the second layer
+   *
+   * 0---clip---10---clip1---20---clip2---30
+   *        5---unmoved---25      28---unmoved1---33
+   */
+  clip = ges_layer_add_asset (layer, asset, 0, 0, 10, GES_TRACK_TYPE_UNKNOWN);
+  clip1 = ges_layer_add_asset (layer, asset, 10, 0, 10,
+      GES_TRACK_TYPE_UNKNOWN);
+  clip2 = ges_layer_add_asset (layer, asset, 20, 0, 10,
+      GES_TRACK_TYPE_UNKNOWN);
+  unmoved = ges_layer_add_asset (layer1, asset, 5, 0, 20,
+      GES_TRACK_TYPE_UNKNOWN);
+  unmoved1 = ges_layer_add_asset (layer1, asset, 28, 0, 5,
+      GES_TRACK_TYPE_UNKNOWN);
+  fail_unless (ges_timeline_check_indexes (timeline));
+
+  layers = g_list_append (NULL, layer);
+  g_signal_connect (timeline, "range-shifted",
+      G_CALLBACK (_range_shifted_cb), &shift);
+  g_signal_connect (clip2, "notify::start", G_CALLBACK (_count_notifies_cb),
+      &n_start_notifies);
+
+  /* Forward, over both unmoved clips */
+  fail_unless (ges_container_edit (GES_CONTAINER (clip1), layers, -1,
+          GES_EDIT_MODE_RIPPLE, GES_EDGE_NONE, 40));
+  assert_equals_uint64 (_START (clip), 0);
+  assert_equals_uint64 (_START (clip1), 40);
+  assert_equals_uint64 (_START (clip2), 50);
+  assert_equals_uint64 (_START (unmoved), 5);
+  assert_equals_uint64 (_START (unmoved1), 28);
+  fail_unless (ges_timeline_check_indexes (timeline));
+
+  /* The shift is signaled once, and each moved clip notified once */
+  assert_equals_int (shift.n_shifts, 1);
+  assert_equals_uint64 (shift.position, 10);
+  assert_equals_int64 (shift.offset, 30);
+  assert_equals_int (n_start_notifies, 1);
+
+  /* Backward, over them again and before the start of the first one */
+  fail_unless (ges_container_edit (GES_CONTAINER (clip1), layers, -1,
+          GES_EDIT_MODE_RIPPLE, GES_EDGE_NONE, 2));
+  assert_equals_uint64 (_START (clip), 0);
+  assert_equals_uint64 (_START (clip1), 2);
+  assert_equals_uint64 (_START (clip2), 12);
+  assert_equals_uint64 (_START (unmoved), 5);
+  assert_equals_uint64 (_START (unmoved1), 28);
+  fail_unless (ges_timeline_check_indexes (timeline));
+
+  /* Rippling the end of a clip moves the following ones only */
+  fail_unless (ges_container_edit (GES_CONTAINER (clip1), layers, -1,
+          GES_EDIT_MODE_RIPPLE, GES_EDGE_END, 35));
+  assert_equals_uint64 (_DURATION (clip1), 33);
+  assert_equals_uint64 (_START (clip2), 35);
+  fail_unless (ges_timeline_check_indexes (timeline));
+  assert_equals_int (shift.n_shifts, 3);
+  assert_equals_uint64 (shift.position, 12);
+  assert_equals_int64 (shift.offset, 23);
+
+  g_list_free (layers);
+  gst_object_unref (timeline);
+  gst_object_unref (asset);
+}
+
+GST_END_TEST;
+
+static void
+check_track_output_size (GESTrack * track, gint width, gint height)
+{
+  GList *tmp;
+  GstStructure *structure;
+  GstCaps *caps;
+  GstElement *capsfilter = NULL;
+  gint real_width, real_height;
+
+  for (tmp = GST_BIN_CHILDREN (track); tmp; tmp = tmp->next) {
+    if (!g_strcmp0 (GST_OBJECT_NAME (gst_element_get_factory (tmp->data)),
+            "capsfilter"))
+      capsfilter = tmp->data;
+  }
+  fail_unless (capsfilter != NULL);
+
+  g_object_get (capsfilter, "caps", &caps, NULL);
+  structure = gst_caps_get_structure (caps, 0);
+  fail_unless (gst_structure_get_int (structure, "width", &real_width));
+  fail_unless (gst_structure_get_int (structure, "height", &real_height));
+  assert_equals_int (real_width, width);
+  assert_equals_int (real_height, height);
+  gst_caps_unref (caps);
+}
+
+GST_START_TEST (test_preview_scale)
+{
+  GESTimeline *timeline;
+  GESLayer *layer;
+  GESAsset *asset;
+  GESClip *clip;
+  GESTrack *trackv = GES_TRACK (ges_video_track_new ());
+  GstCaps *caps =
+      gst_caps_new_simple ("video/x-raw", "width", G_TYPE_INT, 1280, "height",
+      G_TYPE_INT, 720, NULL);
+
+  timeline = ges_timeline_new ();
+  ges_timeline_add_track (timeline, trackv);
+  layer = ges_timeline_append_layer (timeline);
+  ges_track_set_restriction_caps (trackv, caps);
+  gst_caps_unref (caps);
+
+  asset = GES_ASSET (ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL));
+  clip = ges_layer_add_asset (layer, asset, 0, 0, 4 * GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  gst_object_unref (asset);
+
+  assert_equals_float (ges_timeline_get_preview_scale (timeline), 1.0);
+  check_track_output_size (trackv, 1280, 720);
+
+  /* The track outputs a smaller video, sizes are still expressed
+   * in full resolution */
+  ges_timeline_set_preview_scale (timeline, 0.5);
+  assert_equals_float (ges_timeline_get_preview_scale (timeline), 0.5);
+  check_track_output_size (trackv, 640, 360);
+  fail_unless (check_frame_positioner_size (clip, 1280, 720));
+
+  /* Changing the restriction caps keeps the scale */
+  caps = gst_caps_new_simple ("video/x-raw", "width", G_TYPE_INT, 1920,
+      "height", G_TYPE_INT, 1080, NULL);
+  ges_track_set_restriction_caps (trackv, caps);
+  gst_caps_unref (caps);
+  check_track_output_size (trackv, 960, 540);
+  fail_unless (check_frame_positioner_size (clip, 1920, 1080));
+
+  ges_timeline_set_preview_scale (timeline, 1.0);
+  check_track_output_size (trackv, 1920, 1080);
+  fail_unless (check_frame_positioner_size (clip, 1920, 1080));
+
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_preview_scale_proxies)
+{
+  gchar *data;
+  GFile *src, *dest;
+  GESProject *project;
+  GESPipeline *pipeline;
+  GESTimeline *timeline;
+  GESLayer *layer;
+  GESClip *clip, *proxy_clip, *added_clip, *removed_clip;
+  GESAsset *asset, *proxy;
+  gchar *uri = ges_test_file_uri ("audio_video.ogg");
+  gchar *proxy_uri = ges_test_get_tmp_uri ("audio_video_proxy.ogg");
+  gchar *project_uri = ges_test_get_tmp_uri ("preview-scale-proxies.xges");
+  gchar *asset_id = g_strdup_printf ("asset-id='%s'", uri);
+
+  src = g_file_new_for_uri (uri);
+  dest = g_file_new_for_uri (proxy_uri);
+  fail_unless (g_file_copy (src, dest, G_FILE_COPY_OVERWRITE, NULL, NULL,
+          NULL, NULL));
+  g_object_unref (src);
+  g_object_unref (dest);
+
+  asset = GES_ASSET (ges_uri_clip_asset_request_sync (uri, NULL));
+  proxy = GES_ASSET (ges_uri_clip_asset_request_sync (proxy_uri, NULL));
+  fail_unless (asset);
+  fail_unless (proxy);
+  fail_unless (ges_asset_set_proxy (asset, proxy));
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  clip = ges_layer_add_asset (layer, asset, 0, 0, GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  /* Already using a proxy, never switched to its proxy target */
+  proxy_clip = ges_layer_add_asset (layer, proxy, GST_SECOND, 0, GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  fail_unless (ges_extractable_get_asset (GES_EXTRACTABLE (clip)) == asset);
+  fail_unless (ges_extractable_get_asset (GES_EXTRACTABLE (proxy_clip)) ==
+      proxy);
+
+  ges_timeline_set_preview_scale (timeline, 0.5);
+  fail_unless (ges_extractable_get_asset (GES_EXTRACTABLE (clip)) == proxy);
+  fail_unless (ges_extractable_get_asset (GES_EXTRACTABLE (proxy_clip)) ==
+      proxy);
+
+  /* Still scaled, the clips are left as is */
+  ges_timeline_set_preview_scale (timeline, 0.25);
+  fail_unless (ges_extractable_get_asset (GES_EXTRACTABLE (clip)) == proxy);
+
+  /* Clips added meanwhile use the proxy too */
+  added_clip = ges_layer_add_asset (layer, asset, 2 * GST_SECOND, 0,
+      GST_SECOND, GES_TRACK_TYPE_UNKNOWN);
+  fail_unless (ges_extractable_get_asset (GES_EXTRACTABLE (added_clip)) ==
+      proxy);
+  assert_equals_int (g_list_length (GES_CONTAINER_CHILDREN (added_clip)), 2);
+
+  /* And the removed ones are forgotten */
+  removed_clip = ges_layer_add_asset (layer, asset, 3 * GST_SECOND, 0,
+      GST_SECOND, GES_TRACK_TYPE_UNKNOWN);
+  gst_object_ref (removed_clip);
+  fail_unless (ges_layer_remove_clip (layer, removed_clip));
+  ASSERT_OBJECT_REFCOUNT (removed_clip, "removed clip", 1);
+
+  /* The project is saved with the original asset */
+  project =
+      GES_PROJECT (ges_extractable_get_asset (GES_EXTRACTABLE (timeline)));
+  fail_unless (ges_project_save (project, timeline, project_uri, NULL, TRUE,
+          NULL));
+  src = g_file_new_for_uri (project_uri);
+  fail_unless (g_file_load_contents (src, NULL, &data, NULL, NULL, NULL));
+  fail_unless (strstr (data, asset_id), "%s not saved in %s", asset_id, data);
+  fail_if (strstr (data, "preview-scale"));
+  g_free (data);
+  g_object_unref (src);
+
+  /* Rendering is refused until the scale is reset */
+  pipeline = ges_pipeline_new ();
+  fail_unless (ges_pipeline_set_timeline (pipeline, gst_object_ref (timeline)));
+  fail_if (ges_pipeline_set_mode (pipeline, GES_PIPELINE_MODE_RENDER));
+  fail_if (ges_pipeline_set_mode (pipeline, GES_PIPELINE_MODE_SMART_RENDER));
+
+  ges_timeline_set_preview_scale (timeline, 1.0);
+  fail_unless (ges_extractable_get_asset (GES_EXTRACTABLE (clip)) == asset);
+  fail_unless (ges_extractable_get_asset (GES_EXTRACTABLE (proxy_clip)) ==
+      proxy);
+  fail_unless (ges_extractable_get_asset (GES_EXTRACTABLE (added_clip)) ==
+      asset);
+  fail_unless (ges_extractable_get_asset (GES_EXTRACTABLE (removed_clip)) ==
+      proxy);
+  gst_object_unref (removed_clip);
+
+  fail_unless (ges_asset_set_proxy (asset, NULL));
+  gst_object_unref (pipeline);
+  gst_object_unref (timeline);
+  gst_object_unref (asset);
+  gst_object_unref (proxy);
+  g_free (uri);
+  g_free (proxy_uri);
+  g_free (project_uri);
+  g_free (asset_id);
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -1515,7 +1914,12 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_simple_triming);
   tcase_add_test (tc_chain, test_groups);
   tcase_add_test (tc_chain, test_snapping_groups);
+  tcase_add_test (tc_chain, test_snapping_points);
+  tcase_add_test (tc_chain, test_repeated_ripples);
   tcase_add_test (tc_chain, test_scaling);
+  tcase_add_test (tc_chain, test_ripple_over_unmoved);
+  tcase_add_test (tc_chain, test_preview_scale);
+  tcase_add_test (tc_chain, test_preview_scale_proxies);
 
   return s;
 }
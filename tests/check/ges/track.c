@@ -18,6 +18,7 @@
  */
 
 #include "test-utils.h"
+#include "../../../ges/ges-internal.h"
 #include <ges/ges.h>
 #include <gst/check/gstcheck.h>
 
@@ -87,6 +88,138 @@ GST_START_TEST (test_update_restriction_caps)
 
 GST_END_TEST;
 
+/* The objects added to a composition are not children of it, the track
+ * keeps track of its gaps though */
+static guint
+count_gap_sources (GESTrack * track)
+{
+  GList *gaps = ges_track_get_gap_objects (track);
+  guint ngaps = g_list_length (gaps);
+
+  g_list_free (gaps);
+
+  return ngaps;
+}
+
+GST_START_TEST (test_shared_gap_filler)
+{
+  guint i;
+  gboolean expandable;
+  GESLayer *layer;
+  GESTrack *track;
+  GESTimeline *timeline;
+  GstElement *filler;
+
+  timeline = ges_timeline_new ();
+  track = GES_TRACK (ges_video_track_new ());
+  fail_unless (ges_timeline_add_track (timeline, track));
+  layer = ges_timeline_append_layer (timeline);
+  fail_if (ges_track_get_shared_gap_filler (track));
+
+  /* Three clips with a gap before each of them */
+  for (i = 0; i < 3; i++) {
+    GESClip *clip = GES_CLIP (ges_test_clip_new ());
+
+    g_object_set (clip, "start", (guint64) (i * 2 + 1) * GST_SECOND,
+        "duration", (guint64) GST_SECOND, NULL);
+    fail_unless (ges_layer_add_clip (layer, clip));
+  }
+  ges_timeline_commit (timeline);
+
+  /* 3 gaps between the clips and the one at the end */
+  assert_equals_int (count_gap_sources (track), 4);
+  fail_unless (ges_track_get_gap_filler_object (track) == NULL);
+
+  g_object_set (track, "shared-gap-filler", TRUE, NULL);
+  fail_unless (ges_track_get_shared_gap_filler (track));
+  ges_timeline_commit (timeline);
+
+  /* Only the gap at the end is needed to keep the composition duration */
+  assert_equals_int (count_gap_sources (track), 1);
+  filler = ges_track_get_gap_filler_object (track);
+  fail_unless (filler != NULL);
+  g_object_get (filler, "expandable", &expandable, NULL);
+  fail_unless (expandable);
+
+  ges_track_set_shared_gap_filler (track, FALSE);
+  ges_timeline_commit (timeline);
+  assert_equals_int (count_gap_sources (track), 4);
+  fail_unless (ges_track_get_gap_filler_object (track) == NULL);
+
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
+static void
+check_gaps_reused (GESTrack * track, GList * gaps, guint ngaps)
+{
+  GList *tmp, *current = ges_track_get_gap_objects (track);
+
+  assert_equals_int (g_list_length (current), ngaps);
+  for (tmp = current; tmp; tmp = tmp->next)
+    fail_unless (g_list_find (gaps, tmp->data),
+        "%" GST_PTR_FORMAT " is not one of the original gaps", tmp->data);
+
+  g_list_free (current);
+}
+
+GST_START_TEST (test_gap_reuse)
+{
+  guint ngaps;
+  GList *gaps;
+  GESLayer *layer;
+  GESTrack *track;
+  GESClip *clip, *clip1;
+  GESTimeline *timeline;
+
+  timeline = ges_timeline_new ();
+  track = GES_TRACK (ges_video_track_new ());
+  fail_unless (ges_timeline_add_track (timeline, track));
+  layer = ges_timeline_append_layer (timeline);
+
+  clip = GES_CLIP (ges_test_clip_new ());
+  g_object_set (clip, "start", (guint64) GST_SECOND, "duration",
+      (guint64) GST_SECOND, NULL);
+  fail_unless (ges_layer_add_clip (layer, clip));
+
+  clip1 = GES_CLIP (ges_test_clip_new ());
+  g_object_set (clip1, "start", (guint64) 3 * GST_SECOND, "duration",
+      (guint64) GST_SECOND, NULL);
+  fail_unless (ges_layer_add_clip (layer, clip1));
+  ges_timeline_commit (timeline);
+
+  /* Keep the original gaps alive so that their address can't be reused */
+  gaps = ges_track_get_gap_objects (track);
+  g_list_foreach (gaps, (GFunc) gst_object_ref, NULL);
+  ngaps = g_list_length (gaps);
+  fail_unless (ngaps >= 2);
+
+  /* The gap before the first clip is not needed anymore and gets recycled,
+   * the others move */
+  ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip), 0);
+  ges_timeline_commit (timeline);
+  check_gaps_reused (track, gaps, ngaps - 1);
+
+  /* The recycled gap fills the gap before the first clip again */
+  ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip), GST_SECOND);
+  ges_timeline_commit (timeline);
+  check_gaps_reused (track, gaps, ngaps);
+
+  /* Same with a clip moving across another one */
+  ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip1), 0);
+  ges_timeline_commit (timeline);
+  ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip1),
+      3 * GST_SECOND);
+  ges_timeline_commit (timeline);
+  check_gaps_reused (track, gaps, ngaps);
+
+  g_list_free_full (gaps, gst_object_unref);
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -101,6 +234,8 @@ ges_suite (void)
   suite_add_tcase (s, tc_chain);
 
   tcase_add_test (tc_chain, test_update_restriction_caps);
+  tcase_add_test (tc_chain, test_gap_reuse);
+  tcase_add_test (tc_chain, test_shared_gap_filler);
 
   return s;
 }
@@ -18,6 +18,8 @@
  */
 
 #include "test-utils.h"
+#include <string.h>
+#include <glib/gstdio.h>
 #include <ges/ges.h>
 #include <gst/check/gstcheck.h>
 
@@ -259,6 +261,201 @@ GST_START_TEST (test_filesource_images)
 
 GST_END_TEST;
 
+GST_START_TEST (test_filesource_lazy_elements)
+{
+  GESClip *clip;
+  GESTrack *track;
+  AssetUri asset_uri;
+  GESTimeline *timeline;
+  GESLayer *layer;
+  GESClip *clip2;
+  guint i, n_specs;
+  GParamSpec **specs;
+  GstElement *nleobject, *nleobject2;
+  GESTrackElement *trackelement;
+  gdouble volume;
+
+  track = ges_track_new (GES_TRACK_TYPE_AUDIO, gst_caps_ref (GST_CAPS_ANY));
+  ges_track_set_lazy_elements_window (track, 0);
+  assert_equals_uint64 (ges_track_get_lazy_elements_window (track), 0);
+  fail_unless (ges_track_get_release_lazy_elements (track));
+  ges_track_set_release_lazy_elements (track, FALSE);
+  fail_if (ges_track_get_release_lazy_elements (track));
+  ges_track_set_release_lazy_elements (track, TRUE);
+
+  layer = ges_layer_new ();
+  timeline = ges_timeline_new ();
+  fail_unless (ges_timeline_add_layer (timeline, layer));
+  fail_unless (ges_timeline_add_track (timeline, track));
+
+  mainloop = g_main_loop_new (NULL, FALSE);
+  asset_uri.uri = av_uri;
+  g_timeout_add (1, (GSourceFunc) create_asset, &asset_uri);
+  g_main_loop_run (mainloop);
+
+  clip = ges_layer_add_asset (layer, asset_uri.asset, 0, 0, GST_SECOND,
+      GES_TRACK_TYPE_AUDIO);
+  ges_timeline_commit (timeline);
+  assert_equals_int (g_list_length (GES_CONTAINER_CHILDREN (clip)), 1);
+  trackelement = GES_CONTAINER_CHILDREN (clip)->data;
+
+  /* The first element of a class gets created right away so that the
+   * children properties of the others are known, need-element only has
+   * the creation handled from the main context */
+  nleobject = ges_track_element_get_nleobject (trackelement);
+  g_signal_emit_by_name (nleobject, "need-element");
+  while (g_main_context_iteration (NULL, FALSE));
+  assert_equals_int (GST_BIN_NUMCHILDREN (nleobject), 1);
+
+  ges_timeline_element_set_child_properties (GES_TIMELINE_ELEMENT
+      (trackelement), "volume", 0.5, NULL);
+
+  /* Released elements get their children properties back, the element is
+   * detached right away and its children properties saved from the main
+   * context */
+  g_signal_emit_by_name (nleobject, "release-element");
+  assert_equals_int (GST_BIN_NUMCHILDREN (nleobject), 0);
+  while (g_main_context_iteration (NULL, FALSE));
+  fail_if (ges_track_element_get_element (trackelement));
+
+  /* Children properties are available without creating the element */
+  specs = ges_timeline_element_list_children_properties (GES_TIMELINE_ELEMENT
+      (trackelement), &n_specs);
+  fail_unless (n_specs > 0);
+  for (i = 0; i < n_specs; i++)
+    g_param_spec_unref (specs[i]);
+  g_free (specs);
+
+  ges_timeline_element_get_child_properties (GES_TIMELINE_ELEMENT
+      (trackelement), "volume", &volume, NULL);
+  assert_equals_float (volume, 0.5);
+  ges_timeline_element_set_child_properties (GES_TIMELINE_ELEMENT
+      (trackelement), "volume", 0.2, NULL);
+  ges_timeline_element_get_child_properties (GES_TIMELINE_ELEMENT
+      (trackelement), "volume", &volume, NULL);
+  assert_equals_float (volume, 0.2);
+  assert_equals_int (GST_BIN_NUMCHILDREN (nleobject), 0);
+
+  /* The other elements of the class are only created when needed */
+  clip2 = ges_layer_add_asset (layer, asset_uri.asset, GST_SECOND, 0,
+      GST_SECOND, GES_TRACK_TYPE_AUDIO);
+  nleobject2 = ges_track_element_get_nleobject (GES_CONTAINER_CHILDREN
+      (clip2)->data);
+  ges_timeline_element_get_child_properties (GES_TIMELINE_ELEMENT (clip2),
+      "volume", &volume, NULL);
+  assert_equals_float (volume, 1.0);
+  assert_equals_int (GST_BIN_NUMCHILDREN (nleobject2), 0);
+
+  /* The values set meanwhile are applied to the new element */
+  g_signal_emit_by_name (nleobject, "need-element");
+  assert_equals_int (GST_BIN_NUMCHILDREN (nleobject), 0);
+  while (g_main_context_iteration (NULL, FALSE));
+  assert_equals_int (GST_BIN_NUMCHILDREN (nleobject), 1);
+  fail_unless (ges_track_element_get_element (trackelement));
+  ges_timeline_element_get_child_properties (GES_TIMELINE_ELEMENT
+      (trackelement), "volume", &volume, NULL);
+  assert_equals_float (volume, 0.2);
+
+  gst_object_unref (asset_uri.asset);
+  gst_object_unref (timeline);
+  g_main_loop_unref (mainloop);
+}
+
+GST_END_TEST;
+
+static gboolean
+bin_has_decoder (GstBin * bin)
+{
+  GValue item = G_VALUE_INIT;
+  gboolean found = FALSE;
+  GstIterator *it = gst_bin_iterate_recurse (bin);
+
+  while (!found && gst_iterator_next (it, &item) == GST_ITERATOR_OK) {
+    GstElementFactory *factory =
+        gst_element_get_factory (g_value_get_object (&item));
+
+    if (factory && strstr (gst_element_factory_get_metadata (factory,
+                GST_ELEMENT_METADATA_KLASS), "Codec/Decoder"))
+      found = TRUE;
+    g_value_reset (&item);
+  }
+  g_value_unset (&item);
+  gst_iterator_free (it);
+
+  return found;
+}
+
+GST_START_TEST (test_filesource_smart_render)
+{
+  GstBus *bus;
+  GstCaps *caps;
+  GESAsset *asset;
+  GESLayer *layer;
+  GESTrack *track;
+  GstMessage *msg;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+  GstEncodingContainerProfile *profile;
+  gchar *location, *uri = ges_test_get_audio_only_uri (),
+      *output_uri = ges_test_get_tmp_uri ("smart-render.ogg");
+
+  timeline = ges_timeline_new ();
+  track = GES_TRACK (ges_audio_track_new ());
+  /* The mixer only handles raw data */
+  ges_track_set_mixing (track, FALSE);
+  fail_unless (ges_timeline_add_track (timeline, track));
+  layer = ges_timeline_append_layer (timeline);
+
+  asset = GES_ASSET (ges_uri_clip_asset_request_sync (uri, NULL));
+  fail_unless (asset != NULL);
+  fail_unless (ges_layer_add_asset (layer, asset, 0, 0, GST_SECOND,
+          GES_TRACK_TYPE_AUDIO));
+  gst_object_unref (asset);
+
+  caps = gst_caps_from_string ("application/ogg");
+  profile = gst_encoding_container_profile_new ("ogg", NULL, caps, NULL);
+  gst_caps_unref (caps);
+  caps = gst_caps_from_string ("audio/x-vorbis");
+  gst_encoding_container_profile_add_profile (profile,
+      (GstEncodingProfile *) gst_encoding_audio_profile_new (caps, NULL, NULL,
+          0));
+  gst_caps_unref (caps);
+
+  pipeline = ges_test_create_pipeline (timeline);
+  fail_unless (ges_pipeline_set_render_settings (pipeline, output_uri,
+          GST_ENCODING_PROFILE (profile)));
+  fail_unless (ges_pipeline_set_mode (pipeline,
+          GES_PIPELINE_MODE_SMART_RENDER));
+  ges_timeline_commit (timeline);
+
+  bus = gst_element_get_bus (GST_ELEMENT (pipeline));
+  ASSERT_SET_STATE (GST_ELEMENT (pipeline), GST_STATE_PLAYING,
+      GST_STATE_CHANGE_ASYNC);
+  msg = gst_bus_timed_pop_filtered (bus, 10 * GST_SECOND,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (msg != NULL);
+  if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR)
+    fail_error_message (msg);
+  gst_message_unref (msg);
+
+  /* The untouched clip got rendered without being decoded */
+  fail_if (bin_has_decoder (GST_BIN (timeline)));
+
+  ASSERT_SET_STATE (GST_ELEMENT (pipeline), GST_STATE_NULL,
+      GST_STATE_CHANGE_SUCCESS);
+
+  location = gst_uri_get_location (output_uri);
+  fail_unless (g_file_test (location, G_FILE_TEST_EXISTS));
+  g_unlink (location);
+
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+  g_free (location);
+  g_free (output_uri);
+  g_free (uri);
+}
+
+GST_END_TEST;
 
 static Suite *
 ges_suite (void)
@@ -271,6 +468,8 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_filesource_basic);
   tcase_add_test (tc_chain, test_filesource_images);
   tcase_add_test (tc_chain, test_filesource_properties);
+  tcase_add_test (tc_chain, test_filesource_lazy_elements);
+  tcase_add_test (tc_chain, test_filesource_smart_render);
 
   return s;
 }
@@ -431,6 +431,128 @@ GST_START_TEST (test_simple_audiomixer)
 
 GST_END_TEST;
 
+typedef struct
+{
+  gint stream_starts;
+  GstClockTime last_pts;
+  GstClockTime last_stop;
+} RelinkCheckData;
+
+static GstPadProbeReturn
+on_kept_source_event_cb (GstPad * pad, GstPadProbeInfo * info,
+    RelinkCheckData * data)
+{
+  if (GST_EVENT_TYPE (info->data) == GST_EVENT_STREAM_START)
+    g_atomic_int_inc (&data->stream_starts);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static GstPadProbeReturn
+on_sink_buffer_cb (GstPad * pad, GstPadProbeInfo * info,
+    RelinkCheckData * data)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+
+  fail_unless (GST_BUFFER_PTS_IS_VALID (buffer));
+  if (GST_CLOCK_TIME_IS_VALID (data->last_pts))
+    fail_unless (GST_BUFFER_PTS (buffer) >= data->last_pts,
+        "Timestamp went back from %" GST_TIME_FORMAT " to %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (data->last_pts), GST_TIME_ARGS (GST_BUFFER_PTS (buffer)));
+
+  data->last_pts = GST_BUFFER_PTS (buffer);
+  data->last_stop = data->last_pts + GST_BUFFER_DURATION (buffer);
+
+  return GST_PAD_PROBE_OK;
+}
+
+GST_START_TEST (test_incremental_relink)
+{
+  GstBus *bus;
+  GstPad *pad;
+  GstMessage *message;
+  GstElement *pipeline;
+  GstElement *nle_audiomixer;
+  GstElement *composition;
+  GstElement *audiomixer, *fakesink;
+  GstElement *nlesource1, *nlesource2;
+  GstElement *audiotestsrc1, *audiotestsrc2;
+  RelinkCheckData data = { 0, GST_CLOCK_TIME_NONE, GST_CLOCK_TIME_NONE };
+
+  gboolean ret;
+  GstClockTime total_time = 10 * GST_SECOND;
+
+  pipeline = GST_ELEMENT (gst_pipeline_new (NULL));
+  bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+
+  composition = gst_element_factory_make ("nlecomposition", "composition");
+  g_object_set (composition, "incremental-relink", TRUE, NULL);
+  gst_element_set_state (composition, GST_STATE_READY);
+  fakesink = gst_element_factory_make ("fakesink", NULL);
+
+  /* The mixer has different inputs before and after 5s, but nlesource2 is
+   * a subtree of both stacks, it should thus keep running when switching */
+  nle_audiomixer = gst_element_factory_make ("nleoperation", "nle_audiomixer");
+  audiomixer = gst_element_factory_make ("audiomixer", "audiomixer");
+  fail_unless (audiomixer != NULL);
+  gst_bin_add (GST_BIN (nle_audiomixer), audiomixer);
+  g_object_set (nle_audiomixer, "start", (guint64) 0 * GST_SECOND,
+      "duration", total_time, "inpoint", (guint64) 0 * GST_SECOND,
+      "priority", 0, NULL);
+  nle_composition_add (GST_BIN (composition), nle_audiomixer);
+
+  nlesource1 = gst_element_factory_make ("nlesource", "nlesource1");
+  audiotestsrc1 = gst_element_factory_make ("audiotestsrc", "audiotestsrc1");
+  gst_bin_add (GST_BIN (nlesource1), audiotestsrc1);
+  g_object_set (nlesource1, "start", (guint64) 0 * GST_SECOND,
+      "duration", total_time / 2, "inpoint", (guint64) 0, "priority", 1, NULL);
+  fail_unless (nle_composition_add (GST_BIN (composition), nlesource1));
+
+  nlesource2 = gst_element_factory_make ("nlesource", "nlesource2");
+  audiotestsrc2 = gst_element_factory_make ("audiotestsrc", "audiotestsrc2");
+  gst_bin_add (GST_BIN (nlesource2), GST_ELEMENT (audiotestsrc2));
+  g_object_set (nlesource2, "start", (guint64) 0 * GST_SECOND,
+      "duration", total_time, "inpoint", (guint64) 0 * GST_SECOND, "priority",
+      2, NULL);
+  fail_unless (nle_composition_add (GST_BIN (composition), nlesource2));
+
+  /* A source that gets prepared again is reactivated and starts a new
+   * stream */
+  pad = gst_element_get_static_pad (audiotestsrc2, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM,
+      (GstPadProbeCallback) on_kept_source_event_cb, &data, NULL);
+  gst_object_unref (pad);
+
+  pad = gst_element_get_static_pad (fakesink, "sink");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+      (GstPadProbeCallback) on_sink_buffer_cb, &data, NULL);
+  gst_object_unref (pad);
+
+  gst_bin_add_many (GST_BIN (pipeline), composition, fakesink, NULL);
+  fail_unless (gst_element_link (composition, fakesink) == TRUE);
+
+  commit_and_wait (composition, &ret);
+  fail_unless (ret);
+  fail_if (gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PLAYING)
+      == GST_STATE_CHANGE_FAILURE);
+
+  message = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+    fail_error_message (message);
+  gst_message_unref (message);
+
+  assert_equals_int (g_atomic_int_get (&data.stream_starts), 1);
+  fail_unless (data.last_stop >= total_time - GST_SECOND / 10,
+      "Output stopped at %" GST_TIME_FORMAT, GST_TIME_ARGS (data.last_stop));
+
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
 static Suite *
 gnonlin_suite (void)
 {
@@ -453,8 +575,9 @@ gnonlin_suite (void)
   if (gst_registry_check_feature_version (gst_registry_get (), "audiomixer", 1,
           0, 0)) {
     tcase_add_test (tc_chain, test_simple_audiomixer);
+    tcase_add_test (tc_chain, test_incremental_relink);
   } else {
-    GST_WARNING ("audiomixer element not available, skipping 1 test");
+    GST_WARNING ("audiomixer element not available, skipping 2 tests");
   }
 
   return s;
@@ -188,23 +188,46 @@ test_time_duration_full (void)
 }
 
 static void
-test_one_after_other_full (void)
+_prefetched_cb (GstBin * prefetch_bin, GstElement * element,
+    GstElement * source2)
+{
+  gint *prefetched = g_object_get_data (G_OBJECT (source2), "prefetched");
+
+  if (element == source2)
+    g_atomic_int_inc (prefetched);
+}
+
+static GstPadProbeReturn
+_count_stream_starts_cb (GstPad * pad, GstPadProbeInfo * info,
+    gint * stream_starts)
+{
+  if (GST_EVENT_TYPE (GST_PAD_PROBE_INFO_EVENT (info)) ==
+      GST_EVENT_STREAM_START)
+    g_atomic_int_inc (stream_starts);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+test_one_after_other_full (guint prefetch_depth)
 {
   GstElement *pipeline;
-  GstElement *comp, *sink, *source1, *source2;
+  GstElement *comp, *sink, *source1, *source2, *prefetch_bin;
   CollectStructure *collect;
   GstBus *bus;
   GstMessage *message;
   gboolean carry_on = TRUE;
-  GstPad *sinkpad;
+  GstPad *sinkpad, *srcpad;
+  gint prefetched = 0, stream_starts = 0;
 
   gboolean ret = FALSE;
 
   pipeline = gst_pipeline_new ("test_pipeline");
   comp =
       gst_element_factory_make_or_warn ("nlecomposition", "test_composition");
-  gst_element_set_state (comp, GST_STATE_READY);
   fail_if (comp == NULL);
+  g_object_set (comp, "prefetch-depth", prefetch_depth, NULL);
+  gst_element_set_state (comp, GST_STATE_READY);
 
   /*
      Source 1
@@ -232,6 +255,21 @@ test_one_after_other_full (void)
   check_start_stop_duration (source2, 1 * GST_SECOND, 2 * GST_SECOND,
       1 * GST_SECOND);
 
+  /* Count how many times source2 gets prefetched, and prepared: a prepared
+   * source gets activated and starts a new stream */
+  prefetch_bin = gst_bin_get_by_name (GST_BIN (comp), "prefetch-bin");
+  fail_unless (prefetch_bin != NULL);
+  g_object_set_data (G_OBJECT (source2), "prefetched", &prefetched);
+  g_signal_connect (prefetch_bin, "element-added",
+      G_CALLBACK (_prefetched_cb), source2);
+  gst_object_unref (prefetch_bin);
+
+  srcpad = gst_element_get_static_pad (GST_BIN_CHILDREN (source2)->data,
+      "src");
+  gst_pad_add_probe (srcpad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM,
+      (GstPadProbeCallback) _count_stream_starts_cb, &stream_starts, NULL);
+  gst_object_unref (srcpad);
+
   /* Add one source */
   nle_composition_add (GST_BIN (comp), source1);
   commit_and_wait (comp, &ret);
@@ -315,6 +353,11 @@ test_one_after_other_full (void)
 
   fail_if (collect->expected_segments != NULL);
 
+  /* source2 was prepared in prefetch-bin while source1 was playing, and then
+   * used as is when switching to its stack */
+  assert_equals_int (prefetched, prefetch_depth ? 1 : 0);
+  assert_equals_int (stream_starts, 1);
+
   GST_DEBUG ("Resetted pipeline to READY");
 
   /* Expected segments */
@@ -377,7 +420,7 @@ test_one_after_other_full (void)
 }
 
 static void
-test_one_under_another_full (void)
+test_one_under_another_full (gboolean stack_plan)
 {
   gboolean ret = FALSE;
   GstElement *pipeline;
@@ -391,8 +434,9 @@ test_one_under_another_full (void)
   pipeline = gst_pipeline_new ("test_pipeline");
   comp =
       gst_element_factory_make_or_warn ("nlecomposition", "test_composition");
-  gst_element_set_state (comp, GST_STATE_READY);
   fail_if (comp == NULL);
+  g_object_set (comp, "stack-plan", stack_plan, NULL);
+  gst_element_set_state (comp, GST_STATE_READY);
 
   /* TOPOLOGY
    *
@@ -738,14 +782,28 @@ GST_END_TEST;
 
 GST_START_TEST (test_one_after_other)
 {
-  test_one_after_other_full ();
+  test_one_after_other_full (0);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_one_after_other_prefetch)
+{
+  test_one_after_other_full (1);
 }
 
 GST_END_TEST;
 
 GST_START_TEST (test_one_under_another)
 {
-  test_one_under_another_full ();
+  test_one_under_another_full (FALSE);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_one_under_another_stack_plan)
+{
+  test_one_under_another_full (TRUE);
 }
 
 GST_END_TEST;
@@ -774,7 +832,9 @@ gnonlin_suite (void)
   tcase_add_test (tc_chain, test_time_duration);
   tcase_add_test (tc_chain, test_simplest);
   tcase_add_test (tc_chain, test_one_after_other);
+  tcase_add_test (tc_chain, test_one_after_other_prefetch);
   tcase_add_test (tc_chain, test_one_under_another);
+  tcase_add_test (tc_chain, test_one_under_another_stack_plan);
   tcase_add_test (tc_chain, test_one_bin_after_other);
   return s;
 }
@@ -241,6 +241,17 @@ class GESRenderTest(GESTest, GstValidateEncodingTestInterface):
         return size
 
 
+class GESRenderSegmentsTest(GESRenderTest):
+    def __init__(self, classname, options, reporter, project, combination,
+                 n_segments):
+        super().__init__(classname, options, reporter, project, combination)
+        self.n_segments = n_segments
+
+    def build_arguments(self):
+        super().build_arguments()
+        self.add_arguments("--render-segments", str(self.n_segments))
+
+
 class GESTestsManager(TestsManager):
     name = "ges"
 
@@ -366,6 +377,16 @@ Available options:""")
                                             self.reporter, project,
                                             combination=comb)
                                   )
+
+            # Rendering in segments concatenated back together
+            for comb in GES_ENCODING_TARGET_COMBINATIONS[:2]:
+                classname = "render_segments.%s.%s" % (str(comb).replace(' ', '_'),
+                                                  os.path.splitext(os.path.basename(proj_uri))[0])
+                self.add_test(GESRenderSegmentsTest(classname, self.options,
+                                                    self.reporter, project,
+                                                    combination=comb,
+                                                    n_segments=2)
+                                  )
         if all_scenarios:
             for scenario in self._scenarios.discover_scenarios(all_scenarios):
                 classname = "scenario.%s" % scenario.name
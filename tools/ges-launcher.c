@@ -29,6 +29,7 @@
 #include <glib-unix.h>
 #endif
 #include "ges-launcher.h"
+#include "ges-render-segments.h"
 #include "ges-validate.h"
 #include "utils.h"
 
@@ -45,6 +46,7 @@ typedef struct
   gchar *scenario;
   gchar *format;
   gchar *outputuri;
+  gint render_segments;
   gchar *encoding_profile;
   gchar *videosink;
   gchar *audiosink;
@@ -58,6 +60,8 @@ struct _GESLauncherPrivate
   GESTimeline *timeline;
   GESPipeline *pipeline;
   gboolean seenerrors;
+  GstEncodingProfile *segments_profile;
+  gboolean rendering_segments;
 #ifdef G_OS_UNIX
   guint signal_watch_id;
 #endif
@@ -142,6 +146,39 @@ retry:
   return TRUE;
 }
 
+static void
+_render_segments_done_cb (gboolean success, GESLauncher * self)
+{
+  if (!success)
+    self->priv->seenerrors = TRUE;
+  else
+    g_printerr ("\nDone\n");
+
+  g_application_quit (G_APPLICATION (self));
+}
+
+static gboolean
+_start_playing (GESLauncher * self)
+{
+  ParsedOptions *opts = &self->priv->parsed_options;
+
+  if (self->priv->segments_profile) {
+    /* The timeline is rendered by pipelines of its own */
+    if (self->priv->rendering_segments)
+      return TRUE;
+
+    self->priv->rendering_segments = TRUE;
+    return ges_render_segments (self->priv->timeline,
+        self->priv->segments_profile, opts->outputuri,
+        opts->render_segments > 0 ? opts->render_segments :
+        g_get_num_processors (),
+        (GESRenderSegmentsDoneFunc) _render_segments_done_cb, self);
+  }
+
+  return gst_element_set_state (GST_ELEMENT (self->priv->pipeline),
+      GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE;
+}
+
 static void
 _project_loaded_cb (GESProject * project, GESTimeline * timeline,
     GESLauncher * self)
@@ -189,8 +226,7 @@ _project_loaded_cb (GESProject * project, GESTimeline * timeline,
   g_free (project_uri);
 
   if (!self->priv->seenerrors && opts->needs_set_state &&
-      gst_element_set_state (GST_ELEMENT (self->priv->pipeline),
-          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+      !_start_playing (self)) {
     g_error ("Failed to start the pipeline\n");
   }
 }
@@ -400,9 +436,7 @@ _run_pipeline (GESLauncher * self)
   g_signal_connect (bus, "message", G_CALLBACK (bus_message_cb), self);
 
   if (!opts->load_path) {
-    if (opts->needs_set_state
-        && gst_element_set_state (GST_ELEMENT (self->priv->pipeline),
-            GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+    if (opts->needs_set_state && !_start_playing (self)) {
       g_error ("Failed to start the pipeline\n");
       return FALSE;
     }
@@ -457,6 +491,14 @@ _set_rendering_details (GESLauncher * self)
       return FALSE;
     }
 
+    if (opts->outputuri && opts->render_segments != 1) {
+      if (opts->scenario)
+        g_printerr ("Can not render in segments when running a scenario, "
+            "rendering in one go\n");
+      else
+        self->priv->segments_profile = gst_encoding_profile_ref (prof);
+    }
+
     gst_encoding_profile_unref (prof);
   } else {
     ges_pipeline_set_mode (self->priv->pipeline, GES_PIPELINE_MODE_PREVIEW);
@@ -622,6 +664,13 @@ ges_launcher_get_rendering_option_group (GESLauncher * self)
           "See ges-launch-1.0 help profile for more information. "
           "This will have no effect if no outputuri has been specified.",
         "<profile-name>"},
+    {"render-segments", 0, 0, G_OPTION_ARG_INT, &opts->render_segments,
+          "Split the timeline in that number of segments, rendered in "
+          "parallel before being concatenated. 0 renders as many segments "
+          "as there are processors. The audio is rendered in one go "
+          "alongside the video segments when the profile has both. "
+          "This will have no effect if no outputuri has been specified.",
+        "<n-segments>"},
     {NULL}
   };
 
@@ -815,6 +864,8 @@ _shutdown (GApplication * application)
 #endif
 
   g_free (opts->sanitized_timeline);
+  if (self->priv->segments_profile)
+    gst_encoding_profile_unref (self->priv->segments_profile);
 
   G_APPLICATION_CLASS (ges_launcher_parent_class)->shutdown (application);
 }
@@ -835,6 +886,7 @@ ges_launcher_init (GESLauncher * self)
       GES_TYPE_LAUNCHER, GESLauncherPrivate);
   self->priv->parsed_options.track_types =
       GES_TRACK_TYPE_AUDIO | GES_TRACK_TYPE_VIDEO;
+  self->priv->parsed_options.render_segments = 1;
 }
 
 gint
@@ -0,0 +1,728 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Renders a timeline in segments, each of them in its own GESPipeline
+ * working on a copy of the timeline, loaded back from a project file. As
+ * every pipeline streams in its own threads, as many segments as there are
+ * processors are rendered at once, the pipelines being driven from the main
+ * loop as GES objects have to be.
+ *
+ * The timeline copy of each segment only keeps what it renders, moved to
+ * the start of the timeline, so that its pipeline does not encode anything
+ * out of the segment, while prerolling for example.
+ *
+ * Each segment being encoded on its own, it starts with a keyframe and the
+ * segments are finally concatenated in a timeline of their own, which is
+ * smart rendered so their streams are only remuxed.
+ *
+ * Audio encoders usually prepend some priming samples to the streams they
+ * encode, and most containers do not tell how many, so concatenating audio
+ * segments would leave a gap of a few milliseconds at every boundary.
+ * When the profile has both audio and video streams, only the video is
+ * rendered in segments, the audio being rendered in one go alongside them
+ * and muxed back with the concatenated video. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <glib/gstdio.h>
+#include "ges-render-segments.h"
+
+typedef struct _SegmentedRender SegmentedRender;
+
+typedef struct
+{
+  SegmentedRender *render;
+  guint index;
+  GstClockTime start;
+  GstClockTime stop;
+  gchar *filename;
+  gchar *uri;
+
+  /* The type of the tracks not rendered in that segment, and the profile
+   * the other ones are rendered with */
+  GESTrackType skipped_tracks;
+  GstEncodingProfile *profile;
+
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+  guint bus_watch_id;
+} Segment;
+
+struct _SegmentedRender
+{
+  GESTimeline *timeline;
+  GstEncodingProfile *profile;
+  gchar *outputuri;
+
+  gchar *tmpdir;
+  gchar *project_filename;
+  GESProject *project;
+
+  /* The video, or audio and video, segments, followed by the audio of the
+   * whole timeline when rendered on its own */
+  Segment *segments;
+  guint n_segments;
+  Segment *audio;
+  guint n_jobs;
+  guint next_segment;
+  guint n_running;
+  guint n_done;
+  guint max_running;
+
+  GESPipeline *concat_pipeline;
+  guint concat_bus_watch_id;
+
+  GESRenderSegmentsDoneFunc done;
+  gpointer user_data;
+};
+
+static void
+_stop_pipeline (GESPipeline ** pipeline, guint * bus_watch_id)
+{
+  if (*bus_watch_id) {
+    g_source_remove (*bus_watch_id);
+    *bus_watch_id = 0;
+  }
+
+  if (*pipeline) {
+    gst_element_set_state (GST_ELEMENT (*pipeline), GST_STATE_NULL);
+    gst_object_unref (*pipeline);
+    *pipeline = NULL;
+  }
+}
+
+static void
+_segment_stop (Segment * segment)
+{
+  _stop_pipeline (&segment->pipeline, &segment->bus_watch_id);
+  if (segment->timeline) {
+    gst_object_unref (segment->timeline);
+    segment->timeline = NULL;
+  }
+}
+
+static void
+_finish (SegmentedRender * render, gboolean success)
+{
+  guint i;
+
+  _stop_pipeline (&render->concat_pipeline, &render->concat_bus_watch_id);
+  g_signal_handlers_disconnect_by_data (render->project, render);
+
+  for (i = 0; i < render->n_jobs; i++) {
+    Segment *segment = &render->segments[i];
+
+    _segment_stop (segment);
+    g_unlink (segment->filename);
+    g_free (segment->filename);
+    g_free (segment->uri);
+    gst_encoding_profile_unref (segment->profile);
+  }
+  g_unlink (render->project_filename);
+  g_rmdir (render->tmpdir);
+
+  render->done (success, render->user_data);
+
+  gst_object_unref (render->project);
+  gst_object_unref (render->timeline);
+  gst_encoding_profile_unref (render->profile);
+  g_free (render->outputuri);
+  g_free (render->tmpdir);
+  g_free (render->project_filename);
+  g_free (render->segments);
+  g_free (render);
+}
+
+static void
+_print_error_message (GstMessage * message)
+{
+  GError *err = NULL;
+  gchar *dbg_info = NULL;
+
+  gst_message_parse_error (message, &err, &dbg_info);
+  g_printerr ("ERROR from element %s: %s\n", GST_OBJECT_NAME (message->src),
+      err->message);
+  g_printerr ("Debugging info: %s\n", (dbg_info) ? dbg_info : "none");
+  g_clear_error (&err);
+  g_free (dbg_info);
+}
+
+static gboolean
+_concat_bus_cb (GstBus * bus, GstMessage * message, SegmentedRender * render)
+{
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_ERROR:
+      _print_error_message (message);
+      _finish (render, FALSE);
+      break;
+    case GST_MESSAGE_EOS:
+      _finish (render, TRUE);
+      break;
+    default:
+      break;
+  }
+
+  return TRUE;
+}
+
+/* The segments are temporary files, not worth keeping in the discovery
+ * cache of the user */
+static GESUriClipAsset *
+_request_segment_asset (Segment * segment, GError ** error)
+{
+  GESUriClipAsset *asset;
+  gchar *cache_dir = g_strdup (g_getenv ("GES_DISCOVERY_CACHE_DIR"));
+
+  g_setenv ("GES_DISCOVERY_CACHE_DIR", "", TRUE);
+  asset = ges_uri_clip_asset_request_sync (segment->uri, error);
+  if (cache_dir)
+    g_setenv ("GES_DISCOVERY_CACHE_DIR", cache_dir, TRUE);
+  else
+    g_unsetenv ("GES_DISCOVERY_CACHE_DIR");
+  g_free (cache_dir);
+
+  return asset;
+}
+
+static gboolean
+_add_segment_clip (GESLayer * layer, Segment * segment)
+{
+  GError *error = NULL;
+  GESUriClipAsset *asset = _request_segment_asset (segment, &error);
+
+  if (!asset) {
+    g_printerr ("Could not load rendered segment %s: %s\n", segment->uri,
+        error->message);
+    g_clear_error (&error);
+
+    return FALSE;
+  }
+
+  ges_layer_add_asset (layer, GES_ASSET (asset), segment->start, 0,
+      segment->stop - segment->start, GES_TRACK_TYPE_UNKNOWN);
+  gst_object_unref (asset);
+
+  return TRUE;
+}
+
+static gboolean
+_concat_segments (SegmentedRender * render)
+{
+  guint i;
+  GstBus *bus;
+  GList *tmp, *tracks;
+  GESLayer *layer;
+  GESTimeline *timeline = ges_timeline_new ();
+
+  g_print ("Concatenating %u segments\n", render->n_segments);
+
+  tracks = ges_timeline_get_tracks (render->timeline);
+  for (tmp = tracks; tmp; tmp = tmp->next) {
+    GESTrack *track;
+    GstCaps *restriction_caps = NULL;
+
+    if (GES_IS_VIDEO_TRACK (tmp->data))
+      track = GES_TRACK (ges_video_track_new ());
+    else if (GES_IS_AUDIO_TRACK (tmp->data))
+      track = GES_TRACK (ges_audio_track_new ());
+    else
+      continue;
+
+    g_object_get (tmp->data, "restriction-caps", &restriction_caps, NULL);
+    if (restriction_caps) {
+      ges_track_set_restriction_caps (track, restriction_caps);
+      gst_caps_unref (restriction_caps);
+    }
+
+    /* Segments are back to back, mixing them would only force decoding */
+    ges_track_set_mixing (track, FALSE);
+    ges_timeline_add_track (timeline, track);
+  }
+  g_list_free_full (tracks, gst_object_unref);
+
+  layer = ges_timeline_append_layer (timeline);
+  for (i = 0; i < render->n_segments; i++) {
+    if (!_add_segment_clip (layer, &render->segments[i])) {
+      gst_object_unref (timeline);
+
+      return FALSE;
+    }
+  }
+
+  /* The audio rendered in one go, in parallel to the video segments */
+  if (render->audio &&
+      !_add_segment_clip (ges_timeline_append_layer (timeline),
+          render->audio)) {
+    gst_object_unref (timeline);
+
+    return FALSE;
+  }
+  ges_timeline_commit (timeline);
+
+  render->concat_pipeline = ges_pipeline_new ();
+  if (!ges_pipeline_set_timeline (render->concat_pipeline, timeline) ||
+      !ges_pipeline_set_render_settings (render->concat_pipeline,
+          render->outputuri, render->profile) ||
+      !ges_pipeline_set_mode (render->concat_pipeline,
+          GES_PIPELINE_MODE_SMART_RENDER)) {
+    g_printerr ("Could not set up the concatenation pipeline\n");
+
+    return FALSE;
+  }
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (render->concat_pipeline));
+  render->concat_bus_watch_id =
+      gst_bus_add_watch (bus, (GstBusFunc) _concat_bus_cb, render);
+  gst_object_unref (bus);
+
+  return gst_element_set_state (GST_ELEMENT (render->concat_pipeline),
+      GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE;
+}
+
+static gboolean _start_segments (SegmentedRender * render);
+
+/* The jobs in the order they are started, the audio of the whole timeline
+ * taking the longest to render it goes first */
+static Segment *
+_get_job (SegmentedRender * render, guint i)
+{
+  if (!render->audio)
+    return &render->segments[i];
+
+  return i == 0 ? render->audio : &render->segments[i - 1];
+}
+
+static gboolean
+_segment_bus_cb (GstBus * bus, GstMessage * message, Segment * segment)
+{
+  SegmentedRender *render = segment->render;
+
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_ERROR:
+      _print_error_message (message);
+      _finish (render, FALSE);
+      break;
+    case GST_MESSAGE_EOS:
+      if (segment == render->audio)
+        g_print ("Audio rendered\n");
+      else
+        g_print ("Segment %u/%u rendered\n", segment->index + 1,
+            render->n_segments);
+
+      _segment_stop (segment);
+      render->n_running--;
+      render->n_done++;
+
+      if (render->n_done == render->n_jobs) {
+        if (!_concat_segments (render))
+          _finish (render, FALSE);
+      } else {
+        _start_segments (render);
+      }
+      break;
+    default:
+      break;
+  }
+
+  return TRUE;
+}
+
+/* Only keeps what @segment renders in its timeline, moving it to the
+ * start of the timeline */
+static void
+_restrict_timeline_to_segment (Segment * segment)
+{
+  GList *tmp, *groups, *layers, *ltmp, *clips, *tracks;
+  GESTimeline *timeline = segment->timeline;
+
+  tracks = ges_timeline_get_tracks (timeline);
+  for (tmp = tracks; tmp; tmp = tmp->next) {
+    if (GES_TRACK (tmp->data)->type & segment->skipped_tracks)
+      ges_timeline_remove_track (timeline, tmp->data);
+  }
+  g_list_free_full (tracks, gst_object_unref);
+
+  /* Clips get moved one by one, not along with their groups */
+  groups = g_list_copy (ges_timeline_get_groups (timeline));
+  g_list_foreach (groups, (GFunc) gst_object_ref, NULL);
+  for (tmp = groups; tmp; tmp = tmp->next)
+    g_list_free_full (ges_container_ungroup (tmp->data, FALSE),
+        gst_object_unref);
+  g_list_free_full (groups, gst_object_unref);
+
+  g_object_set (timeline, "snapping-distance", (guint64) 0, NULL);
+
+  layers = ges_timeline_get_layers (timeline);
+  for (ltmp = layers; ltmp; ltmp = ltmp->next) {
+    /* Sorted by start, so that moving them all back keeps them in place
+     * relative to each other at any time */
+    clips = ges_layer_get_clips (ltmp->data);
+    for (tmp = clips; tmp; tmp = tmp->next) {
+      GESTimelineElement *clip = tmp->data;
+      GstClockTime start = GES_TIMELINE_ELEMENT_START (clip);
+      GstClockTime end = start + GES_TIMELINE_ELEMENT_DURATION (clip);
+
+      /* Auto transitions follow the clips around them, the other ones are
+       * restricted as any clip */
+      if (GES_IS_TRANSITION_CLIP (clip) &&
+          ges_layer_get_auto_transition (ltmp->data))
+        continue;
+
+      if (end <= segment->start || start >= segment->stop) {
+        ges_layer_remove_clip (ltmp->data, GES_CLIP (clip));
+        continue;
+      }
+
+      if (start < segment->start)
+        ges_timeline_element_trim (clip, segment->start);
+      if (end > segment->stop)
+        ges_timeline_element_set_duration (clip, segment->stop -
+            GES_TIMELINE_ELEMENT_START (clip));
+      ges_timeline_element_set_start (clip, GES_TIMELINE_ELEMENT_START (clip)
+          - segment->start);
+    }
+    g_list_free_full (clips, gst_object_unref);
+  }
+  g_list_free_full (layers, gst_object_unref);
+
+  ges_timeline_commit (timeline);
+}
+
+static void
+_project_loaded_cb (GESProject * project, GESTimeline * timeline,
+    SegmentedRender * render)
+{
+  guint i;
+  GstBus *bus;
+  Segment *segment = NULL;
+
+  for (i = 0; i < render->next_segment; i++) {
+    Segment *job = _get_job (render, i);
+
+    if (job->timeline == timeline && !job->pipeline)
+      segment = job;
+  }
+
+  if (!segment)
+    return;
+
+  _restrict_timeline_to_segment (segment);
+
+  segment->pipeline = ges_pipeline_new ();
+  if (!ges_pipeline_set_timeline (segment->pipeline, timeline) ||
+      !ges_pipeline_set_render_settings (segment->pipeline, segment->uri,
+          segment->profile) ||
+      !ges_pipeline_set_mode (segment->pipeline, GES_PIPELINE_MODE_RENDER)) {
+    g_printerr ("Could not set up the pipeline of segment %u\n",
+        segment->index);
+    _finish (render, FALSE);
+
+    return;
+  }
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (segment->pipeline));
+  segment->bus_watch_id =
+      gst_bus_add_watch (bus, (GstBusFunc) _segment_bus_cb, segment);
+  gst_object_unref (bus);
+
+  if (gst_element_set_state (GST_ELEMENT (segment->pipeline),
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+    g_printerr ("Could not start the pipeline of segment %u\n",
+        segment->index);
+    _finish (render, FALSE);
+  }
+}
+
+static void
+_error_loading_asset_cb (GESProject * project, GError * error,
+    const gchar * failed_id, GType extractable_type, SegmentedRender * render)
+{
+  g_printerr ("Error loading asset %s: %s\n", failed_id, error->message);
+
+  _finish (render, FALSE);
+}
+
+/* Returns %FALSE if @render has been finished */
+static gboolean
+_start_segments (SegmentedRender * render)
+{
+  while (render->n_running < render->max_running &&
+      render->next_segment < render->n_jobs) {
+    GError *error = NULL;
+    Segment *segment = _get_job (render, render->next_segment);
+
+    if (segment == render->audio)
+      g_print ("Rendering the audio\n");
+    else
+      g_print ("Rendering segment %u/%u (%" GST_TIME_FORMAT " - %"
+          GST_TIME_FORMAT ")\n", segment->index + 1, render->n_segments,
+          GST_TIME_ARGS (segment->start), GST_TIME_ARGS (segment->stop));
+
+    /* The timeline is ready once the project emits 'loaded' */
+    segment->timeline =
+        GES_TIMELINE (ges_asset_extract (GES_ASSET (render->project), &error));
+    if (!segment->timeline) {
+      g_printerr ("Could not copy the timeline: %s\n", error->message);
+      g_clear_error (&error);
+      _finish (render, FALSE);
+
+      return FALSE;
+    }
+
+    gst_object_ref_sink (segment->timeline);
+    render->next_segment++;
+    render->n_running++;
+  }
+
+  return TRUE;
+}
+
+/* Segments are cut on frame boundaries so that no frame gets split between
+ * two of them */
+static GstClockTime
+_snap_to_frame (GESTimeline * timeline, GstClockTime position)
+{
+  GList *tmp, *tracks = ges_timeline_get_tracks (timeline);
+  gint fps_n = 0, fps_d = 1;
+
+  for (tmp = tracks; tmp; tmp = tmp->next) {
+    GstCaps *restriction_caps = NULL;
+
+    if (!GES_IS_VIDEO_TRACK (tmp->data))
+      continue;
+
+    g_object_get (tmp->data, "restriction-caps", &restriction_caps, NULL);
+    if (restriction_caps && !gst_caps_is_empty (restriction_caps))
+      gst_structure_get_fraction (gst_caps_get_structure (restriction_caps, 0),
+          "framerate", &fps_n, &fps_d);
+    if (restriction_caps)
+      gst_caps_unref (restriction_caps);
+  }
+  g_list_free_full (tracks, gst_object_unref);
+
+  if (fps_n <= 0 || fps_d <= 0)
+    return position;
+
+  return gst_util_uint64_scale (gst_util_uint64_scale (position, fps_n,
+          fps_d * GST_SECOND), fps_d * GST_SECOND, fps_n);
+}
+
+/* Copy of the container @profile only keeping its streams of @type, %NULL
+ * if it has none */
+static GstEncodingProfile *
+_filter_profile (GstEncodingProfile * profile, GType type)
+{
+  const GList *tmp;
+  GstCaps *format;
+  GstEncodingContainerProfile *filtered = NULL;
+
+  if (!GST_IS_ENCODING_CONTAINER_PROFILE (profile))
+    return NULL;
+
+  for (tmp = gst_encoding_container_profile_get_profiles
+      (GST_ENCODING_CONTAINER_PROFILE (profile)); tmp; tmp = tmp->next) {
+    if (!G_TYPE_CHECK_INSTANCE_TYPE (tmp->data, type))
+      continue;
+
+    if (!filtered) {
+      format = gst_encoding_profile_get_format (profile);
+      filtered =
+          gst_encoding_container_profile_new (gst_encoding_profile_get_name
+          (profile), gst_encoding_profile_get_description (profile), format,
+          gst_encoding_profile_get_preset (profile));
+      gst_caps_unref (format);
+    }
+
+    gst_encoding_container_profile_add_profile (filtered,
+        gst_encoding_profile_ref (tmp->data));
+  }
+
+  return (GstEncodingProfile *) filtered;
+}
+
+static gboolean
+_has_track_of_type (GESTimeline * timeline, GESTrackType type)
+{
+  GList *tmp, *tracks = ges_timeline_get_tracks (timeline);
+  gboolean res = FALSE;
+
+  for (tmp = tracks; tmp; tmp = tmp->next)
+    res |= GES_TRACK (tmp->data)->type == type;
+  g_list_free_full (tracks, gst_object_unref);
+
+  return res;
+}
+
+static gchar *
+_get_extension (const gchar * uri)
+{
+  gchar *extension, *basename = g_path_get_basename (uri);
+  const gchar *dot = strrchr (basename, '.');
+
+  extension = g_strdup (dot ? dot : "");
+  g_free (basename);
+
+  return extension;
+}
+
+/**
+ * ges_render_segments:
+ * @timeline: The #GESTimeline to render
+ * @profile: The #GstEncodingProfile to render @timeline with
+ * @outputuri: The URI to render @timeline to
+ * @n_segments: The number of segments to split @timeline in
+ * @done: The function to call once the rendering is over
+ * @user_data: The data to pass to @done
+ *
+ * Renders @timeline to @outputuri, in @n_segments rendered in parallel
+ * before being concatenated. @done is called from the main loop once done.
+ *
+ * Returns: %FALSE if the rendering could not be started, %TRUE otherwise
+ */
+gboolean
+ges_render_segments (GESTimeline * timeline, GstEncodingProfile * profile,
+    const gchar * outputuri, guint n_segments, GESRenderSegmentsDoneFunc done,
+    gpointer user_data)
+{
+  guint i;
+  gchar *extension, *project_uri, *basename;
+  GstClockTime start = 0;
+  GError *error = NULL;
+  SegmentedRender *render;
+  GstEncodingProfile *audio_profile = NULL, *video_profile = NULL;
+  GstClockTime duration = ges_timeline_get_duration (timeline);
+
+  g_return_val_if_fail (n_segments > 0, FALSE);
+
+  if (!GST_CLOCK_TIME_IS_VALID (duration) || duration == 0) {
+    g_printerr ("Can not render an empty timeline\n");
+
+    return FALSE;
+  }
+
+  render = g_new0 (SegmentedRender, 1);
+  render->tmpdir = g_dir_make_tmp ("ges-render-XXXXXX", &error);
+  if (!render->tmpdir) {
+    g_printerr ("Could not create a temporary directory: %s\n",
+        error->message);
+    g_clear_error (&error);
+    g_free (render);
+
+    return FALSE;
+  }
+
+  /* The formatter round trip gives every segment a timeline of its own */
+  render->project_filename =
+      g_build_filename (render->tmpdir, "timeline.xges", NULL);
+  project_uri = gst_filename_to_uri (render->project_filename, NULL);
+  if (!ges_timeline_save_to_uri (timeline, project_uri, NULL, TRUE, &error)) {
+    g_printerr ("Could not save the timeline: %s\n",
+        error ? error->message : "unknown error");
+    g_clear_error (&error);
+    g_free (project_uri);
+    g_rmdir (render->tmpdir);
+    g_free (render->tmpdir);
+    g_free (render->project_filename);
+    g_free (render);
+
+    return FALSE;
+  }
+
+  render->timeline = gst_object_ref (timeline);
+  render->profile = gst_encoding_profile_ref (profile);
+  render->outputuri = g_strdup (outputuri);
+  render->done = done;
+  render->user_data = user_data;
+
+  /* Avoid the gaps at the boundaries of audio segments */
+  if (_has_track_of_type (timeline, GES_TRACK_TYPE_AUDIO) &&
+      _has_track_of_type (timeline, GES_TRACK_TYPE_VIDEO)) {
+    audio_profile = _filter_profile (profile, GST_TYPE_ENCODING_AUDIO_PROFILE);
+    video_profile = _filter_profile (profile, GST_TYPE_ENCODING_VIDEO_PROFILE);
+    if (!audio_profile || !video_profile) {
+      g_clear_object (&audio_profile);
+      g_clear_object (&video_profile);
+    }
+  }
+
+  render->segments = g_new0 (Segment, n_segments + 1);
+  extension = _get_extension (outputuri);
+  for (i = 1; i <= n_segments; i++) {
+    Segment *segment;
+    GstClockTime stop = i == n_segments ? duration :
+        _snap_to_frame (timeline, gst_util_uint64_scale (duration, i,
+            n_segments));
+
+    if (stop <= start)
+      continue;
+
+    segment = &render->segments[render->n_segments];
+    segment->render = render;
+    segment->index = render->n_segments++;
+    segment->start = start;
+    segment->stop = stop;
+    if (video_profile) {
+      segment->skipped_tracks = GES_TRACK_TYPE_AUDIO;
+      segment->profile = gst_encoding_profile_ref (video_profile);
+    } else {
+      segment->profile = gst_encoding_profile_ref (profile);
+    }
+
+    basename = g_strdup_printf ("segment-%03u%s", segment->index, extension);
+    segment->filename = g_build_filename (render->tmpdir, basename, NULL);
+    segment->uri = gst_filename_to_uri (segment->filename, NULL);
+    g_free (basename);
+
+    start = stop;
+  }
+  render->n_jobs = render->n_segments;
+
+  if (audio_profile) {
+    render->audio = &render->segments[render->n_jobs++];
+    render->audio->render = render;
+    render->audio->index = render->n_segments;
+    render->audio->start = 0;
+    render->audio->stop = duration;
+    render->audio->skipped_tracks = GES_TRACK_TYPE_VIDEO;
+    render->audio->profile = audio_profile;
+
+    basename = g_strdup_printf ("audio%s", extension);
+    render->audio->filename =
+        g_build_filename (render->tmpdir, basename, NULL);
+    render->audio->uri = gst_filename_to_uri (render->audio->filename, NULL);
+    g_free (basename);
+  }
+  g_clear_object (&video_profile);
+  g_free (extension);
+
+  render->max_running = MIN (g_get_num_processors (), render->n_jobs);
+  render->project = ges_project_new (project_uri);
+  g_free (project_uri);
+
+  g_signal_connect (render->project, "loaded",
+      G_CALLBACK (_project_loaded_cb), render);
+  g_signal_connect (render->project, "error-loading-asset",
+      G_CALLBACK (_error_loading_asset_cb), render);
+
+  _start_segments (render);
+
+  return TRUE;
+}
@@ -0,0 +1,34 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef _GES_RENDER_SEGMENTS_
+#define _GES_RENDER_SEGMENTS_
+
+#include <ges/ges.h>
+#include <gst/pbutils/encoding-profile.h>
+
+G_BEGIN_DECLS
+
+typedef void (*GESRenderSegmentsDoneFunc) (gboolean success, gpointer user_data);
+
+gboolean ges_render_segments (GESTimeline *timeline, GstEncodingProfile *profile,
+    const gchar *outputuri, guint n_segments, GESRenderSegmentsDoneFunc done,
+    gpointer user_data);
+
+G_END_DECLS
+
+#endif  /* _GES_RENDER_SEGMENTS_ */